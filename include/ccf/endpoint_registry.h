@@ -6,24 +6,27 @@
 #include "ccf/endpoint_context.h"
 #include "ccf/tx.h"
 #include "ds/ccf_deprecated.h"
+#include "ds/histogram.h"
 #include "ds/json_schema.h"
 #include "ds/openapi.h"
+#include "ds/thread_messaging.h"
+#include "endpoints/path_router.h"
 #include "http/http_consts.h"
 #include "node/certs.h"
 #include "node/rpc/serialization.h"
 
+#include <array>
 #include <charconv>
+#include <chrono>
 #include <functional>
 #include <llhttp/llhttp.h>
 #include <nlohmann/json.hpp>
-#include <regex>
 #include <set>
 
 namespace ccf::endpoints
 {
   struct PathTemplateSpec
   {
-    std::regex template_regex;
     std::vector<std::string> template_component_names;
   };
 
@@ -37,37 +40,25 @@ namespace ccf::endpoints
   inline std::optional<PathTemplateSpec> parse_path_template(
     const std::string& uri)
   {
-    auto template_start = uri.find_first_of('{');
-    if (template_start == std::string::npos)
+    if (uri.find_first_of('{') == std::string::npos)
     {
       return std::nullopt;
     }
 
     PathTemplateSpec spec;
 
-    std::string regex_s = uri;
-    template_start = regex_s.find_first_of('{');
-    while (template_start != std::string::npos)
+    for (auto& segment : parse_path_template_segments(uri))
     {
-      const auto template_end = regex_s.find_first_of('}', template_start);
-      if (template_end == std::string::npos)
+      for (auto& name : segment.names)
       {
-        throw std::logic_error(
-          fmt::format("Invalid templated path - missing closing '}': {}", uri));
+        spec.template_component_names.push_back(std::move(name));
       }
-
-      spec.template_component_names.push_back(
-        regex_s.substr(template_start + 1, template_end - template_start - 1));
-      regex_s.replace(
-        template_start, template_end - template_start + 1, "([^/]+)");
-      template_start = regex_s.find_first_of('{', template_start + 1);
     }
 
-    LOG_TRACE_FMT("Parsed a templated endpoint: {} became {}", uri, regex_s);
     LOG_TRACE_FMT(
-      "Component names are: {}",
+      "Parsed a templated endpoint: {}, component names are: {}",
+      uri,
       fmt::join(spec.template_component_names, ", "));
-    spec.template_regex = std::regex(regex_s);
 
     return spec;
   }
@@ -98,14 +89,44 @@ namespace ccf::endpoints
       std::string document_version = "0.0.1";
     } openapi_info;
 
+    // Durations in microseconds, up to ~1s
+    using LatencyHistogram = histogram::Histogram<size_t, 1, 1 << 20>;
+    // Retries of a single call, up to the maximum number of attempts
+    using RetriesHistogram = histogram::Histogram<size_t, 1, 1 << 5>;
+
     struct Metrics
     {
       size_t calls = 0;
       size_t errors = 0;
       size_t failures = 0;
       size_t retries = 0;
+      // Total time spent preparing the execution of the endpoint (e.g. setting
+      // up an interpreter), for endpoints which report it
+      std::chrono::microseconds setup_time{0};
+
+      // Distributions of the time spent executing the endpoint and committing
+      // its transaction, for each attempt, and of the number of retries of
+      // each call
+      LatencyHistogram execution_time;
+      LatencyHistogram commit_time;
+      RetriesHistogram retries_per_call;
+
+      void add(Metrics& that)
+      {
+        calls += that.calls;
+        errors += that.errors;
+        failures += that.failures;
+        retries += that.retries;
+        setup_time += that.setup_time;
+        execution_time.add(that.execution_time);
+        commit_time.add(that.commit_time);
+        retries_per_call.add(that.retries_per_call);
+      }
     };
 
+    using MetricsByEndpoint =
+      std::map<std::string, std::map<std::string, Metrics>>;
+
     template <typename T>
     bool get_path_param(
       const enclave::PathParams& params,
@@ -159,12 +180,32 @@ namespace ccf::endpoints
       std::string,
       std::map<RESTVerb, std::shared_ptr<PathTemplatedEndpoint>>>
       templated_endpoints;
+    // Matches request paths against templated_endpoints, for each verb
+    std::map<RESTVerb, PathRouter<std::shared_ptr<PathTemplatedEndpoint>>>
+      templated_endpoints_router;
+
+    // Metrics are sharded by thread, so that each shard is only written to by
+    // a single thread and its lock is only contended while metrics are read.
+    // Shards are merged by get_metrics().
+    struct MetricsShard
+    {
+      std::mutex lock;
+      MetricsByEndpoint metrics;
+    };
+    std::array<MetricsShard, threading::ThreadMessaging::max_num_threads>
+      metrics_shards;
 
-    std::mutex metrics_lock;
-    std::map<std::string, std::map<std::string, Metrics>> metrics;
+    template <typename F>
+    void update_metrics_for_endpoint(const EndpointDefinitionPtr& e, F&& f)
+    {
+      auto method = e->dispatch.uri_path;
+      method = method.substr(method.find_first_not_of('/'));
 
-    EndpointRegistry::Metrics& get_metrics_for_endpoint(
-      const EndpointDefinitionPtr& e);
+      auto& shard = metrics_shards
+        [threading::get_current_thread_id() % metrics_shards.size()];
+      std::lock_guard<std::mutex> guard(shard.lock);
+      f(shard.metrics[method][e->dispatch.verb.c_str()]);
+    }
 
     kv::Consensus* consensus = nullptr;
     kv::TxHistory* history = nullptr;
@@ -265,5 +306,18 @@ namespace ccf::endpoints
     void increment_metrics_errors(const EndpointDefinitionPtr& e);
     void increment_metrics_failures(const EndpointDefinitionPtr& e);
     void increment_metrics_retries(const EndpointDefinitionPtr& e);
+    void add_metrics_setup_time(
+      const EndpointDefinitionPtr& e, std::chrono::microseconds setup_time);
+    void record_metrics_execution_time(
+      const EndpointDefinitionPtr& e, std::chrono::microseconds execution_time);
+    void record_metrics_commit_time(
+      const EndpointDefinitionPtr& e, std::chrono::microseconds commit_time);
+    void record_metrics_retries_per_call(
+      const EndpointDefinitionPtr& e, size_t retries);
+
+    /** Get the metrics of each endpoint, by path and verb, merged across all
+     * threads
+     */
+    MetricsByEndpoint get_metrics();
   };
 }
\ No newline at end of file
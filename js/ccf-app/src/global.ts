@@ -45,6 +45,20 @@ export interface KvMap {
   forEach(
     callback: (value: ArrayBuffer, key: ArrayBuffer, kvmap: KvMap) => void
   ): void;
+  /**
+   * Call `callback` with the values and keys of successive chunks of
+   * at most `chunkSize` entries (100 by default). This is cheaper than
+   * `forEach` when scanning large maps, as the callback is called once
+   * per chunk rather than once per entry.
+   */
+  forEachChunk(
+    callback: (
+      values: ArrayBuffer[],
+      keys: ArrayBuffer[],
+      kvmap: KvMap
+    ) => void,
+    chunkSize?: number
+  ): void;
   size: number;
 }
 
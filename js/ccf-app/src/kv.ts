@@ -71,6 +71,24 @@ export class TypedKvMap<K, V> {
     });
   }
 
+  forEachChunk(
+    callback: (values: V[], keys: K[], table: TypedKvMap<K, V>) => void,
+    chunkSize?: number
+  ): void {
+    const kt = this.kt;
+    const vt = this.vt;
+    this.kv.forEachChunk(
+      (raw_values: ArrayBuffer[], raw_keys: ArrayBuffer[]) => {
+        callback(
+          raw_values.map((v) => vt.decode(v)),
+          raw_keys.map((k) => kt.decode(k)),
+          this
+        );
+      },
+      chunkSize
+    );
+  }
+
   get size(): number {
     return this.kv.size;
   }
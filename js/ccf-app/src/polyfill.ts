@@ -63,6 +63,32 @@ class KvMapPolyfill implements KvMap {
       callback(value, unbase64(key), this);
     });
   }
+  forEachChunk(
+    callback: (
+      values: ArrayBuffer[],
+      keys: ArrayBuffer[],
+      kvmap: KvMap
+    ) => void,
+    chunkSize: number = 100
+  ): void {
+    if (!(chunkSize > 0)) {
+      throw new RangeError("Chunk size must be positive");
+    }
+    let values: ArrayBuffer[] = [];
+    let keys: ArrayBuffer[] = [];
+    for (const [key, value] of this.map) {
+      values.push(value);
+      keys.push(unbase64(key));
+      if (keys.length == chunkSize) {
+        callback(values, keys, this);
+        values = [];
+        keys = [];
+      }
+    }
+    if (keys.length > 0) {
+      callback(values, keys, this);
+    }
+  }
   get size(): number {
     return this.map.size;
   }
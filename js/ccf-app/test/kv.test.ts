@@ -58,4 +58,21 @@ describe("typedKv", function () {
     foo.clear();
     assert.equal(foo.size, 0);
   });
+
+  it("forEachChunk", function () {
+    for (let i = 0; i < 5; i++) {
+      foo.set(`key${i}`, i);
+    }
+    const chunkSizes: number[] = [];
+    const found = new Map<string, number>();
+    foo.forEachChunk((values, keys) => {
+      assert.equal(values.length, keys.length);
+      chunkSizes.push(keys.length);
+      keys.forEach((k, i) => found.set(k, values[i]));
+    }, 2);
+    assert.deepEqual(chunkSizes, [2, 2, 1]);
+    for (let i = 0; i < 5; i++) {
+      assert.equal(found.get(`key${i}`), i);
+    }
+  });
 });
@@ -26,11 +26,13 @@ GCM_SIZE_TAG = 16
 GCM_SIZE_IV = 12
 LEDGER_DOMAIN_SIZE = 8
 LEDGER_HEADER_SIZE = 8
+LEDGER_PREALLOCATED_FILE_PREFIX = "preallocated"
 
 # Public table names as defined in CCF
 # https://github.com/microsoft/CCF/blob/main/src/node/entities.h
 SIGNATURE_TX_TABLE_NAME = "public:ccf.internal.signatures"
 NODES_TABLE_NAME = "public:ccf.gov.nodes.info"
+SNAPSHOT_DELTA_BASE_TABLE_NAME = "public:ccf.internal.snapshot_delta_base"
 
 # Key used by CCF to record single-key tables
 WELL_KNOWN_SINGLETON_TABLE_KEY = bytes(bytearray(8))
@@ -100,15 +102,17 @@ class PublicDomain:
     _version: int
     _max_conflict_version: int
     _tables: dict
+    _delta_base: Optional[Tuple[int, str]] = None
 
-    def __init__(self, buffer: io.BytesIO):
+    def __init__(self, buffer: io.BytesIO, has_snapshot_header: bool = True):
         self._buffer = buffer
         self._buffer_size = self._buffer.getbuffer().nbytes
         self._is_snapshot = self._read_is_snapshot()
         self._version = self._read_version()
         self._max_conflict_version = self._read_version()
 
-        if self._is_snapshot:
+        # Only the first chunk of a snapshot starts with the snapshot header
+        if self._is_snapshot and has_snapshot_header:
             self._read_snapshot_header()
 
         self._tables = {}
@@ -170,8 +174,14 @@ class PublicDomain:
             except EOFError:
                 break
 
-            records = {}
-            self._tables[map_name] = records
+            if self._is_snapshot and map_name == SNAPSHOT_DELTA_BASE_TABLE_NAME:
+                # seqno and digest of the snapshot a delta snapshot is against
+                base_version = self._read_version()
+                self._delta_base = (base_version, self._read_next_entry().hex())
+                continue
+
+            # A map may be split in several segments in a snapshot
+            records = self._tables.setdefault(map_name, {})
 
             if self._is_snapshot:
                 # map snapshot version
@@ -221,6 +231,16 @@ class PublicDomain:
         """
         return self._version
 
+    def get_delta_base(self) -> Optional[Tuple[int, str]]:
+        """
+        Return the sequence number and hex digest of the snapshot a delta snapshot is against, or None for a full snapshot or a transaction.
+        """
+        return self._delta_base
+
+    def _merge(self, other: "PublicDomain"):
+        for map_name, records in other._tables.items():
+            self._tables.setdefault(map_name, {}).update(records)
+
 
 def _byte_read_safe(file, num_of_bytes):
     offset = file.tell()
@@ -581,15 +601,63 @@ class Transaction(Entry):
 class Snapshot(Entry):
     """
     Utility used to parse the content of a snapshot file.
+
+    A snapshot file is a sequence of chunks, each of which is serialised as a ledger entry whose private domain is encrypted on its own. The public domains of all chunks are merged into a single :py:class:`ccf.ledger.PublicDomain`.
     """
 
     _filename: str
+    # Offset and size of the public domain of each chunk
+    _chunks: List[Tuple[int, int]]
+    _private_domain_size: int = 0
 
     def __init__(self, filename: str):
         super().__init__(filename)
         self._filename = filename
         self._file_size = os.path.getsize(filename)
-        super()._read_header()
+        self._chunks = []
+
+        while self._file.tell() < self._file_size:
+            super()._read_header()
+            self._chunks.append((self._file.tell(), self._public_domain_size))
+            self._private_domain_size += super().get_private_domain_size()
+            # Skip to the next chunk
+            self._file.seek(
+                self._header.size - GcmHeader.size() - LEDGER_DOMAIN_SIZE,
+                os.SEEK_CUR,
+            )
+
+        if not self._chunks:
+            raise ValueError(f"Snapshot file {filename} is empty")
+
+    def get_public_domain(self) -> PublicDomain:
+        """
+        Retrieve the public (i.e. non-encrypted) domain of the snapshot, merged from all its chunks.
+
+        :return: :py:class:`ccf.ledger.PublicDomain`
+        """
+        if self._public_domain is None:
+            for offset, size in self._chunks:
+                self._file.seek(offset)
+                buffer = io.BytesIO(_byte_read_safe(self._file, size))
+                if self._public_domain is None:
+                    self._public_domain = PublicDomain(buffer)
+                else:
+                    self._public_domain._merge(
+                        PublicDomain(buffer, has_snapshot_header=False)
+                    )
+        return self._public_domain
+
+    def get_private_domain_size(self) -> int:
+        """
+        Retrieve the total size of the private (i.e. encrypted) domains of the snapshot chunks.
+        """
+        return self._private_domain_size
+
+    def get_chunk_count(self) -> int:
+        """
+        Return the number of chunks the snapshot is made of.
+        """
+        return len(self._chunks)
 
     def commit_seqno(self):
         try:
@@ -670,6 +738,12 @@ class Ledger:
             for path in os.listdir(directory):
                 if committed_only and not path.endswith(".committed"):
                     continue
+                # Index files written alongside ledger chunks, and files
+                # allocated ahead of time for future chunks, are skipped
+                if path.endswith(".index") or path.startswith(
+                    LEDGER_PREALLOCATED_FILE_PREFIX
+                ):
+                    continue
                 chunk = os.path.join(directory, path)
                 if os.path.isfile(chunk):
                     ledger_files.append(chunk)
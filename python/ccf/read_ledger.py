@@ -108,8 +108,11 @@ if __name__ == "__main__":
         snapshot_file = args.paths[0]
         with ccf.ledger.Snapshot(snapshot_file) as snapshot:
             LOG.info(
-                f"Reading snapshot from {snapshot_file} ({'' if snapshot.commit_seqno() else 'un'}committed)"
+                f"Reading snapshot from {snapshot_file} ({'' if snapshot.commit_seqno() else 'un'}committed, {counted_string(range(snapshot.get_chunk_count()), 'chunk')})"
             )
+            delta_base = snapshot.get_public_domain().get_delta_base()
+            if delta_base is not None:
+                LOG.info(f"Delta against snapshot at seqno {delta_base[0]}")
             dump_entry(snapshot, table_filter)
     else:
         ledger_dirs = args.paths
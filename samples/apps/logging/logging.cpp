@@ -1190,7 +1190,7 @@ namespace loggingapp
         "This CCF sample app implements a simple logging application, securely "
         "recording messages at client-specified IDs. It demonstrates most of "
         "the features available to CCF apps.";
-      logger_handlers.openapi_info.document_version = "0.1.0";
+      logger_handlers.openapi_info.document_version = "0.1.2";
     }
   };
 }
@@ -8,11 +8,18 @@
 #include "crypto/entropy.h"
 #include "crypto/key_wrap.h"
 #include "crypto/rsa_key_pair.h"
+#include "ds/thread_messaging.h"
+#include "endpoints/path_router.h"
+#include "js/interpreter.h"
 #include "js/wrap.h"
 #include "kv/untyped_map.h"
 #include "named_auth_policies.h"
 
+#include <array>
+#include <chrono>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <quickjs/quickjs-exports.h>
 #include <quickjs/quickjs.h>
 #include <stdexcept>
@@ -34,6 +41,74 @@ namespace ccfapp
     ccfapp::AbstractNodeContext& context;
     metrics::Tracker metrics_tracker;
 
+    // Interpreters are reused across requests executed on the same thread
+    std::array<
+      std::unique_ptr<js::Interpreter>,
+      threading::ThreadMessaging::max_num_threads>
+      interpreters;
+
+    // Binds the interpreter of the current thread to a request, for as long as
+    // it is executed. The interpreter is discarded if an exception unwinds
+    // through it, or if the execution is marked as failed, so that a new one
+    // is created for the next request.
+    class BoundInterpreter
+    {
+    private:
+      std::unique_ptr<js::Interpreter>& interpreter;
+      const int uncaught_exceptions = std::uncaught_exceptions();
+      bool failed = false;
+
+    public:
+      BoundInterpreter(
+        std::unique_ptr<js::Interpreter>& interpreter,
+        kv::Tx& tx,
+        kv::Tx& target_tx,
+        enclave::RpcContext* rpc_ctx,
+        const std::optional<ccf::TxID>& transaction_id,
+        ccf::historical::TxReceiptPtr receipt,
+        ccf::AbstractNodeState* host_node_state) :
+        interpreter(interpreter)
+      {
+        if (interpreter != nullptr && !interpreter->are_modules_current(tx))
+        {
+          interpreter = nullptr;
+        }
+        if (interpreter == nullptr)
+        {
+          interpreter = std::make_unique<js::Interpreter>();
+        }
+        interpreter->bind_request(
+          tx, target_tx, rpc_ctx, transaction_id, receipt, host_node_state);
+      }
+
+      ~BoundInterpreter()
+      {
+        if (failed || std::uncaught_exceptions() > uncaught_exceptions)
+        {
+          interpreter = nullptr;
+        }
+        else
+        {
+          interpreter->unbind_request();
+        }
+      }
+
+      void set_failed()
+      {
+        failed = true;
+      }
+
+      js::Interpreter& operator*()
+      {
+        return *interpreter;
+      }
+
+      js::Interpreter* operator->()
+      {
+        return interpreter.get();
+      }
+    };
+
     static JSValue create_json_obj(const nlohmann::json& j, JSContext* ctx)
     {
       const auto buf = j.dump();
@@ -221,6 +296,7 @@ namespace ccfapp
     }
 
     void execute_request(
+      const ccf::endpoints::EndpointDefinitionPtr& endpoint,
       const ccf::endpoints::EndpointProperties& props,
       ccf::endpoints::EndpointContext& endpoint_ctx)
     {
@@ -233,13 +309,14 @@ namespace ccfapp
           };
 
         ccf::historical::adapter(
-          [this, &props](
+          [this, &endpoint, &props](
             ccf::endpoints::EndpointContext& endpoint_ctx,
             ccf::historical::StatePtr state) {
             auto tx = state->store->create_tx();
             auto tx_id = state->transaction_id;
             auto receipt = state->receipt;
-            do_execute_request(props, endpoint_ctx, tx, tx_id, receipt);
+            do_execute_request(
+              endpoint, props, endpoint_ctx, tx, tx_id, receipt);
           },
           context.get_historical_state(),
           is_tx_committed)(endpoint_ctx);
@@ -247,49 +324,44 @@ namespace ccfapp
       else
       {
         do_execute_request(
-          props, endpoint_ctx, endpoint_ctx.tx, std::nullopt, nullptr);
+          endpoint,
+          props,
+          endpoint_ctx,
+          endpoint_ctx.tx,
+          std::nullopt,
+          nullptr);
       }
     }
 
     void do_execute_request(
+      const ccf::endpoints::EndpointDefinitionPtr& endpoint,
       const ccf::endpoints::EndpointProperties& props,
       ccf::endpoints::EndpointContext& endpoint_ctx,
       kv::Tx& target_tx,
       const std::optional<ccf::TxID>& transaction_id,
       ccf::historical::TxReceiptPtr receipt)
     {
-      js::Runtime rt;
-      rt.add_ccf_classdefs();
+      const auto setup_start = std::chrono::steady_clock::now();
 
-      JS_SetModuleLoaderFunc(
-        rt, nullptr, js::js_app_module_loader, &endpoint_ctx.tx);
-
-      js::Context ctx(rt);
-      js::TxContext txctx{&target_tx, js::TxAccess::APP};
-
-      js::register_request_body_class(ctx);
-      js::populate_global_console(ctx);
-      js::populate_global_ccf(
-        &txctx,
+      BoundInterpreter interpreter(
+        interpreters.at(threading::get_current_thread_id()),
+        endpoint_ctx.tx,
+        target_tx,
         endpoint_ctx.rpc_ctx.get(),
         transaction_id,
         receipt,
-        nullptr,
-        &context.get_node_state(),
-        nullptr,
-        ctx);
-      js::populate_global_openenclave(ctx);
+        &context.get_node_state());
+      auto& ctx = interpreter->get_context();
 
       JSValue export_func;
       try
       {
-        auto module_val =
-          js::load_app_module(ctx, props.js_module.c_str(), &endpoint_ctx.tx);
-        export_func =
-          ctx.function(module_val, props.js_function, props.js_module);
+        export_func = interpreter->get_exported_function(
+          props.js_module, props.js_function);
       }
       catch (const std::exception& exc)
       {
+        interpreter.set_failed();
         endpoint_ctx.rpc_ctx->set_error(
           HTTP_STATUS_INTERNAL_SERVER_ERROR,
           ccf::errors::InternalError,
@@ -297,8 +369,14 @@ namespace ccfapp
         return;
       }
 
-      // Call exported function
       auto request = create_request_obj(endpoint_ctx, ctx);
+
+      add_metrics_setup_time(
+        endpoint,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - setup_start));
+
+      // Call exported function
       int argc = 1;
       JSValueConst* argv = (JSValueConst*)&request;
       auto val = ctx(JS_Call(ctx, export_func, JS_UNDEFINED, argc, argv));
@@ -307,6 +385,9 @@ namespace ccfapp
 
       if (JS_IsException(val))
       {
+        // The interpreter is not reused after an uncaught exception (e.g. out
+        // of memory)
+        interpreter.set_failed();
         js::js_dump_error(ctx);
         endpoint_ctx.rpc_ctx->set_error(
           HTTP_STATUS_INTERNAL_SERVER_ERROR,
@@ -463,6 +544,97 @@ namespace ccfapp
     struct JSDynamicEndpoint : public ccf::endpoints::EndpointDefinition
     {};
 
+    struct RoutedEndpoint
+    {
+      std::shared_ptr<JSDynamicEndpoint> endpoint;
+      // Reported when the endpoint is requested, if it could not be
+      // instantiated
+      std::string error;
+
+      ccf::endpoints::EndpointDefinitionPtr get() const
+      {
+        if (endpoint == nullptr)
+        {
+          throw std::logic_error(error);
+        }
+        return endpoint;
+      }
+    };
+
+    // Routes requests to the endpoints of the ENDPOINTS table. A router is
+    // built for each state of the table, and shared by all threads for as long
+    // as the table is unchanged.
+    struct JSRouter
+    {
+      kv::MapStateVersion version;
+      std::map<ccf::endpoints::URI, std::map<RESTVerb, RoutedEndpoint>>
+        fully_qualified_endpoints;
+      std::map<RESTVerb, ccf::endpoints::PathRouter<RoutedEndpoint>>
+        templated_endpoints;
+      std::optional<std::string> template_error;
+    };
+
+    std::mutex router_lock;
+    std::shared_ptr<const JSRouter> router;
+
+    std::shared_ptr<const JSRouter> get_router(kv::Tx& tx)
+    {
+      auto endpoints =
+        tx.ro<ccf::endpoints::EndpointsMap>(ccf::Tables::ENDPOINTS);
+      const auto version = endpoints->get_state_version();
+
+      {
+        std::lock_guard<std::mutex> guard(router_lock);
+        if (router != nullptr && router->version == version)
+        {
+          return router;
+        }
+      }
+
+      auto new_router = std::make_shared<JSRouter>();
+      new_router->version = version;
+
+      endpoints->foreach([this, &new_router](
+                           const auto& key, const auto& properties) {
+        RoutedEndpoint routed;
+        auto endpoint = std::make_shared<JSDynamicEndpoint>();
+        endpoint->dispatch = key;
+        endpoint->properties = properties;
+        try
+        {
+          instantiate_authn_policies(*endpoint);
+          routed.endpoint = std::move(endpoint);
+        }
+        catch (const std::logic_error& e)
+        {
+          routed.error = e.what();
+        }
+
+        new_router->fully_qualified_endpoints[key.uri_path][key.verb] = routed;
+
+        if (key.uri_path.find_first_of('{') != std::string::npos)
+        {
+          try
+          {
+            new_router->templated_endpoints[key.verb].insert(
+              key.uri_path, std::move(routed));
+          }
+          catch (const std::logic_error& e)
+          {
+            if (!new_router->template_error.has_value())
+            {
+              new_router->template_error = e.what();
+            }
+          }
+        }
+        return true;
+      });
+
+      std::lock_guard<std::mutex> guard(router_lock);
+      router = new_router;
+      return new_router;
+    }
+
   public:
     JSHandlers(NetworkTables& network, AbstractNodeContext& context) :
       UserEndpointRegistry(context),
@@ -492,78 +664,49 @@ namespace ccfapp
       const auto method = rpc_ctx.get_method();
       const auto verb = rpc_ctx.get_request_verb();
 
-      auto endpoints =
-        tx.ro<ccf::endpoints::EndpointsMap>(ccf::Tables::ENDPOINTS);
-
-      const auto key = ccf::endpoints::EndpointKey{method, verb};
+      const auto js_router = get_router(tx);
 
       // Look for a direct match of the given path
-      const auto it = endpoints->get(key);
-      if (it.has_value())
+      const auto exact = js_router->fully_qualified_endpoints.find(method);
+      if (exact != js_router->fully_qualified_endpoints.end())
       {
-        auto endpoint_def = std::make_shared<JSDynamicEndpoint>();
-        endpoint_def->dispatch = key;
-        endpoint_def->properties = it.value();
-        instantiate_authn_policies(*endpoint_def);
-        return endpoint_def;
+        const auto it = exact->second.find(verb);
+        if (it != exact->second.end())
+        {
+          return it->second.get();
+        }
       }
 
-      // If that doesn't exist, look through _all_ the endpoints to find
-      // templated matches. If there is one, that's a match. More is an error,
-      // none means delegate to the base class.
+      // If that doesn't exist, look for templated matches. If there is one,
+      // that's a match. More is an error, none means delegate to the base
+      // class.
+      if (js_router->template_error.has_value())
       {
-        std::vector<ccf::endpoints::EndpointDefinitionPtr> matches;
-
-        endpoints->foreach([this, &matches, &key, &rpc_ctx](
-                             const auto& other_key, const auto& properties) {
-          if (key.verb == other_key.verb)
-          {
-            const auto opt_spec =
-              ccf::endpoints::parse_path_template(other_key.uri_path);
-            if (opt_spec.has_value())
-            {
-              const auto& template_spec = opt_spec.value();
-              // This endpoint has templates in its path, and the correct verb
-              // - now check if template matches the current request's path
-              std::smatch match;
-              if (std::regex_match(
-                    key.uri_path, match, template_spec.template_regex))
-              {
-                if (matches.empty())
-                {
-                  // Populate the request_path_params while we have the match,
-                  // though this will be discarded on error if we later find
-                  // multiple matches
-                  auto& path_params = rpc_ctx.get_request_path_params();
-                  for (size_t i = 0;
-                       i < template_spec.template_component_names.size();
-                       ++i)
-                  {
-                    const auto& template_name =
-                      template_spec.template_component_names[i];
-                    const auto& template_value = match[i + 1].str();
-                    path_params[template_name] = template_value;
-                  }
-                }
-
-                auto endpoint = std::make_shared<JSDynamicEndpoint>();
-                endpoint->dispatch = other_key;
-                endpoint->properties = properties;
-                instantiate_authn_policies(*endpoint);
-                matches.push_back(endpoint);
-              }
-            }
-          }
-          return true;
-        });
+        throw std::logic_error(js_router->template_error.value());
+      }
 
+      const auto templated = js_router->templated_endpoints.find(verb);
+      if (templated != js_router->templated_endpoints.end())
+      {
+        auto matches = templated->second.match(method);
         if (matches.size() > 1)
         {
-          report_ambiguous_templated_path(key.uri_path, matches);
+          std::vector<ccf::endpoints::EndpointDefinitionPtr> endpoints;
+          for (const auto& match : matches)
+          {
+            endpoints.push_back(match.value.get());
+          }
+          report_ambiguous_templated_path(method, endpoints);
         }
         else if (matches.size() == 1)
         {
-          return matches[0];
+          auto endpoint = matches[0].value.get();
+          auto& path_params = rpc_ctx.get_request_path_params();
+          for (auto& [name, value] : matches[0].params)
+          {
+            path_params[name] = std::move(value);
+          }
+          return endpoint;
         }
       }
 
@@ -577,7 +720,7 @@ namespace ccfapp
       auto endpoint = dynamic_cast<const JSDynamicEndpoint*>(e.get());
       if (endpoint != nullptr)
       {
-        execute_request(endpoint->properties, endpoint_ctx);
+        execute_request(e, endpoint->properties, endpoint_ctx);
         return;
       }
 
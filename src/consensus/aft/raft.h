@@ -718,7 +718,11 @@ namespace aft
         }
 
         state->last_idx = index;
-        ledger->put_entry(*data, globally_committable, force_ledger_chunk);
+        ledger->put_entry(
+          *data,
+          globally_committable,
+          force_ledger_chunk,
+          state->current_view);
         entry_size_not_limited += data->size();
         entry_count++;
 
@@ -1726,7 +1730,10 @@ namespace aft
         }
 
         ledger->put_entry(
-          ds->get_entry(), globally_committable, force_ledger_chunk);
+          ds->get_entry(),
+          globally_committable,
+          force_ledger_chunk,
+          ds->get_term());
 
         switch (apply_success)
         {
@@ -1839,7 +1846,10 @@ namespace aft
       }
 
       ledger->put_entry(
-        ds->get_entry(), globally_committable, force_ledger_chunk);
+        ds->get_entry(),
+        globally_committable,
+        force_ledger_chunk,
+        ds->get_term());
 
       switch (apply_result)
       {
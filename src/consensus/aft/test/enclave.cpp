@@ -25,8 +25,9 @@ TEST_CASE("Enclave put")
 
   bool globally_committable = false;
   bool force_ledger_chunk = false;
+  consensus::Term term = 2;
   const std::vector<uint8_t> tx = {'a', 'b', 'c'};
-  enclave.put_entry(tx, globally_committable, force_ledger_chunk);
+  enclave.put_entry(tx, globally_committable, force_ledger_chunk, term);
   size_t num_msgs = 0;
   eio.read_from_inside().read(
     -1, [&](ringbuffer::Message m, const uint8_t* data, size_t size) {
@@ -37,6 +38,7 @@ TEST_CASE("Enclave put")
           REQUIRE(num_msgs == 0);
           REQUIRE(serialized::read<bool>(data, size) == globally_committable);
           REQUIRE(serialized::read<bool>(data, size) == force_ledger_chunk);
+          REQUIRE(serialized::read<consensus::Term>(data, size) == term);
           auto entry = std::vector<uint8_t>(data, data + size);
           REQUIRE(entry == tx);
         }
@@ -75,6 +77,7 @@ TEST_CASE("Enclave record")
 
   bool globally_committable = false;
   bool force_ledger_chunk = false;
+  consensus::Term term = 2;
   const std::vector<uint8_t> entry = {'a', 'b', 'c'};
   kv::SerialisedEntryHeader entry_header;
 
@@ -84,7 +87,8 @@ TEST_CASE("Enclave record")
   serialized::write(tx_, size_, entry_header);
   serialized::write(tx_, size_, entry.data(), entry.size());
 
-  leader_ledger_enclave.put_entry(tx, globally_committable, force_ledger_chunk);
+  leader_ledger_enclave.put_entry(
+    tx, globally_committable, force_ledger_chunk, term);
   size_t num_msgs = 0;
   std::vector<uint8_t> record;
   eio_leader.read_from_inside().read(
@@ -96,6 +100,7 @@ TEST_CASE("Enclave record")
           REQUIRE(num_msgs == 0);
           REQUIRE(serialized::read<bool>(data, size) == globally_committable);
           REQUIRE(serialized::read<bool>(data, size) == force_ledger_chunk);
+          REQUIRE(serialized::read<consensus::Term>(data, size) == term);
           copy(data, data + size, back_inserter(record));
         }
         break;
@@ -109,7 +114,7 @@ TEST_CASE("Enclave record")
 
   num_msgs = 0;
   follower_ledger_enclave.put_entry(
-    record, globally_committable, force_ledger_chunk);
+    record, globally_committable, force_ledger_chunk, term);
   eio_follower.read_from_inside().read(
     -1, [&](ringbuffer::Message m, const uint8_t* data, size_t size) {
       switch (m)
@@ -119,6 +124,7 @@ TEST_CASE("Enclave record")
           REQUIRE(num_msgs == 0);
           REQUIRE(serialized::read<bool>(data, size) == globally_committable);
           REQUIRE(serialized::read<bool>(data, size) == force_ledger_chunk);
+          REQUIRE(serialized::read<consensus::Term>(data, size) == term);
           auto entry = std::vector<uint8_t>(data, data + size);
           REQUIRE(entry == tx);
         }
@@ -25,7 +25,8 @@ namespace aft
     void put_entry(
       const std::vector<uint8_t>& data,
       bool globally_committable,
-      bool force_chunk)
+      bool force_chunk,
+      Term term)
     {
 #ifdef STUB_LOG
       std::cout << "  Node" << _id << "->>Ledger" << _id
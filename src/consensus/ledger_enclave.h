@@ -29,13 +29,16 @@ namespace consensus
      * @param globally_committable True is entry is signature transaction
      * @param force_chunk Force new ledger chunk to be created after this entry
      * (only if globally_committable)
+     * @param term Term of the entry
      */
     void put_entry(
       const std::vector<uint8_t>& entry,
       bool globally_committable,
-      bool force_chunk = false)
+      bool force_chunk,
+      Term term)
     {
-      put_entry(entry.data(), entry.size(), globally_committable, force_chunk);
+      put_entry(
+        entry.data(), entry.size(), globally_committable, force_chunk, term);
     }
 
     /**
@@ -46,6 +49,7 @@ namespace consensus
      * @param globally_committable True is entry is signature transaction
      * @param force_chunk Force new ledger chunk to be created after this entry
      * (only if globally_committable)
+     * @param term Term of the entry
      *
      * Note: The entry should already contain its own header.
      */
@@ -53,7 +57,8 @@ namespace consensus
       const uint8_t* data,
       size_t size,
       bool globally_committable,
-      bool force_chunk = false)
+      bool force_chunk,
+      Term term)
     {
       CCF_ASSERT_FMT(
         globally_committable || !force_chunk,
@@ -65,6 +70,7 @@ namespace consensus
         to_host,
         globally_committable,
         force_chunk,
+        term,
         byte_range);
     }
 
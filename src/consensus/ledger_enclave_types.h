@@ -7,6 +7,7 @@
 namespace consensus
 {
   using Index = uint64_t;
+  using Term = uint64_t;
 
   enum LedgerRequestPurpose : uint8_t
   {
@@ -24,6 +25,20 @@ namespace consensus
     DEFINE_RINGBUFFER_MSG_TYPE(ledger_entry),
     DEFINE_RINGBUFFER_MSG_TYPE(ledger_no_entry),
 
+    /// Request a contiguous range of ledger entries. Enclave -> Host
+    DEFINE_RINGBUFFER_MSG_TYPE(ledger_get_range),
+
+    /// Respond to ledger_get_range. A single request may be answered by
+    /// several ledger_entry_range messages, each containing consecutive framed
+    /// entries, optionally followed by a ledger_no_entry_range for the
+    /// entries the host could not read. Host -> Enclave
+    DEFINE_RINGBUFFER_MSG_TYPE(ledger_entry_range),
+    DEFINE_RINGBUFFER_MSG_TYPE(ledger_no_entry_range),
+
+    /// Report that ledger entries up to an index have been synced to stable
+    /// storage. Host -> Enclave
+    DEFINE_RINGBUFFER_MSG_TYPE(ledger_durable),
+
     /// Modify the local ledger. Enclave -> Host
     DEFINE_RINGBUFFER_MSG_TYPE(ledger_append),
     DEFINE_RINGBUFFER_MSG_TYPE(ledger_truncate),
@@ -31,7 +46,9 @@ namespace consensus
     DEFINE_RINGBUFFER_MSG_TYPE(ledger_init),
 
     /// Create and commit a snapshot. Enclave -> Host
+    DEFINE_RINGBUFFER_MSG_TYPE(snapshot_chunk),
     DEFINE_RINGBUFFER_MSG_TYPE(snapshot),
+    DEFINE_RINGBUFFER_MSG_TYPE(snapshot_discard),
     DEFINE_RINGBUFFER_MSG_TYPE(snapshot_commit),
   };
 }
@@ -47,20 +64,46 @@ DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
   consensus::ledger_no_entry,
   consensus::Index,
   consensus::LedgerRequestPurpose);
+DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
+  consensus::ledger_get_range,
+  consensus::Index /* from idx */,
+  consensus::Index /* to idx */,
+  consensus::LedgerRequestPurpose);
+DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
+  consensus::ledger_entry_range,
+  consensus::Index /* from idx */,
+  consensus::Index /* to idx */,
+  consensus::LedgerRequestPurpose,
+  std::vector<uint8_t> /* framed entries */);
+DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
+  consensus::ledger_no_entry_range,
+  consensus::Index /* from idx */,
+  consensus::Index /* to idx */,
+  consensus::LedgerRequestPurpose);
+DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
+  consensus::ledger_durable, consensus::Index);
 DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(consensus::ledger_init, consensus::Index);
 DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
   consensus::ledger_append,
   bool /* committable */,
   bool /* force chunk */,
+  consensus::Term,
   std::vector<uint8_t>);
 DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
   consensus::ledger_truncate, consensus::Index);
 DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(consensus::ledger_commit, consensus::Index);
+DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
+  consensus::snapshot_chunk,
+  consensus::Index /* snapshot idx */,
+  bool /* first chunk */,
+  std::vector<uint8_t>);
 DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
   consensus::snapshot,
   consensus::Index /* snapshot idx */,
   consensus::Index /* evidence idx */,
-  std::vector<uint8_t>);
+  consensus::Index /* delta base snapshot idx, 0 for a full snapshot */);
+DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
+  consensus::snapshot_discard, consensus::Index /* snapshot idx */);
 DECLARE_RINGBUFFER_MESSAGE_PAYLOAD(
   consensus::snapshot_commit,
   consensus::Index /* snapshot idx */,
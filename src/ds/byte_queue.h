@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace ds
+{
+  /**
+   * A FIFO queue of bytes, for buffering partially received or partially sent
+   * streams. Bytes are appended at the back and consumed from the front, and
+   * the unconsumed bytes are always available as a single contiguous range
+   * through data() and size(), so that parsers can read them in place.
+   *
+   * Consuming bytes only advances a read offset. The unconsumed bytes are
+   * moved back to the start of the buffer when the queue is drained, or when
+   * appending would otherwise grow the buffer and at least as many bytes have
+   * been consumed as remain. Each byte is then moved at most a constant number
+   * of times on average, where erasing from the front of a vector moves every
+   * remaining byte on each consume.
+   */
+  class ByteQueue
+  {
+  private:
+    std::vector<uint8_t> buffer;
+    size_t offset = 0;
+
+    void compact()
+    {
+      const auto remaining = size();
+      if (remaining > 0)
+      {
+        ::memmove(buffer.data(), buffer.data() + offset, remaining);
+      }
+      buffer.resize(remaining);
+      offset = 0;
+    }
+
+  public:
+    ByteQueue() = default;
+
+    void append(const uint8_t* data, size_t len)
+    {
+      if (len == 0)
+      {
+        return;
+      }
+
+      if (
+        offset > 0 && buffer.size() + len > buffer.capacity() &&
+        offset >= size())
+      {
+        compact();
+      }
+
+      buffer.insert(buffer.end(), data, data + len);
+    }
+
+    void append(const std::vector<uint8_t>& data)
+    {
+      append(data.data(), data.size());
+    }
+
+    /// Remove the first n unconsumed bytes. Throws if fewer than n remain.
+    void consume(size_t n)
+    {
+      if (n > size())
+      {
+        throw std::logic_error("Cannot consume more bytes than are queued");
+      }
+
+      offset += n;
+      if (offset == buffer.size())
+      {
+        clear();
+      }
+    }
+
+    /// Remove all bytes, retaining the allocated capacity
+    void clear()
+    {
+      buffer.clear();
+      offset = 0;
+    }
+
+    const uint8_t* data() const
+    {
+      return buffer.data() + offset;
+    }
+
+    size_t size() const
+    {
+      return buffer.size() - offset;
+    }
+
+    bool empty() const
+    {
+      return size() == 0;
+    }
+
+    size_t capacity() const
+    {
+      return buffer.capacity();
+    }
+  };
+}
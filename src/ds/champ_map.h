@@ -178,6 +178,29 @@ namespace champ
       }
       return true;
     }
+
+    template <class F>
+    bool foreach_changed(const Collisions<K, V, H>* base, F&& f) const
+    {
+      if (base == this)
+        return true;
+
+      for (size_t i = 0; i < bins.size(); ++i)
+      {
+        for (const auto& entry : bins[i])
+        {
+          if (
+            base != nullptr &&
+            std::find(base->bins[i].begin(), base->bins[i].end(), entry) !=
+              base->bins[i].end())
+            continue;
+
+          if (!f(entry->key, entry->value))
+            return false;
+        }
+      }
+      return true;
+    }
   };
 
   template <class K, class V, class H>
@@ -382,6 +405,60 @@ namespace champ
       return true;
     }
 
+    // Calls f with the entries of this node which are not shared with base,
+    // the node at the same position in an earlier version of the map. Nodes
+    // shared with base are skipped.
+    template <class F>
+    bool foreach_changed(
+      SmallIndex depth, const SubNodes<K, V, H>* base, F&& f) const
+    {
+      if (base == this)
+        return true;
+
+      if (base == nullptr)
+        return foreach(depth, std::forward<F>(f));
+
+      for (SmallIndex idx = 0; idx < (1 << index_mask_bits); ++idx)
+      {
+        if (data_map.check(idx))
+        {
+          const auto& entry = node_as<Entry<K, V>>(compressed_idx(idx));
+          if (
+            base->data_map.check(idx) &&
+            base->node_as<Entry<K, V>>(base->compressed_idx(idx)) ==
+              entry)
+            continue;
+
+          if (!f(entry->key, entry->value))
+            return false;
+        }
+        else if (node_map.check(idx))
+        {
+          const auto c_idx = compressed_idx(idx);
+          const void* base_node = base->node_map.check(idx) ?
+            base->nodes[base->compressed_idx(idx)].get() :
+            nullptr;
+
+          if (depth == (collision_depth - 1))
+          {
+            if (!node_as<Collisions<K, V, H>>(c_idx)->foreach_changed(
+                  static_cast<const Collisions<K, V, H>*>(base_node),
+                  std::forward<F>(f)))
+              return false;
+          }
+          else
+          {
+            if (!node_as<SubNodes<K, V, H>>(c_idx)->foreach_changed(
+                  depth + 1,
+                  static_cast<const SubNodes<K, V, H>*>(base_node),
+                  std::forward<F>(f)))
+              return false;
+          }
+        }
+      }
+      return true;
+    }
+
   private:
     template <class A>
     const std::shared_ptr<A>& node_as(SmallIndex c_idx) const
@@ -410,9 +487,11 @@ namespace champ
   public:
     Map() : root(std::make_shared<SubNodes<K, V, H>>()) {}
 
-    static Map<K, V, H> deserialize_map(CBuffer serialized_state)
+    // Entries of serialized_state are added to map, so that a map serialized
+    // in several segments can be deserialized one segment at a time
+    static Map<K, V, H> deserialize_map(
+      CBuffer serialized_state, Map<K, V, H> map = Map<K, V, H>())
     {
-      Map<K, V, H> map;
       const uint8_t* data = serialized_state.p;
       size_t size = serialized_state.rawSize();
 
@@ -490,6 +569,18 @@ namespace champ
     {
       return root->foreach(0, std::forward<F>(f));
     }
+
+    /** Call f with each entry of this map which was added or updated since
+     * base, an earlier version of this map. Parts of the map shared with base
+     * are skipped, so that the cost is proportional to the changes rather than
+     * the size of the map. Some unchanged entries may also be reported, and
+     * entries removed since base are not reported.
+     */
+    template <class F>
+    bool foreach_changed(const Map<K, V, H>& base, F&& f) const
+    {
+      return root->foreach_changed(0, base.root.get(), std::forward<F>(f));
+    }
   };
 
   template <class K, class V, class H = std::hash<K>>
@@ -520,6 +611,43 @@ namespace champ
       return padding_size;
     }
 
+    // Entries are sorted by key hash to be able to generate byte-for-byte
+    // serialised snapshot from the same state
+    std::vector<KVTuple> get_ordered_state(size_t& size) const
+    {
+      std::vector<KVTuple> ordered_state;
+      ordered_state.reserve(map.size());
+      size = 0;
+
+      map.foreach([&](auto& key, auto& value) {
+        K* k = &key;
+        V* v = &value;
+        size += get_size_with_padding(key, value);
+
+        ordered_state.emplace_back(k, static_cast<Hash>(H()(key)), v);
+
+        return true;
+      });
+
+      std::sort(
+        ordered_state.begin(), ordered_state.end(), [](KVTuple& i, KVTuple& j) {
+          return i.h_k < j.h_k;
+        });
+
+      return ordered_state;
+    }
+
+    void serialize_entry(const KVTuple& p, uint8_t*& data, size_t& size) const
+    {
+      // Serialize the key
+      uint32_t key_size = champ::serialize(*p.k, data, size);
+      add_padding(key_size, data, size);
+
+      // Serialize the value
+      uint32_t value_size = champ::serialize(*p.v, data, size);
+      add_padding(value_size, data, size);
+    }
+
   public:
     Snapshot(Map<K, V, H>& map_)
     {
@@ -531,6 +659,20 @@ namespace champ
       return map.get_serialized_size();
     }
 
+    /** Snapshot of the entries which were added or updated since base, a
+     * snapshot of an earlier version of the same map (see
+     * Map::foreach_changed).
+     */
+    Snapshot<K, V, H> diff(const Snapshot<K, V, H>& base) const
+    {
+      Map<K, V, H> changes;
+      map.foreach_changed(base.map, [&changes](const K& k, const V& v) {
+        changes = changes.put(k, v);
+        return true;
+      });
+      return Snapshot<K, V, H>(changes);
+    }
+
     CBuffer& get_serialized_buffer()
     {
       return serialized_buffer;
@@ -538,31 +680,8 @@ namespace champ
 
     void serialize(uint8_t* data)
     {
-      std::vector<KVTuple> ordered_state;
-      ordered_state.reserve(map.size());
       size_t size = 0;
-
-      map.foreach([&](auto& key, auto& value) {
-        K* k = &key;
-        V* v = &value;
-        uint32_t ks = champ::get_size(key);
-        uint32_t vs = champ::get_size(value);
-        uint32_t key_size = ks + get_padding(ks);
-        uint32_t value_size = vs + get_padding(vs);
-
-        size += (key_size + value_size);
-
-        ordered_state.emplace_back(k, static_cast<Hash>(H()(key)), v);
-
-        return true;
-      });
-
-      // Sort keys to be able to generate byte-for-byte serialised snapshot from
-      // the same state
-      std::sort(
-        ordered_state.begin(), ordered_state.end(), [](KVTuple& i, KVTuple& j) {
-          return i.h_k < j.h_k;
-        });
+      const auto ordered_state = get_ordered_state(size);
 
       CCF_ASSERT_FMT(
         size == map.get_serialized_size(),
@@ -576,16 +695,46 @@ namespace champ
 
       for (const auto& p : ordered_state)
       {
-        // Serialize the key
-        uint32_t key_size = champ::serialize(*p.k, data, size);
-        add_padding(key_size, data, size);
-
-        // Serialize the value
-        uint32_t value_size = champ::serialize(*p.v, data, size);
-        add_padding(value_size, data, size);
+        serialize_entry(p, data, size);
       }
 
       CCF_ASSERT_FMT(size == 0, "buffer not filled, remaining:{}", size);
     }
+
+    /** Serialize the map in segments which, once concatenated, are identical
+     * to the output of serialize(). Each segment holds whole entries and is at
+     * most max_segment_size bytes, unless it holds a single larger entry. f is
+     * called with each segment in turn, which it may take ownership of, and
+     * once with an empty segment if the map is empty.
+     */
+    template <class F>
+    void serialize_segments(size_t max_segment_size, F&& f) const
+    {
+      size_t total_size = 0;
+      const auto ordered_state = get_ordered_state(total_size);
+
+      std::vector<uint8_t> segment;
+      segment.reserve(std::min(total_size, max_segment_size));
+
+      for (const auto& p : ordered_state)
+      {
+        size_t size = get_size_with_padding(*p.k, *p.v);
+        if (!segment.empty() && segment.size() + size > max_segment_size)
+        {
+          f(std::move(segment));
+          segment.clear();
+        }
+
+        const auto offset = segment.size();
+        segment.resize(offset + size);
+        uint8_t* data = segment.data() + offset;
+        serialize_entry(p, data, size);
+      }
+
+      if (!segment.empty() || ordered_state.empty())
+      {
+        f(std::move(segment));
+      }
+    }
   };
 }
@@ -118,15 +118,20 @@ namespace histogram
 
     size_t underflow = 0;
     size_t overflow = 0;
-    size_t count[BUCKETS];
+    size_t count[BUCKETS] = {};
 
     This* next;
 
   public:
-    Histogram(Global<This>& g) :
+    // Histogram which is not registered with any Global, e.g. when it is
+    // owned and aggregated by its user
+    Histogram() :
       low((std::numeric_limits<V>::max)()),
       high((std::numeric_limits<V>::min)()),
       next(nullptr)
+    {}
+
+    Histogram(Global<This>& g) : Histogram()
     {
       g.add(*this);
     }
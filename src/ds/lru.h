@@ -11,8 +11,8 @@
  * that this still does what you want!
  *
  * The search methods (begin, end, find, contains) do _not_ count as access and
- * do not alter the recently used order. Only insert() and operator[] modify the
- * order.
+ * do not alter the recently used order. Only insert(), operator[] and promote()
+ * modify the order.
  */
 template <typename K, typename V>
 class LRU
@@ -117,6 +117,12 @@ public:
     return entries_list.begin();
   }
 
+  // Marks the entry at it, returned by find(), as most recently accessed
+  void promote(Iterator it)
+  {
+    entries_list.splice(entries_list.begin(), entries_list, it);
+  }
+
   V& operator[](K&& k)
   {
     auto it = insert(std::forward<K>(k), V{});
@@ -4,8 +4,19 @@
 
 #include "ring_buffer_types.h"
 
+#include <chrono>
 #include <cstring>
 #include <functional>
+#include <thread>
+
+// Doorbells are signalled through an eventfd, which SGX enclaves cannot use.
+// There, writers never ring doorbells, and readers waiting on them sleep.
+#if !defined(INSIDE_ENCLAVE) || defined(VIRTUAL_ENCLAVE)
+#  define RINGBUFFER_EVENTFD_DOORBELL
+#  include <poll.h>
+#  include <sys/eventfd.h>
+#  include <unistd.h>
+#endif
 
 // Ideally this would be _mm_pause or similar, but finding cross-platform
 // headers that expose this neatly through OE (ie - non-standard std libs) is
@@ -91,6 +102,100 @@ namespace ringbuffer
     const size_t size;
   };
 
+  namespace doorbell
+  {
+    /// Open an eventfd for the doorbell. Called by the host, which owns the
+    /// ringbuffers, before they are used.
+    inline void open(Doorbell& d)
+    {
+#ifdef RINGBUFFER_EVENTFD_DOORBELL
+      d.fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (d.fd < 0)
+      {
+        throw std::runtime_error("Could not create ringbuffer doorbell");
+      }
+#endif
+    }
+
+    inline void close(Doorbell& d)
+    {
+#ifdef RINGBUFFER_EVENTFD_DOORBELL
+      if (d.fd >= 0)
+      {
+        ::close(d.fd);
+        d.fd = -1;
+      }
+#endif
+    }
+
+    /// Signal the doorbell unconditionally
+    inline void ring(Doorbell& d)
+    {
+#ifdef RINGBUFFER_EVENTFD_DOORBELL
+      if (d.fd >= 0)
+      {
+        uint64_t one = 1;
+        [[maybe_unused]] auto rc = ::write(d.fd, &one, sizeof(one));
+      }
+#endif
+    }
+
+    /// Reset a signalled doorbell, once its reader has woken up
+    inline void clear(Doorbell& d)
+    {
+#ifdef RINGBUFFER_EVENTFD_DOORBELL
+      if (d.fd >= 0)
+      {
+        uint64_t count;
+        [[maybe_unused]] auto rc = ::read(d.fd, &count, sizeof(count));
+      }
+#endif
+    }
+
+    /// Called by writers once a message is complete. Rings the doorbell if
+    /// the reader is waiting, such that only the first writer to complete a
+    /// message while the reader waits makes a syscall.
+    inline void notify(Doorbell& d)
+    {
+#ifdef RINGBUFFER_EVENTFD_DOORBELL
+      // Orders the write of the message before the read of waiting, and pairs
+      // with the fence in prepare_wait, so that either the reader sees the
+      // message or the writer sees the reader waiting
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (
+        d.waiting.load(std::memory_order_relaxed) &&
+        d.waiting.exchange(false, std::memory_order_acq_rel))
+      {
+        ring(d);
+      }
+#endif
+    }
+
+    inline void prepare_wait(Doorbell& d)
+    {
+      d.waiting.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    /// Block until the doorbell is rung or timeout elapses, and reset it.
+    /// Sleeps for timeout if the doorbell cannot be used.
+    inline void wait(Doorbell& d, std::chrono::milliseconds timeout)
+    {
+#ifdef RINGBUFFER_EVENTFD_DOORBELL
+      if (d.fd >= 0)
+      {
+        pollfd pfd = {d.fd, POLLIN, 0};
+        ::poll(&pfd, 1, timeout.count());
+        clear(d);
+        d.waiting.store(false, std::memory_order_relaxed);
+        return;
+      }
+#endif
+      std::this_thread::sleep_for(timeout);
+      d.waiting.store(false, std::memory_order_relaxed);
+    }
+  }
+
   struct BufferDef
   {
     uint8_t* data;
@@ -158,6 +263,34 @@ namespace ringbuffer
       return count;
     }
 
+    /// Returns true if there is no message, complete or pending, to read
+    bool is_empty()
+    {
+      auto hd = bd.offsets->head.load(std::memory_order_acquire);
+      return message(read64(hd & (bd.size - 1))) == Const::msg_none;
+    }
+
+    /// Announce that the reader is about to wait for messages, so that the
+    /// next message written rings the doorbell. Messages written before this
+    /// do not, so the reader must check is_empty() before waiting.
+    void prepare_wait()
+    {
+      doorbell::prepare_wait(bd.offsets->doorbell);
+    }
+
+    /// Block until a message is written after prepare_wait(), or at most
+    /// timeout
+    void wait(std::chrono::milliseconds timeout)
+    {
+      doorbell::wait(bd.offsets->doorbell, timeout);
+    }
+
+    /// Ring the doorbell, waking the reader when it next waits
+    void notify()
+    {
+      doorbell::ring(bd.offsets->doorbell);
+    }
+
   private:
     uint64_t read64(size_t index)
     {
@@ -270,6 +403,8 @@ namespace ringbuffer
         const auto index = marker.value() - Const::header_size();
         auto size = read32(index);
         write32(index, size & length_mask);
+
+        doorbell::notify(bd.offsets->doorbell);
       }
     }
 
@@ -18,11 +18,22 @@ namespace ringbuffer
   // Align by cacheline to avoid false sharing
   static constexpr size_t CACHELINE_SIZE = 64;
 
+  // Lets the reader of a ringbuffer block until a message is written to it,
+  // rather than polling. fd is an eventfd opened by the host, which writers
+  // signal after writing a message if the reader has announced that it is
+  // waiting.
+  struct Doorbell
+  {
+    std::atomic<bool> waiting = {false};
+    int fd = -1;
+  };
+
   struct alignas(CACHELINE_SIZE) Offsets
   {
     std::atomic<size_t> head_cache = {0};
     std::atomic<size_t> tail = {0};
     alignas(CACHELINE_SIZE) std::atomic<size_t> head = {0};
+    alignas(CACHELINE_SIZE) Doorbell doorbell;
   };
 
   class message_error : public std::logic_error
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+
+#include "../byte_queue.h"
+
+#include <algorithm>
+#include <deque>
+#include <doctest/doctest.h>
+#include <random>
+
+TEST_CASE("ByteQueue" * doctest::test_suite("byte_queue"))
+{
+  ds::ByteQueue q;
+  REQUIRE(q.empty());
+  REQUIRE(q.size() == 0);
+
+  const std::vector<uint8_t> abc = {'a', 'b', 'c'};
+  const std::vector<uint8_t> defg = {'d', 'e', 'f', 'g'};
+
+  q.append(abc);
+  q.append(defg);
+  REQUIRE(q.size() == 7);
+  REQUIRE(std::memcmp(q.data(), "abcdefg", 7) == 0);
+
+  q.consume(2);
+  REQUIRE(q.size() == 5);
+  REQUIRE(std::memcmp(q.data(), "cdefg", 5) == 0);
+
+  REQUIRE_THROWS_AS(q.consume(6), std::logic_error);
+
+  q.consume(5);
+  REQUIRE(q.empty());
+
+  // Draining the queue keeps its capacity
+  const auto capacity = q.capacity();
+  REQUIRE(capacity >= 7);
+  q.append(abc);
+  REQUIRE(q.capacity() == capacity);
+  REQUIRE(std::memcmp(q.data(), "abc", 3) == 0);
+
+  q.clear();
+  REQUIRE(q.empty());
+  q.append(nullptr, 0);
+  REQUIRE(q.empty());
+}
+
+TEST_CASE(
+  "ByteQueue matches a reference queue" * doctest::test_suite("byte_queue"))
+{
+  std::mt19937 rng(42);
+  ds::ByteQueue q;
+  std::deque<uint8_t> reference;
+
+  uint8_t next = 0;
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    std::vector<uint8_t> chunk(rng() % 64);
+    for (auto& c : chunk)
+    {
+      c = next++;
+    }
+    q.append(chunk.data(), chunk.size());
+    reference.insert(reference.end(), chunk.begin(), chunk.end());
+
+    const auto n = rng() % (q.size() + 1);
+    q.consume(n);
+    reference.erase(reference.begin(), reference.begin() + n);
+
+    REQUIRE(q.size() == reference.size());
+    REQUIRE(std::equal(reference.begin(), reference.end(), q.data()));
+  }
+}
+
+TEST_CASE(
+  "ByteQueue reuses consumed space" * doctest::test_suite("byte_queue"))
+{
+  ds::ByteQueue q;
+  const std::vector<uint8_t> chunk(10, 'x');
+
+  // A queue that is never drained, but whose consumer keeps up, does not
+  // grow without bound
+  q.append(std::vector<uint8_t>(100, 'y'));
+  for (size_t i = 0; i < 100000; ++i)
+  {
+    q.append(chunk);
+    q.consume(chunk.size());
+  }
+  REQUIRE(q.size() == 100);
+  REQUIRE(q.capacity() <= 1024);
+  REQUIRE(std::all_of(q.data(), q.data() + q.size(), [](auto c) {
+    return c == 'x';
+  }));
+}
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#define PICOBENCH_IMPLEMENT_WITH_MAIN
+#include "../byte_queue.h"
+
+#include <picobench/picobench.hpp>
+
+template <class A>
+inline void do_not_optimize(A const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber_memory()
+{
+  asm volatile("" : : : "memory");
+}
+
+// Receive buffer as it was before ByteQueue, erasing consumed bytes from the
+// front of a vector
+class VectorQueue
+{
+  std::vector<uint8_t> buffer;
+
+public:
+  void append(const uint8_t* data, size_t len)
+  {
+    buffer.insert(buffer.end(), data, data + len);
+  }
+
+  void consume(size_t n)
+  {
+    buffer.erase(buffer.begin(), buffer.begin() + n);
+  }
+
+  const uint8_t* data() const
+  {
+    return buffer.data();
+  }
+
+  size_t size() const
+  {
+    return buffer.size();
+  }
+};
+
+// Receives s.iterations() chunks of ChunkSize bytes, and after each chunk
+// consumes ReadSize bytes at a time for as long as that many are queued, as
+// mbedtls does when reading records through TLSEndpoint::handle_recv. Erasing
+// each read from the front of a vector moves the rest of the chunk every time.
+template <typename Q, size_t ChunkSize, size_t ReadSize>
+static void receive(picobench::state& s)
+{
+  const std::vector<uint8_t> chunk(ChunkSize, 42);
+  Q q;
+
+  s.start_timer();
+  for (auto _ : s)
+  {
+    (void)_;
+    q.append(chunk.data(), chunk.size());
+
+    while (q.size() >= ReadSize)
+    {
+      do_not_optimize(q.data()[ReadSize - 1]);
+      q.consume(ReadSize);
+    }
+    clobber_memory();
+  }
+  s.stop_timer();
+}
+
+const std::vector<int> chunk_counts = {100, 1000};
+
+#define PICO_SUFFIX() iterations(chunk_counts).samples(3)
+
+using Vector = VectorQueue;
+using ByteQueue = ds::ByteQueue;
+
+PICOBENCH_SUITE("64KB chunks, 100B reads");
+namespace SMALL_READS
+{
+  auto vector = receive<Vector, 1 << 16, 100>;
+  PICOBENCH(vector).PICO_SUFFIX().baseline();
+  auto byte_queue = receive<ByteQueue, 1 << 16, 100>;
+  PICOBENCH(byte_queue).PICO_SUFFIX();
+}
+
+PICOBENCH_SUITE("1MB chunks, 16KB reads");
+namespace RECORD_READS
+{
+  auto vector = receive<Vector, 1 << 20, 1 << 14>;
+  PICOBENCH(vector).PICO_SUFFIX().baseline();
+  auto byte_queue = receive<ByteQueue, 1 << 20, 1 << 14>;
+  PICOBENCH(byte_queue).PICO_SUFFIX();
+}
+
+PICOBENCH_SUITE("4KB chunks, 1MB reads");
+namespace LARGE_READS
+{
+  auto vector = receive<Vector, 1 << 12, 1 << 20>;
+  PICOBENCH(vector).PICO_SUFFIX().baseline();
+  auto byte_queue = receive<ByteQueue, 1 << 12, 1 << 20>;
+  PICOBENCH(byte_queue).PICO_SUFFIX();
+}
@@ -178,4 +178,18 @@ TEST_CASE("LRU" * doctest::test_suite("lru"))
     ++it;
     REQUIRE(it == lru.end());
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("LRU promote" * doctest::test_suite("lru"))
+{
+  LRU<size_t, std::string> lru(2);
+  lru[0] = "a";
+  lru[1] = "b";
+
+  INFO("Promoting a key found with find(k) makes it recently accessed");
+  lru.promote(lru.find(0));
+  lru[2] = "c";
+  REQUIRE(lru.contains(0));
+  REQUIRE_FALSE(lru.contains(1));
+  REQUIRE(lru.contains(2));
+}
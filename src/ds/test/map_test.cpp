@@ -193,6 +193,23 @@ TEST_CASE("persistent map operations")
       REQUIRE(n == champ.size());
     }
 
+    INFO("check changes since previous version");
+    {
+      Model changes;
+      champ_new.foreach_changed(champ, [&](const auto& k, const auto& v) {
+        REQUIRE(model_new.get(k) == v);
+        changes = changes.put(k, v);
+        return true;
+      });
+      champ_new.foreach([&](const auto& k, const auto& v) {
+        if (model.get(k) != v)
+        {
+          REQUIRE(changes.get(k) == v);
+        }
+        return true;
+      });
+    }
+
     model = model_new;
     champ = champ_new;
   }
@@ -287,6 +304,55 @@ TEST_CASE("serialize map")
     REQUIRE_EQ(s_1, s_2);
   }
 
+  INFO("Serialize map in segments");
+  {
+    champ::Snapshot<K, V, H> snapshot(map);
+    std::vector<uint8_t> s(map.get_serialized_size());
+    snapshot.serialize(s.data());
+
+    const size_t max_segment_size = 100;
+    size_t segment_count = 0;
+    std::vector<uint8_t> segments;
+    champ::Map<K, V, H> new_map;
+    snapshot.serialize_segments(max_segment_size, [&](const auto& segment) {
+      REQUIRE_LE(segment.size(), max_segment_size);
+      segments.insert(segments.end(), segment.begin(), segment.end());
+      new_map = champ::Map<K, V, H>::deserialize_map(segment, new_map);
+      segment_count++;
+    });
+
+    REQUIRE_GT(segment_count, 1);
+    REQUIRE_EQ(s, segments);
+    REQUIRE_EQ(map.size(), new_map.size());
+
+    segment_count = 0;
+    champ::Map<K, V, H> empty_map;
+    champ::Snapshot<K, V, H> empty_snapshot(empty_map);
+    empty_snapshot.serialize_segments(
+      max_segment_size, [&](const auto& segment) {
+        REQUIRE(segment.empty());
+        segment_count++;
+      });
+    REQUIRE_EQ(segment_count, 1);
+  }
+
+  INFO("Diff snapshot against earlier version");
+  {
+    champ::Snapshot<K, V, H> snapshot(map);
+    REQUIRE_EQ(snapshot.diff(snapshot).get_serialized_size(), 0);
+
+    auto new_map = map.put(0, 42).put(num_elements, num_elements);
+    champ::Snapshot<K, V, H> new_snapshot(new_map);
+    auto diff = new_snapshot.diff(snapshot);
+    REQUIRE_LT(diff.get_serialized_size(), map.get_serialized_size());
+
+    std::vector<uint8_t> s(diff.get_serialized_size());
+    diff.serialize(s.data());
+    auto changes = champ::Map<K, V, H>::deserialize_map(s);
+    REQUIRE_EQ(changes.get(0), 42);
+    REQUIRE_EQ(changes.get(num_elements), num_elements);
+  }
+
   INFO("Serialize map with different key sizes");
   {
     using SerialisedKey = champ::serialisers::SerialisedEntry;
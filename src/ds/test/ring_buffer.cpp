@@ -514,3 +514,65 @@ TEST_CASE("Multiple threads can wait" * doctest::test_suite("ringbuffer"))
     }
   }
 }
+
+TEST_CASE("Readers can wait on doorbell" * doctest::test_suite("ringbuffer"))
+{
+  constexpr size_t size = 1 << 10;
+  constexpr size_t message_count = 1000;
+  constexpr std::chrono::seconds timeout(10);
+
+  auto buffer = std::make_unique<ringbuffer::TestBuffer>(size);
+  doorbell::open(buffer->offsets.doorbell);
+  Reader r(buffer->bd);
+
+  REQUIRE(r.is_empty());
+
+  {
+    INFO("Messages written before prepare_wait() do not ring the doorbell");
+    Writer w(r);
+    w.write(small_message, (uint8_t)0);
+    REQUIRE(!r.is_empty());
+    r.prepare_wait();
+    REQUIRE(!r.is_empty());
+    REQUIRE(r.read(-1, nop_handler) == 1);
+    REQUIRE(r.is_empty());
+  }
+
+  {
+    INFO("A reader waiting for each message is woken by its writer");
+    std::atomic<size_t> acked = 0;
+    std::thread writer_thread([&r, &acked]() {
+      Writer w(r);
+      for (size_t i = 0; i < message_count; ++i)
+      {
+        // Wait for the reader to consume the previous message, so that most
+        // messages are written while it is blocked
+        while (acked.load() < i)
+        {
+          std::this_thread::yield();
+        }
+        w.write(small_message, (uint8_t)i);
+      }
+    });
+
+    size_t reads = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (reads < message_count)
+    {
+      r.prepare_wait();
+      if (r.is_empty())
+      {
+        r.wait(std::chrono::duration_cast<std::chrono::milliseconds>(timeout));
+      }
+      reads += r.read(-1, nop_handler);
+      acked.store(reads);
+    }
+
+    // Had any wake-up been missed, the reader would have slept for timeout
+    REQUIRE(std::chrono::steady_clock::now() - start < timeout);
+
+    writer_thread.join();
+  }
+
+  doorbell::close(buffer->offsets.doorbell);
+}
@@ -182,3 +182,63 @@ auto spin_200 = specialize<32, 1, 4, spin_pause_handler<200>>;
 FIXED_PICO(spin_200);
 auto spin_400 = specialize<32, 1, 4, spin_pause_handler<400>>;
 FIXED_PICO(spin_400);
+
+// Latency of messages written while the reader is idle, as at low load. The
+// reader either polls the ringbuffer every millisecond, as the host did from
+// a timer, or waits on its doorbell. The writer waits for each message to be
+// read before writing the next.
+template <bool UseDoorbell>
+static void idle_reader(picobench::state& s)
+{
+  constexpr std::chrono::milliseconds poll_period(1);
+
+  TestBuffer buffer(4096);
+  doorbell::open(buffer.offsets.doorbell);
+  Reader r(buffer.bd);
+  Writer w(r);
+
+  std::atomic<size_t> reads = 0;
+  std::atomic<bool> done = false;
+  std::thread reader_thread([&]() {
+    while (!done.load())
+    {
+      if constexpr (UseDoorbell)
+      {
+        r.prepare_wait();
+        if (r.is_empty())
+        {
+          r.wait(poll_period);
+        }
+      }
+      else
+      {
+        std::this_thread::sleep_for(poll_period);
+      }
+      reads += r.read(-1, nop_handler);
+    }
+  });
+
+  // Let the reader go idle
+  std::this_thread::sleep_for(poll_period * 2);
+
+  s.start_timer();
+  for (size_t i = 0; i < s.iterations(); ++i)
+  {
+    w.write(msg_type);
+    while (reads.load() <= i)
+    {
+      CCF_PAUSE();
+    }
+  }
+  s.stop_timer();
+
+  done.store(true);
+  reader_thread.join();
+  doorbell::close(buffer.offsets.doorbell);
+}
+
+PICOBENCH_SUITE("idle reader");
+auto timer_poll = idle_reader<false>;
+PICOBENCH(timer_poll).iterations({100}).samples(5).baseline();
+auto doorbell_wait = idle_reader<true>;
+PICOBENCH(doorbell_wait).iterations({100}).samples(5);
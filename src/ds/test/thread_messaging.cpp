@@ -59,4 +59,181 @@ TEST_CASE("Unpopped messages are freed")
   CHECK(Foo::count == 0);
 
   CHECK(happened);
-}
\ No newline at end of file
+}
+
+TEST_CASE("parallel_for")
+{
+  const auto thread_count = threading::ThreadMessaging::thread_count.load();
+  threading::ThreadMessaging::thread_count = 2;
+
+  {
+    threading::ThreadMessaging tm(2);
+
+    constexpr size_t n = 1000;
+    std::vector<std::atomic<size_t>> calls(n);
+
+    INFO("Every call is made once, with or without help from other threads");
+    {
+      std::atomic<bool> done = false;
+      std::thread helper([&]() {
+        while (!done)
+        {
+          tm.get_task(1).run_next_task();
+        }
+      });
+
+      tm.parallel_for(n, [&](size_t i) { calls[i]++; });
+      done = true;
+      helper.join();
+
+      for (const auto& c : calls)
+      {
+        REQUIRE(c == 1);
+      }
+
+      // Work queued for other threads may run after parallel_for has
+      // returned, and then has nothing left to do
+      tm.parallel_for(n, [&](size_t i) { calls[i]++; });
+      for (const auto& c : calls)
+      {
+        REQUIRE(c == 2);
+      }
+      while (tm.get_task(1).run_next_task())
+        ;
+    }
+
+    INFO("Exceptions are rethrown once all calls have completed");
+    {
+      std::atomic<size_t> completed = 0;
+      REQUIRE_THROWS_AS(
+        tm.parallel_for(
+          n,
+          [&](size_t i) {
+            completed++;
+            if (i % 10 == 0)
+            {
+              throw std::logic_error("Error");
+            }
+          }),
+        std::logic_error);
+      REQUIRE(completed == n);
+    }
+
+    tm.drop_tasks();
+  }
+
+  threading::ThreadMessaging::thread_count = thread_count;
+}
+
+struct Counter
+{
+  Counter(std::atomic<size_t>* count_) : count(count_) {}
+
+  std::atomic<size_t>* count;
+};
+
+static void increment(std::unique_ptr<threading::Tmsg<Counter>> msg)
+{
+  (*msg->data.count)++;
+}
+
+TEST_CASE("Idle threads park until a task is added")
+{
+  const auto thread_count = threading::ThreadMessaging::thread_count.load();
+  threading::ThreadMessaging::thread_count = 2;
+
+  {
+    threading::ThreadMessaging tm(2);
+    // Park as soon as there is nothing to do, so that most tasks are added
+    // to a parked thread
+    tm.set_idle_policy({0, 0, true});
+
+    std::thread worker([&]() {
+      threading::thread_id = 1;
+      tm.run();
+    });
+
+    constexpr size_t n = 100;
+    std::atomic<size_t> count = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      tm.add_task(
+        1, std::make_unique<threading::Tmsg<Counter>>(&increment, &count));
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    // Had any wake-up been missed, tasks would be left to run
+    while (count.load() < n)
+    {
+      std::this_thread::yield();
+    }
+
+    // Finishing wakes parked threads
+    tm.set_finished();
+    worker.join();
+
+    tm.drop_tasks();
+  }
+
+  threading::ThreadMessaging::thread_count = thread_count;
+}
+
+TEST_CASE("Threads waiting on other events are woken when a task is added")
+{
+  const auto thread_count = threading::ThreadMessaging::thread_count.load();
+  threading::ThreadMessaging::thread_count = 2;
+
+  {
+    threading::ThreadMessaging tm(2);
+    auto& task = tm.get_task(1);
+
+    // Stands in for another event source, such as a ringbuffer doorbell
+    std::mutex event_lock;
+    std::condition_variable event_cv;
+    bool event = false;
+
+    constexpr size_t n = 100;
+    std::atomic<size_t> count = 0;
+    std::atomic<size_t> timeouts = 0;
+    std::thread worker([&]() {
+      threading::thread_id = 1;
+      task.set_waker([&]() {
+        std::lock_guard<std::mutex> guard(event_lock);
+        event = true;
+        event_cv.notify_one();
+      });
+      while (count.load() < n)
+      {
+        if (!task.run_next_task())
+        {
+          task.park_with([&]() {
+            std::unique_lock<std::mutex> guard(event_lock);
+            if (!event_cv.wait_for(
+                  guard, std::chrono::seconds(10), [&]() { return event; }))
+            {
+              timeouts++;
+            }
+            event = false;
+          });
+        }
+      }
+    });
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      tm.add_task(
+        1, std::make_unique<threading::Tmsg<Counter>>(&increment, &count));
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    // Had any wake-up been missed, the worker would have waited until timing
+    // out
+    worker.join();
+    REQUIRE(count == n);
+    REQUIRE(timeouts == 0);
+
+    tm.drop_tasks();
+  }
+
+  threading::ThreadMessaging::thread_count = thread_count;
+}
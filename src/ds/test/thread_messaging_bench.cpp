@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#define PICOBENCH_IMPLEMENT_WITH_MAIN
+#define PICOBENCH_DONT_BIND_TO_ONE_CORE
+#include "../thread_messaging.h"
+
+#include <ctime>
+#include <picobench/picobench.hpp>
+#include <thread>
+
+threading::ThreadMessaging threading::ThreadMessaging::thread_messaging;
+std::atomic<uint16_t> threading::ThreadMessaging::thread_count = 0;
+
+namespace threading
+{
+  std::map<std::thread::id, uint16_t> thread_ids;
+}
+
+using Clock = std::chrono::steady_clock;
+
+// Pauses between checks but never parks
+static const threading::IdlePolicy spin = {1 << 6, 1 << 14, false};
+static const threading::IdlePolicy park = {};
+static const threading::IdlePolicy park_immediately = {0, 0, true};
+
+// Worker threads calling ThreadMessaging::run(), to which the benchmark
+// thread adds tasks
+class Workers
+{
+public:
+  threading::ThreadMessaging tm;
+
+private:
+  std::vector<std::thread> threads;
+
+public:
+  Workers(size_t n, const threading::IdlePolicy& policy) : tm(n + 1)
+  {
+    threading::ThreadMessaging::thread_count = n + 1;
+    tm.set_idle_policy(policy);
+    for (uint16_t tid = 1; tid <= n; ++tid)
+    {
+      threads.emplace_back([this, tid]() {
+        threading::thread_id = tid;
+        tm.run();
+      });
+    }
+  }
+
+  ~Workers()
+  {
+    tm.set_finished();
+    for (auto& t : threads)
+    {
+      t.join();
+    }
+    tm.drop_tasks();
+  }
+};
+
+struct Job
+{
+  Job(std::atomic<size_t>& done_, Clock::time_point& run_at_) :
+    done(done_),
+    run_at(run_at_)
+  {}
+
+  std::atomic<size_t>& done;
+  Clock::time_point& run_at;
+};
+
+static void job_cb(std::unique_ptr<threading::Tmsg<Job>> msg)
+{
+  msg->data.run_at = Clock::now();
+  msg->data.done++;
+}
+
+// Adds s.iterations() tasks to 4 workers and waits for all of them to run
+template <const threading::IdlePolicy& Policy>
+static void throughput(picobench::state& s)
+{
+  constexpr size_t worker_count = 4;
+  Workers workers(worker_count, Policy);
+  std::atomic<size_t> done = 0;
+  Clock::time_point run_at;
+
+  s.start_timer();
+  for (size_t i = 0; i < s.iterations(); ++i)
+  {
+    workers.tm.add_task(
+      1 + i % worker_count,
+      std::make_unique<threading::Tmsg<Job>>(&job_cb, done, run_at));
+  }
+  while (done.load() < s.iterations())
+  {
+    CCF_PAUSE();
+  }
+  s.stop_timer();
+}
+
+// Time from adding a task to an idle worker to it running, as at low load.
+// The worker is idle for 2ms before each task, long enough to park with the
+// default policy.
+template <const threading::IdlePolicy& Policy>
+static void wake_latency(picobench::state& s)
+{
+  Workers workers(1, Policy);
+  std::atomic<size_t> done = 0;
+  Clock::time_point run_at;
+
+  for (size_t i = 0; i < s.iterations(); ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+    const auto added_at = Clock::now();
+    workers.tm.add_task(
+      1, std::make_unique<threading::Tmsg<Job>>(&job_cb, done, run_at));
+    while (done.load() <= i)
+    {
+      CCF_PAUSE();
+    }
+    s.add_custom_duration(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(run_at - added_at)
+        .count());
+  }
+}
+
+static std::chrono::nanoseconds process_cpu_time()
+{
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+// CPU time used by 4 idle workers over s.iterations() milliseconds, reported
+// as the duration of the benchmark. A worker that never parks uses 1ms per
+// millisecond.
+template <const threading::IdlePolicy& Policy>
+static void idle_cpu(picobench::state& s)
+{
+  Workers workers(4, Policy);
+
+  const auto cpu_before = process_cpu_time();
+  std::this_thread::sleep_for(std::chrono::milliseconds(s.iterations()));
+  s.add_custom_duration((process_cpu_time() - cpu_before).count());
+}
+
+PICOBENCH_SUITE("throughput (4 workers)");
+auto throughput_spin = throughput<spin>;
+PICOBENCH(throughput_spin).iterations({10000, 100000}).samples(5).baseline();
+auto throughput_park = throughput<park>;
+PICOBENCH(throughput_park).iterations({10000, 100000}).samples(5);
+auto throughput_park_immediately = throughput<park_immediately>;
+PICOBENCH(throughput_park_immediately)
+  .iterations({10000, 100000})
+  .samples(5);
+
+PICOBENCH_SUITE("wake latency (1 worker)");
+auto wake_latency_spin = wake_latency<spin>;
+PICOBENCH(wake_latency_spin).iterations({100}).samples(3).baseline();
+auto wake_latency_park = wake_latency<park>;
+PICOBENCH(wake_latency_park).iterations({100}).samples(3);
+
+PICOBENCH_SUITE("idle CPU time (4 workers, per idle ms)");
+auto idle_cpu_spin = idle_cpu<spin>;
+PICOBENCH(idle_cpu_spin).iterations({100}).samples(3).baseline();
+auto idle_cpu_park = idle_cpu<park>;
+PICOBENCH(idle_cpu_park).iterations({100}).samples(3);
@@ -4,11 +4,17 @@
 
 #include "ds/ccf_assert.h"
 #include "ds/logger.h"
+#include "ds/ring_buffer.h"
 #include "ds/thread_ids.h"
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
 
 namespace threading
 {
@@ -43,11 +49,33 @@ namespace threading
 
   class ThreadMessaging;
 
+  /// How a thread with no tasks to run waits for more
+  struct IdlePolicy
+  {
+    /// Number of times the thread checks for tasks again straight away
+    size_t spins = 1 << 6;
+    /// Number of further checks, each after a CCF_PAUSE()
+    size_t pauses = 1 << 14;
+    /// Whether the thread then parks until a task is added to it. Otherwise,
+    /// it keeps pausing between checks.
+    bool park = true;
+  };
+
   class Task
   {
     std::atomic<ThreadMsg*> item_head = nullptr;
     ThreadMsg* local_msg = nullptr;
 
+    // Set while the thread running this task is parked, so that only adding
+    // a task to a parked thread takes the lock to wake it
+    std::atomic<bool> parked = false;
+    std::mutex park_lock;
+    std::condition_variable park_cv;
+
+    // If set, called instead of notifying park_cv when a task is added while
+    // the thread waits in park_with()
+    std::function<void()> waker = nullptr;
+
   public:
     Task() = default;
 
@@ -79,6 +107,56 @@ namespace threading
         tmp_head = item_head.load();
         item->next = tmp_head;
       } while (!item_head.compare_exchange_strong(tmp_head, item));
+
+      // Pairs with parked being set before item_head is checked in park(), so
+      // that either the parked thread sees this task or it is woken here
+      if (parked.load())
+      {
+        if (waker)
+        {
+          waker();
+        }
+        else
+        {
+          wake();
+        }
+      }
+    }
+
+    /// Block until a task is added, or until stop is set and wake() called
+    void park(const std::atomic<bool>& stop)
+    {
+      std::unique_lock<std::mutex> guard(park_lock);
+      parked.store(true);
+      park_cv.wait(
+        guard, [&]() { return item_head.load() != nullptr || stop.load(); });
+      parked.store(false);
+    }
+
+    void wake()
+    {
+      std::lock_guard<std::mutex> guard(park_lock);
+      park_cv.notify_one();
+    }
+
+    /// Set how to wake a thread blocked in park_with(). Must be called by the
+    /// thread running this task, before it first calls park_with().
+    void set_waker(std::function<void()> waker_)
+    {
+      waker = std::move(waker_);
+    }
+
+    /// For threads which also wait on other events: call wait() unless a task
+    /// is already queued, calling the waker if a task is added meanwhile
+    template <typename F>
+    void park_with(F&& wait)
+    {
+      parked.store(true);
+      if (item_head.load() == nullptr)
+      {
+        wait();
+      }
+      parked.store(false);
     }
 
     struct TimerEntry
@@ -212,6 +290,7 @@ namespace threading
   {
     std::atomic<bool> finished;
     std::vector<Task> tasks;
+    IdlePolicy idle_policy;
 
   public:
     static ThreadMessaging thread_messaging;
@@ -239,15 +318,49 @@ namespace threading
     void set_finished(bool v = true)
     {
       finished.store(v);
+
+      if (v)
+      {
+        for (auto& t : tasks)
+        {
+          t.wake();
+        }
+      }
+    }
+
+    /// Set how threads in run() wait for tasks. Must be called before any
+    /// thread calls run().
+    void set_idle_policy(const IdlePolicy& policy)
+    {
+      idle_policy = policy;
     }
 
     void run()
     {
       Task& task = get_task(get_current_thread_id());
 
+      size_t idles = 0;
       while (!is_finished())
       {
-        task.run_next_task();
+        if (task.run_next_task())
+        {
+          idles = 0;
+        }
+        else if (idles < idle_policy.spins)
+        {
+          idles++;
+        }
+        else if (
+          !idle_policy.park || idles < idle_policy.spins + idle_policy.pauses)
+        {
+          CCF_PAUSE();
+          idles++;
+        }
+        else
+        {
+          task.park(finished);
+          idles = 0;
+        }
       }
     }
 
@@ -322,6 +435,49 @@ namespace threading
       }
     }
 
+    /** Call f(i) for each i in [0, n), spreading the calls across the
+     * execution threads, and return once all calls have completed. The
+     * calling thread also makes calls, so that this completes even if no other
+     * thread picks up its share of the work. If f throws, the first exception
+     * is rethrown once all calls have completed.
+     */
+    void parallel_for(size_t n, const std::function<void(size_t)>& f)
+    {
+      if (n == 0)
+      {
+        return;
+      }
+
+      auto state = std::make_shared<ParallelForState>(f, n);
+
+      const auto current_tid = get_current_thread_id();
+      size_t helpers = 0;
+      for (uint16_t tid = 1; tid < thread_count && helpers + 1 < n; ++tid)
+      {
+        if (tid != current_tid)
+        {
+          add_task(
+            tid,
+            std::make_unique<Tmsg<ParallelForMsg>>(&parallel_for_cb, state));
+          helpers++;
+        }
+      }
+
+      state->run();
+
+      // Calls that have not started by now are made by this thread, so this
+      // only waits for calls already running on other threads
+      while (state->completed.load() < n)
+      {
+        CCF_PAUSE();
+      }
+
+      if (state->exception != nullptr)
+      {
+        std::rethrow_exception(state->exception);
+      }
+    }
+
     static uint16_t get_execution_thread(uint32_t i)
     {
       uint16_t tid = MAIN_THREAD_ID;
@@ -343,6 +499,56 @@ namespace threading
     }
 
   private:
+    struct ParallelForState
+    {
+      const std::function<void(size_t)> f;
+      const size_t n;
+      std::atomic<size_t> next = 0;
+      std::atomic<size_t> completed = 0;
+
+      std::mutex exception_lock;
+      std::exception_ptr exception = nullptr;
+
+      ParallelForState(const std::function<void(size_t)>& f_, size_t n_) :
+        f(f_),
+        n(n_)
+      {}
+
+      void run()
+      {
+        for (auto i = next++; i < n; i = next++)
+        {
+          try
+          {
+            f(i);
+          }
+          catch (...)
+          {
+            std::lock_guard<std::mutex> guard(exception_lock);
+            if (exception == nullptr)
+            {
+              exception = std::current_exception();
+            }
+          }
+          completed++;
+        }
+      }
+    };
+
+    struct ParallelForMsg
+    {
+      ParallelForMsg(std::shared_ptr<ParallelForState> state_) :
+        state(std::move(state_))
+      {}
+
+      std::shared_ptr<ParallelForState> state;
+    };
+
+    static void parallel_for_cb(std::unique_ptr<Tmsg<ParallelForMsg>> msg)
+    {
+      msg->data.state->run();
+    }
+
     bool is_finished()
     {
       return finished.load();
@@ -5,8 +5,11 @@
 #include "crypto/hash.h"
 #include "ds/logger.h"
 #include "ds/oversized.h"
+#include "ds/serialized.h"
 #include "enclave_time.h"
+#include "http/authentication/verifier_cache.h"
 #include "interface.h"
+#include "kv/serialised_entry_format.h"
 #include "node/entities.h"
 #include "node/historical_queries.h"
 #include "node/network_state.h"
@@ -61,6 +64,77 @@ namespace enclave
 
     std::unique_ptr<NodeContext> context = nullptr;
 
+    void recover_ledger_entry(const std::vector<uint8_t>& entry)
+    {
+      if (node->is_reading_public_ledger() || node->is_verifying_snapshot())
+      {
+        node->recover_public_ledger_entry(entry);
+      }
+      else if (node->is_reading_private_ledger())
+      {
+        node->recover_private_ledger_entry(entry);
+      }
+      else
+      {
+        auto [s, _, __] = node->state();
+        LOG_FAIL_FMT(
+          "Cannot recover ledger entry: Unexpected node state {}", s);
+      }
+    }
+
+    // Splits consecutive framed entries, recovering each one in turn
+    void recover_ledger_entries(
+      consensus::Index from_idx,
+      consensus::Index to_idx,
+      const std::vector<uint8_t>& framed_entries)
+    {
+      const uint8_t* data = framed_entries.data();
+      size_t size = framed_entries.size();
+      for (auto idx = from_idx; idx <= to_idx; ++idx)
+      {
+        size_t entry_size = 0;
+        if (size >= kv::serialised_entry_header_size)
+        {
+          const auto header =
+            serialized::peek<kv::SerialisedEntryHeader>(data, size);
+          entry_size = kv::serialised_entry_header_size + header.size;
+        }
+
+        if (entry_size == 0 || size < entry_size)
+        {
+          LOG_FAIL_FMT(
+            "Range of entries {} to {} is truncated at {}",
+            from_idx,
+            to_idx,
+            idx);
+          if (node->is_reading_ledger_idx(idx))
+          {
+            recover_ledger_end();
+          }
+          return;
+        }
+
+        if (node->is_reading_ledger_idx(idx))
+        {
+          std::vector<uint8_t> entry(data, data + entry_size);
+          recover_ledger_entry(entry);
+        }
+        serialized::skip(data, size, entry_size);
+      }
+    }
+
+    void recover_ledger_end()
+    {
+      if (node->is_verifying_snapshot())
+      {
+        node->verify_snapshot_end();
+      }
+      else
+      {
+        node->recover_ledger_end();
+      }
+    }
+
   public:
     Enclave(
       const EnclaveConfig& ec,
@@ -161,6 +235,9 @@ namespace enclave
       rpcsessions->set_max_open_sessions(
         ccf_config_.max_open_sessions_soft, ccf_config_.max_open_sessions_hard);
 
+      ccf::get_verifier_cache().set_max_verifiers(
+        ccf_config_.max_cached_verifiers);
+
       ccf::NodeCreateInfo r;
       try
       {
@@ -273,22 +350,7 @@ namespace enclave
             {
               case consensus::LedgerRequestPurpose::Recovery:
               {
-                if (
-                  node->is_reading_public_ledger() ||
-                  node->is_verifying_snapshot())
-                {
-                  node->recover_public_ledger_entry(body);
-                }
-                else if (node->is_reading_private_ledger())
-                {
-                  node->recover_private_ledger_entry(body);
-                }
-                else
-                {
-                  auto [s, _, __] = node->state();
-                  LOG_FAIL_FMT(
-                    "Cannot recover ledger entry: Unexpected node state {}", s);
-                }
+                recover_ledger_entry(body);
                 break;
               }
               case consensus::LedgerRequestPurpose::HistoricalQuery:
@@ -314,19 +376,78 @@ namespace enclave
             {
               case consensus::LedgerRequestPurpose::Recovery:
               {
-                if (node->is_verifying_snapshot())
-                {
-                  node->verify_snapshot_end();
-                }
-                else
+                recover_ledger_end();
+                break;
+              }
+              case consensus::LedgerRequestPurpose::HistoricalQuery:
+              {
+                context->historical_state_cache->handle_no_entry(index);
+                break;
+              }
+              default:
+              {
+                LOG_FAIL_FMT("Unhandled purpose: {}", purpose);
+              }
+            }
+          });
+
+        DISPATCHER_SET_MESSAGE_HANDLER(
+          bp,
+          consensus::ledger_durable,
+          [this](const uint8_t* data, size_t size) {
+            auto [idx] =
+              ringbuffer::read_message<consensus::ledger_durable>(data, size);
+            node->set_ledger_durable_idx(idx);
+          });
+
+        DISPATCHER_SET_MESSAGE_HANDLER(
+          bp,
+          consensus::ledger_entry_range,
+          [this](const uint8_t* data, size_t size) {
+            const auto [from_idx, to_idx, purpose, body] =
+              ringbuffer::read_message<consensus::ledger_entry_range>(
+                data, size);
+            switch (purpose)
+            {
+              case consensus::LedgerRequestPurpose::Recovery:
+              {
+                recover_ledger_entries(from_idx, to_idx, body);
+                break;
+              }
+              case consensus::LedgerRequestPurpose::HistoricalQuery:
+              {
+                context->historical_state_cache->handle_ledger_entries(
+                  from_idx, to_idx, body);
+                break;
+              }
+              default:
+              {
+                LOG_FAIL_FMT("Unhandled purpose: {}", purpose);
+              }
+            }
+          });
+
+        DISPATCHER_SET_MESSAGE_HANDLER(
+          bp,
+          consensus::ledger_no_entry_range,
+          [this](const uint8_t* data, size_t size) {
+            const auto [from_idx, to_idx, purpose] =
+              ringbuffer::read_message<consensus::ledger_no_entry_range>(
+                data, size);
+            switch (purpose)
+            {
+              case consensus::LedgerRequestPurpose::Recovery:
+              {
+                if (node->is_reading_ledger_idx(from_idx))
                 {
-                  node->recover_ledger_end();
+                  recover_ledger_end();
                 }
                 break;
               }
               case consensus::LedgerRequestPurpose::HistoricalQuery:
               {
-                context->historical_state_cache->handle_no_entry(index);
+                context->historical_state_cache->handle_no_entry_range(
+                  from_idx, to_idx);
                 break;
               }
               default:
@@ -360,11 +481,27 @@ namespace enclave
         // processed in a single iteration
         static constexpr size_t max_messages = 256;
 
+        // When idle, spin for idle_spins iterations, then block until the
+        // host writes to the ringbuffer or another thread adds a thread
+        // message for this thread, both of which ring the doorbell. idle_spins
+        // tracks twice the length of recent idle periods which ended while
+        // spinning, and shrinks each time the loop blocks. Where doorbells are
+        // not available (SGX), blocking sleeps for max_idle_wait.
+        static constexpr size_t min_idle_spins = 1 << 6;
+        static constexpr size_t max_idle_spins = 1 << 16;
+        static constexpr std::chrono::milliseconds max_idle_wait(50);
+        size_t idle_spins = 1 << 12;
+
+        auto& reader = circuit.read_from_outside();
+        auto& main_task = threading::ThreadMessaging::thread_messaging.get_task(
+          threading::ThreadMessaging::main_thread);
+        main_task.set_waker([&reader]() { reader.notify(); });
         size_t consecutive_idles = 0u;
+        bool waited = false;
         while (!bp.get_finished())
         {
           // First, read some messages from the ringbuffer
-          auto read = bp.read_n(max_messages, circuit.read_from_outside());
+          auto read = bp.read_n(max_messages, reader);
 
           // Then, execute some thread messages
           size_t thread_msg = 0;
@@ -378,31 +515,38 @@ namespace enclave
           // messages were executed, idle
           if (read == 0 && thread_msg == 0)
           {
-            const auto time_now = enclave::get_enclave_time();
-            static std::chrono::microseconds idling_start_time;
-
-            if (consecutive_idles == 0)
-            {
-              idling_start_time = time_now;
-            }
-
-            // Handle initial idles by pausing, eventually sleep (in host)
-            constexpr std::chrono::milliseconds timeout(5);
-            if ((time_now - idling_start_time) > timeout)
+            if (consecutive_idles < idle_spins)
             {
-              std::this_thread::sleep_for(timeout * 10);
+              CCF_PAUSE();
+              consecutive_idles++;
             }
             else
             {
-              CCF_PAUSE();
+              reader.prepare_wait();
+              if (reader.is_empty())
+              {
+                main_task.park_with([&]() { reader.wait(max_idle_wait); });
+              }
+              idle_spins =
+                std::max(min_idle_spins, idle_spins - idle_spins / 8);
+              waited = true;
             }
-
-            consecutive_idles++;
           }
           else
           {
+            // If work arrived while spinning, move idle_spins towards twice
+            // the length of this idle period
+            if (consecutive_idles > 0 && !waited)
+            {
+              const auto target =
+                std::min(2 * consecutive_idles, max_idle_spins);
+              idle_spins =
+                std::max(min_idle_spins, (7 * idle_spins + target) / 8);
+            }
+
             // If some messages were read, reset consecutive idles count
             consecutive_idles = 0;
+            waited = false;
           }
         }
 
@@ -13,6 +13,7 @@
 #include "ds/logger.h"
 #include "ds/oversized.h"
 #include "ds/ring_buffer_types.h"
+#include "ds/thread_messaging.h"
 #include "kv/kv_types.h"
 #include "node/members.h"
 #include "node/node_info_network.h"
@@ -47,8 +48,11 @@ struct CCFConfig
   ccf::NodeInfoNetwork node_info_network = {};
   std::string domain;
   size_t snapshot_tx_interval;
+  size_t snapshot_max_deltas;
   size_t max_open_sessions_soft;
   size_t max_open_sessions_hard;
+  threading::IdlePolicy worker_idle_policy;
+  size_t max_cached_verifiers;
 
   // Only if joining or recovering
   std::vector<uint8_t> startup_snapshot;
@@ -86,6 +90,9 @@ struct CCFConfig
   crypto::CurveID curve_id;
 };
 
+DECLARE_JSON_TYPE(threading::IdlePolicy);
+DECLARE_JSON_REQUIRED_FIELDS(threading::IdlePolicy, spins, pauses, park);
+
 DECLARE_JSON_TYPE(CCFConfig::SignatureIntervals);
 DECLARE_JSON_REQUIRED_FIELDS(
   CCFConfig::SignatureIntervals, sig_tx_interval, sig_ms_interval);
@@ -105,8 +112,11 @@ DECLARE_JSON_REQUIRED_FIELDS(
   node_info_network,
   domain,
   snapshot_tx_interval,
+  snapshot_max_deltas,
   max_open_sessions_soft,
   max_open_sessions_hard,
+  worker_idle_policy,
+  max_cached_verifiers,
   startup_snapshot,
   startup_snapshot_evidence_seqno,
   signature_intervals,
@@ -142,6 +142,9 @@ extern "C"
     reserved_memory = new uint8_t[ec->debug_config.memory_reserve_startup];
 #endif
 
+    threading::ThreadMessaging::thread_messaging.set_idle_policy(
+      cc.worker_idle_policy);
+
     auto enclave = new enclave::Enclave(
       ec, cc.signature_intervals, cc.consensus_config, cc.curve_id);
 
@@ -5,11 +5,13 @@
 #include "ccf/tx_id.h"
 #include "http/http_builder.h"
 #include "http/http_consts.h"
+#include "kv/kv_types.h"
 #include "node/client_signatures.h"
 #include "node/entities.h"
 #include "node/rpc/error.h"
 
 #include <llhttp/llhttp.h>
+#include <optional>
 #include <variant>
 #include <vector>
 
@@ -112,6 +114,24 @@ namespace enclave
     //
     bool is_forwarded = false;
 
+    //
+    // Cached by certificate-based authentication policies across the
+    // requests of this session, which are processed by a single thread
+    //
+    struct CertLookup
+    {
+      // State of the certificates table in which the caller was looked up
+      kv::MapStateVersion version;
+      bool found;
+    };
+
+    // Hex-encoded SHA-256 digests of caller_cert and of its public key
+    std::optional<std::string> caller_cert_digest = std::nullopt;
+    std::optional<std::string> caller_public_key_digest = std::nullopt;
+
+    std::optional<CertLookup> user_cert_lookup = std::nullopt;
+    std::optional<CertLookup> member_cert_lookup = std::nullopt;
+
     SessionContext(
       size_t client_session_id_, const std::vector<uint8_t>& caller_cert_) :
       client_session_id(client_session_id_),
@@ -2,6 +2,7 @@
 // Licensed under the Apache 2.0 License.
 #pragma once
 
+#include "ds/byte_queue.h"
 #include "ds/logger.h"
 #include "ds/messaging.h"
 #include "ds/ring_buffer.h"
@@ -48,10 +49,10 @@ namespace enclave
     }
 
   private:
-    std::vector<uint8_t> pending_write;
-    std::vector<uint8_t> pending_read;
+    ds::ByteQueue pending_write;
+    ds::ByteQueue pending_read;
     // Decrypted data, read through mbedtls
-    std::vector<uint8_t> read_buffer;
+    ds::ByteQueue read_buffer;
 
     std::unique_ptr<tls::Context> ctx;
     Status status;
@@ -139,11 +140,7 @@ namespace enclave
           "Have existing read_buffer of size: {}", read_buffer.size());
         offset = std::min(size, read_buffer.size());
         ::memcpy(data, read_buffer.data(), offset);
-
-        if (offset < read_buffer.size())
-          read_buffer.erase(read_buffer.begin(), read_buffer.begin() + offset);
-        else
-          read_buffer.clear();
+        read_buffer.consume(offset);
 
         if (offset == size)
           return size;
@@ -184,7 +181,7 @@ namespace enclave
 
           // May have read something but not enough - copy it into read_buffer
           // for next call
-          read_buffer.insert(read_buffer.end(), data, data + offset);
+          read_buffer.append(data, offset);
           return 0;
         }
 
@@ -209,7 +206,7 @@ namespace enclave
       {
         LOG_TRACE_FMT(
           "Asked for exactly {}, received {}, retrying", size, total);
-        read_buffer.insert(read_buffer.end(), data, data + total);
+        read_buffer.append(data, total);
         return read(data, size, exact);
       }
 
@@ -222,7 +219,7 @@ namespace enclave
       {
         throw std::runtime_error("Called recv_buffered from incorrect thread");
       }
-      pending_read.insert(pending_read.end(), data, data + size);
+      pending_read.append(data, size);
       do_handshake();
     }
 
@@ -262,14 +259,14 @@ namespace enclave
 
       if (status == handshake)
       {
-        pending_write.insert(pending_write.end(), data.begin(), data.end());
+        pending_write.append(data);
         return;
       }
 
       if (status != ready)
         return;
 
-      pending_write.insert(pending_write.end(), data.begin(), data.end());
+      pending_write.append(data);
 
       flush();
     }
@@ -281,7 +278,7 @@ namespace enclave
         throw std::runtime_error("Called send_buffered from incorrect thread");
       }
 
-      pending_write.insert(pending_write.end(), data.begin(), data.end());
+      pending_write.append(data);
     }
 
     void flush()
@@ -302,7 +299,7 @@ namespace enclave
 
         if (r > 0)
         {
-          pending_write.erase(pending_write.begin(), pending_write.begin() + r);
+          pending_write.consume(r);
         }
         else if (r == 0)
         {
@@ -459,7 +456,7 @@ namespace enclave
       }
     }
 
-    int write_some(const std::vector<uint8_t>& data)
+    int write_some(const ds::ByteQueue& data)
     {
       auto r = ctx->write(data.data(), data.size());
 
@@ -547,15 +544,7 @@ namespace enclave
         // writes a chunk larger than the size requested by the enclave.
         size_t rd = std::min(len, pending_read.size());
         ::memcpy(buf, pending_read.data(), rd);
-
-        if (rd >= pending_read.size())
-        {
-          pending_read.clear();
-        }
-        else
-        {
-          pending_read.erase(pending_read.begin(), pending_read.begin() + rd);
-        }
+        pending_read.consume(rd);
 
         return (int)rd;
       }
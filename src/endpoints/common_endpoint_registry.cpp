@@ -197,18 +197,23 @@ namespace ccf
       .install();
 
     auto endpoint_metrics_fn = [this](auto&, nlohmann::json&&) {
-      std::lock_guard<std::mutex> guard(metrics_lock);
       EndpointMetrics::Out out;
-      for (const auto& [path, verb_metrics] : metrics)
+      for (auto& [path, verb_metrics] : get_metrics())
       {
-        for (const auto& [verb, metric] : verb_metrics)
+        for (auto& [verb, metric] : verb_metrics)
         {
-          out.metrics.push_back({path,
-                                 verb,
-                                 metric.calls,
-                                 metric.errors,
-                                 metric.failures,
-                                 metric.retries});
+          const size_t setup_time_us = metric.setup_time.count();
+          out.metrics.push_back(
+            {path,
+             verb,
+             metric.calls,
+             metric.errors,
+             metric.failures,
+             metric.retries,
+             setup_time_us,
+             EndpointMetrics::Histogram::from(metric.execution_time),
+             EndpointMetrics::Histogram::from(metric.commit_time),
+             EndpointMetrics::Histogram::from(metric.retries_per_call)});
         }
       }
       return make_success(out);
@@ -69,14 +69,6 @@ namespace ccf::endpoints
     }
   }
 
-  EndpointRegistry::Metrics& EndpointRegistry::get_metrics_for_endpoint(
-    const EndpointDefinitionPtr& e)
-  {
-    auto method = e->dispatch.uri_path;
-    method = method.substr(method.find_first_not_of('/'));
-    return metrics[method][e->dispatch.verb.c_str()];
-  }
-
   Endpoint EndpointRegistry::make_endpoint(
     const std::string& method,
     RESTVerb verb,
@@ -149,6 +141,8 @@ namespace ccf::endpoints
       auto templated_endpoint =
         std::make_shared<PathTemplatedEndpoint>(endpoint);
       templated_endpoint->spec = std::move(template_spec.value());
+      templated_endpoints_router[endpoint.dispatch.verb].insert(
+        endpoint.dispatch.uri_path, templated_endpoint);
       templated_endpoints[endpoint.dispatch.uri_path][endpoint.dispatch.verb] =
         templated_endpoint;
     }
@@ -230,34 +224,24 @@ namespace ccf::endpoints
     {
       std::vector<EndpointDefinitionPtr> matches;
 
-      std::smatch match;
-      for (auto& [original_method, verb_endpoints] : templated_endpoints)
+      const auto router =
+        templated_endpoints_router.find(rpc_ctx.get_request_verb());
+      if (router != templated_endpoints_router.end())
       {
-        auto templated_endpoints_for_verb =
-          verb_endpoints.find(rpc_ctx.get_request_verb());
-        if (templated_endpoints_for_verb != verb_endpoints.end())
+        auto router_matches = router->second.match(method);
+        if (!router_matches.empty())
         {
-          auto& endpoint = templated_endpoints_for_verb->second;
-          if (std::regex_match(method, match, endpoint->spec.template_regex))
+          // Populate the request_path_params from the first match. If there
+          // are more, they are only used for error-reporting
+          auto& path_params = rpc_ctx.get_request_path_params();
+          for (auto& [name, value] : router_matches[0].params)
           {
-            // Populate the request_path_params the first-time through. If we
-            // get a second match, we're just building up a list for
-            // error-reporting
-            if (matches.size() == 0)
-            {
-              auto& path_params = rpc_ctx.get_request_path_params();
-              for (size_t i = 0;
-                   i < endpoint->spec.template_component_names.size();
-                   ++i)
-              {
-                const auto& template_name =
-                  endpoint->spec.template_component_names[i];
-                const auto& template_value = match[i + 1].str();
-                path_params[template_name] = template_value;
-              }
-            }
+            path_params[name] = std::move(value);
+          }
 
-            matches.push_back(endpoint);
+          for (const auto& match : router_matches)
+          {
+            matches.push_back(match.value);
           }
         }
       }
@@ -310,15 +294,11 @@ namespace ccf::endpoints
       }
     }
 
-    std::smatch match;
-    for (const auto& [original_method, verb_endpoints] : templated_endpoints)
+    for (const auto& [verb, router] : templated_endpoints_router)
     {
-      for (const auto& [verb, endpoint] : verb_endpoints)
+      if (!router.match(method).empty())
       {
-        if (std::regex_match(method, match, endpoint->spec.template_regex))
-        {
-          verbs.insert(verb);
-        }
+        verbs.insert(verb);
       }
     }
 
@@ -360,28 +340,71 @@ namespace ccf::endpoints
 
   void EndpointRegistry::increment_metrics_calls(const EndpointDefinitionPtr& e)
   {
-    std::lock_guard<std::mutex> guard(metrics_lock);
-    get_metrics_for_endpoint(e).calls++;
+    update_metrics_for_endpoint(e, [](Metrics& m) { m.calls++; });
   }
 
   void EndpointRegistry::increment_metrics_errors(
     const EndpointDefinitionPtr& e)
   {
-    std::lock_guard<std::mutex> guard(metrics_lock);
-    get_metrics_for_endpoint(e).errors++;
+    update_metrics_for_endpoint(e, [](Metrics& m) { m.errors++; });
   }
 
   void EndpointRegistry::increment_metrics_failures(
     const EndpointDefinitionPtr& e)
   {
-    std::lock_guard<std::mutex> guard(metrics_lock);
-    get_metrics_for_endpoint(e).failures++;
+    update_metrics_for_endpoint(e, [](Metrics& m) { m.failures++; });
   }
 
   void EndpointRegistry::increment_metrics_retries(
     const EndpointDefinitionPtr& e)
   {
-    std::lock_guard<std::mutex> guard(metrics_lock);
-    get_metrics_for_endpoint(e).retries++;
+    update_metrics_for_endpoint(e, [](Metrics& m) { m.retries++; });
+  }
+
+  void EndpointRegistry::add_metrics_setup_time(
+    const EndpointDefinitionPtr& e, std::chrono::microseconds setup_time)
+  {
+    update_metrics_for_endpoint(
+      e, [setup_time](Metrics& m) { m.setup_time += setup_time; });
+  }
+
+  void EndpointRegistry::record_metrics_execution_time(
+    const EndpointDefinitionPtr& e, std::chrono::microseconds execution_time)
+  {
+    update_metrics_for_endpoint(e, [execution_time](Metrics& m) {
+      m.execution_time.record(execution_time.count());
+    });
+  }
+
+  void EndpointRegistry::record_metrics_commit_time(
+    const EndpointDefinitionPtr& e, std::chrono::microseconds commit_time)
+  {
+    update_metrics_for_endpoint(e, [commit_time](Metrics& m) {
+      m.commit_time.record(commit_time.count());
+    });
+  }
+
+  void EndpointRegistry::record_metrics_retries_per_call(
+    const EndpointDefinitionPtr& e, size_t retries)
+  {
+    update_metrics_for_endpoint(
+      e, [retries](Metrics& m) { m.retries_per_call.record(retries); });
+  }
+
+  EndpointRegistry::MetricsByEndpoint EndpointRegistry::get_metrics()
+  {
+    MetricsByEndpoint merged;
+    for (auto& shard : metrics_shards)
+    {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      for (auto& [path, verb_metrics] : shard.metrics)
+      {
+        for (auto& [verb, metrics] : verb_metrics)
+        {
+          merged[path][verb].add(metrics);
+        }
+      }
+    }
+    return merged;
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,332 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#pragma once
+
+#define FMT_HEADER_ONLY
+#include <fmt/format.h>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ccf::endpoints
+{
+  /** A single segment of a templated path, between two '/'.
+   *
+   * The segment is made of literals interleaved with named path parameters,
+   * such that literals[0] {names[0]} literals[1] ... {names[n-1]} literals[n].
+   * A segment without parameters is a single literal, and a segment such as
+   * "{id}" is a single parameter surrounded by empty literals.
+   */
+  struct PathTemplateSegment
+  {
+    std::vector<std::string> literals;
+    std::vector<std::string> names;
+
+    bool is_literal() const
+    {
+      return names.empty();
+    }
+
+    bool is_parameter() const
+    {
+      return names.size() == 1 && literals[0].empty() && literals[1].empty();
+    }
+
+    /** Match text against this segment, appending the value of each of its
+     * parameters to values. Parameters match non-empty strings and, where
+     * several splits are possible, earlier parameters are as long as
+     * possible.
+     */
+    bool match(
+      std::string_view text, std::vector<std::string_view>& values) const
+    {
+      const auto& prefix = literals[0];
+      if (text.substr(0, prefix.size()) != prefix)
+      {
+        return false;
+      }
+      text.remove_prefix(prefix.size());
+
+      if (names.empty())
+      {
+        return text.empty();
+      }
+
+      return match_parameter(0, text, values);
+    }
+
+  private:
+    // Matches text against {names[i]} literals[i + 1] ... literals[n]
+    bool match_parameter(
+      size_t i,
+      std::string_view text,
+      std::vector<std::string_view>& values) const
+    {
+      const std::string_view next = literals[i + 1];
+
+      if (i + 1 == names.size())
+      {
+        if (
+          text.size() <= next.size() ||
+          text.substr(text.size() - next.size()) != next)
+        {
+          return false;
+        }
+        values.push_back(text.substr(0, text.size() - next.size()));
+        return true;
+      }
+
+      for (size_t len = text.size(); len > 0; --len)
+      {
+        auto rest = text.substr(len);
+        if (rest.substr(0, next.size()) == next)
+        {
+          values.push_back(text.substr(0, len));
+          rest.remove_prefix(next.size());
+          if (match_parameter(i + 1, rest, values))
+          {
+            return true;
+          }
+          values.pop_back();
+        }
+      }
+
+      return false;
+    }
+  };
+
+  /** Split a path template such as "/log/{id}" into its segments. Throws if a
+   * template is missing its closing '}'.
+   */
+  inline std::vector<PathTemplateSegment> parse_path_template_segments(
+    std::string_view uri)
+  {
+    std::vector<PathTemplateSegment> segments;
+
+    size_t segment_start = 0;
+    while (true)
+    {
+      PathTemplateSegment segment;
+      std::string literal;
+
+      size_t i = segment_start;
+      for (; i < uri.size() && uri[i] != '/'; ++i)
+      {
+        if (uri[i] == '{')
+        {
+          const auto template_end = uri.find_first_of('}', i);
+          if (template_end == std::string::npos)
+          {
+            throw std::logic_error(fmt::format(
+              "Invalid templated path - missing closing '}}': {}", uri));
+          }
+
+          segment.literals.push_back(std::move(literal));
+          literal.clear();
+          segment.names.emplace_back(uri.substr(i + 1, template_end - i - 1));
+          i = template_end;
+        }
+        else
+        {
+          literal.push_back(uri[i]);
+        }
+      }
+      segment.literals.push_back(std::move(literal));
+      segments.push_back(std::move(segment));
+
+      if (i == uri.size())
+      {
+        break;
+      }
+      segment_start = i + 1;
+    }
+
+    return segments;
+  }
+
+  /** Routes request paths to values registered for path templates.
+   *
+   * Templates are stored in a trie of segments, so that matching a path costs
+   * a walk over its segments rather than a match against each template. Each
+   * segment of a template is either a literal, which is looked up directly, a
+   * single parameter, shared by all templates with a parameter at that
+   * position, or a pattern mixing literals and parameters.
+   */
+  template <typename T>
+  class PathRouter
+  {
+  public:
+    using PathParams = std::map<std::string, std::string>;
+
+    struct Match
+    {
+      const T& value;
+      PathParams params;
+    };
+
+  private:
+    struct Route
+    {
+      std::vector<std::string> names;
+      T value;
+    };
+
+    struct Node
+    {
+      std::map<std::string, std::unique_ptr<Node>, std::less<>> literals;
+      std::unique_ptr<Node> parameter;
+      std::vector<std::pair<PathTemplateSegment, std::unique_ptr<Node>>>
+        patterns;
+      std::vector<Route> routes;
+    };
+
+    Node root;
+    size_t size_ = 0;
+
+    static std::vector<std::string_view> split_path(std::string_view path)
+    {
+      std::vector<std::string_view> segments;
+      while (true)
+      {
+        const auto segment_end = path.find_first_of('/');
+        segments.push_back(path.substr(0, segment_end));
+        if (segment_end == std::string_view::npos)
+        {
+          break;
+        }
+        path.remove_prefix(segment_end + 1);
+      }
+      return segments;
+    }
+
+    static void match_node(
+      const Node& node,
+      const std::vector<std::string_view>& segments,
+      size_t depth,
+      std::vector<std::string_view>& values,
+      std::vector<Match>& matches)
+    {
+      if (depth == segments.size())
+      {
+        for (const auto& route : node.routes)
+        {
+          PathParams params;
+          for (size_t i = 0; i < route.names.size(); ++i)
+          {
+            params[route.names[i]] = values[i];
+          }
+          matches.push_back({route.value, std::move(params)});
+        }
+        return;
+      }
+
+      const auto segment = segments[depth];
+
+      const auto literal = node.literals.find(segment);
+      if (literal != node.literals.end())
+      {
+        match_node(*literal->second, segments, depth + 1, values, matches);
+      }
+
+      if (node.parameter != nullptr && !segment.empty())
+      {
+        values.push_back(segment);
+        match_node(*node.parameter, segments, depth + 1, values, matches);
+        values.pop_back();
+      }
+
+      for (const auto& [pattern, child] : node.patterns)
+      {
+        const auto values_size = values.size();
+        if (pattern.match(segment, values))
+        {
+          match_node(*child, segments, depth + 1, values, matches);
+        }
+        values.resize(values_size);
+      }
+    }
+
+  public:
+    /** Register value for the given path template, replacing any value
+     * previously registered for it. Throws if the template is invalid.
+     */
+    void insert(std::string_view uri, T value)
+    {
+      Route route{{}, std::move(value)};
+      Node* node = &root;
+
+      for (auto& segment : parse_path_template_segments(uri))
+      {
+        std::unique_ptr<Node>* child = nullptr;
+        if (segment.is_literal())
+        {
+          child = &node->literals[segment.literals[0]];
+        }
+        else if (segment.is_parameter())
+        {
+          child = &node->parameter;
+        }
+        else
+        {
+          for (auto& [pattern, pattern_child] : node->patterns)
+          {
+            if (pattern.literals == segment.literals)
+            {
+              child = &pattern_child;
+              break;
+            }
+          }
+          if (child == nullptr)
+          {
+            node->patterns.emplace_back(segment, nullptr);
+            child = &node->patterns.back().second;
+          }
+        }
+
+        if (*child == nullptr)
+        {
+          *child = std::make_unique<Node>();
+        }
+        node = child->get();
+
+        for (auto& name : segment.names)
+        {
+          route.names.push_back(std::move(name));
+        }
+      }
+
+      // Templates reaching the same node with the same parameter names are
+      // identical, so the previous value is replaced
+      for (auto& existing : node->routes)
+      {
+        if (existing.names == route.names)
+        {
+          existing.value = std::move(route.value);
+          return;
+        }
+      }
+
+      node->routes.push_back(std::move(route));
+      ++size_;
+    }
+
+    /** Return the values of all templates matching path, with the values of
+     * their path parameters.
+     */
+    std::vector<Match> match(std::string_view path) const
+    {
+      std::vector<Match> matches;
+      std::vector<std::string_view> values;
+      match_node(root, split_path(path), 0, values, matches);
+      return matches;
+    }
+
+    size_t size() const
+    {
+      return size_;
+    }
+  };
+}
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "endpoints/path_router.h"
+
+#include <doctest/doctest.h>
+
+using namespace ccf::endpoints;
+
+TEST_CASE("Parse path templates")
+{
+  {
+    const auto segments = parse_path_template_segments("/app/log");
+    REQUIRE(segments.size() == 3);
+    REQUIRE(segments[0].is_literal());
+    REQUIRE(segments[1].is_literal());
+    REQUIRE(segments[1].literals[0] == "app");
+    REQUIRE(segments[2].literals[0] == "log");
+  }
+
+  {
+    const auto segments =
+      parse_path_template_segments("/log/{id}/v{major}.{minor}");
+    REQUIRE(segments.size() == 4);
+    REQUIRE(segments[2].is_parameter());
+    REQUIRE(segments[2].names == std::vector<std::string>{"id"});
+    REQUIRE(!segments[3].is_literal());
+    REQUIRE(!segments[3].is_parameter());
+    REQUIRE(segments[3].literals == std::vector<std::string>{"v", ".", ""});
+    REQUIRE(
+      segments[3].names == std::vector<std::string>{"major", "minor"});
+  }
+
+  REQUIRE_THROWS_AS(
+    parse_path_template_segments("/log/{id/foo"), std::logic_error);
+}
+
+TEST_CASE("Match path segments")
+{
+  std::vector<std::string_view> values;
+
+  const auto parameter = parse_path_template_segments("{a}")[0];
+  REQUIRE(parameter.match("foo", values));
+  REQUIRE(values == std::vector<std::string_view>{"foo"});
+  values.clear();
+  REQUIRE(!parameter.match("", values));
+
+  const auto pattern = parse_path_template_segments("{a}-{b}.json")[0];
+  REQUIRE(pattern.match("x-y-z.json", values));
+  // Earlier parameters are as long as possible
+  REQUIRE(values == std::vector<std::string_view>{"x-y", "z"});
+  values.clear();
+  REQUIRE(!pattern.match("x-.json", values));
+  REQUIRE(!pattern.match("x-yzjson", values));
+  REQUIRE(!pattern.match("xy.json", values));
+}
+
+TEST_CASE("Route paths")
+{
+  PathRouter<int> router;
+  router.insert("/log/{id}", 1);
+  router.insert("/log/{id}/history", 2);
+  router.insert("/log/private/{id}", 3);
+  router.insert("/log/{id}/{seqno}.json", 4);
+  router.insert("/users/{user_id}", 5);
+  router.insert("/users/{name}", 6);
+  REQUIRE(router.size() == 6);
+
+  {
+    const auto matches = router.match("/log/42");
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0].value == 1);
+    REQUIRE(matches[0].params.at("id") == "42");
+  }
+
+  {
+    const auto matches = router.match("/log/42/history");
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0].value == 2);
+    REQUIRE(matches[0].params.at("id") == "42");
+  }
+
+  {
+    const auto matches = router.match("/log/42/10.json");
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0].value == 4);
+    REQUIRE(matches[0].params.at("id") == "42");
+    REQUIRE(matches[0].params.at("seqno") == "10");
+  }
+
+  {
+    // Literal and templated segments may both match
+    const auto matches = router.match("/log/private/42");
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0].value == 3);
+
+    REQUIRE(router.match("/log/private").size() == 1);
+  }
+
+  {
+    // Templates which differ only by their parameter names are ambiguous
+    const auto matches = router.match("/users/alice");
+    REQUIRE(matches.size() == 2);
+    REQUIRE(matches[0].params.at("user_id") == "alice");
+    REQUIRE(matches[1].params.at("name") == "alice");
+  }
+
+  {
+    // Inserting an existing template replaces its value
+    router.insert("/log/{id}/history", 7);
+    REQUIRE(router.size() == 6);
+    const auto matches = router.match("/log/42/history");
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0].value == 7);
+  }
+
+  REQUIRE(router.match("/log").empty());
+  REQUIRE(router.match("/log/").empty());
+  REQUIRE(router.match("/log/42/history/").empty());
+  REQUIRE(router.match("/log/42/10.txt").empty());
+  REQUIRE(router.match("/unknown/42").empty());
+}
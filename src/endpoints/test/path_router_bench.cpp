@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#define PICOBENCH_IMPLEMENT_WITH_MAIN
+#include "endpoints/path_router.h"
+
+#include <picobench/picobench.hpp>
+#include <regex>
+
+using namespace ccf::endpoints;
+
+template <class A>
+inline void do_not_optimize(A const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber_memory()
+{
+  asm volatile("" : : : "memory");
+}
+
+// Routes resembling those of a typical app, with a mix of literal, parameter
+// and pattern segments
+static std::vector<std::string> make_templates(size_t n)
+{
+  std::vector<std::string> templates;
+  for (size_t i = 0; i < n; ++i)
+  {
+    switch (i % 3)
+    {
+      case 0:
+        templates.push_back(fmt::format("/app/resource_{}/{{id}}", i));
+        break;
+      case 1:
+        templates.push_back(
+          fmt::format("/app/resource_{}/{{id}}/items/{{item_id}}", i));
+        break;
+      case 2:
+        templates.push_back(
+          fmt::format("/app/resource_{}/{{id}}/v{{major}}.{{minor}}", i));
+        break;
+    }
+  }
+  return templates;
+}
+
+static std::vector<std::string> make_paths(size_t n)
+{
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < n; ++i)
+  {
+    switch (i % 3)
+    {
+      case 0:
+        paths.push_back(fmt::format("/app/resource_{}/42", i));
+        break;
+      case 1:
+        paths.push_back(fmt::format("/app/resource_{}/42/items/abc", i));
+        break;
+      case 2:
+        paths.push_back(fmt::format("/app/resource_{}/42/v1.2", i));
+        break;
+    }
+  }
+  return paths;
+}
+
+// Matches each template's regex in turn, as EndpointRegistry used to
+template <size_t N>
+static void match_regex(picobench::state& s)
+{
+  std::vector<std::regex> regexes;
+  for (const auto& t : make_templates(N))
+  {
+    regexes.emplace_back(std::regex_replace(
+      t, std::regex("\\{[^}]*\\}"), std::string("([^/]+)")));
+  }
+  const auto paths = make_paths(N);
+
+  size_t i = 0;
+  s.start_timer();
+  for (auto _ : s)
+  {
+    (void)_;
+    const auto& path = paths[i++ % paths.size()];
+    size_t matches = 0;
+    std::smatch match;
+    for (const auto& regex : regexes)
+    {
+      if (std::regex_match(path, match, regex))
+      {
+        ++matches;
+      }
+    }
+    do_not_optimize(matches);
+    clobber_memory();
+  }
+  s.stop_timer();
+}
+
+template <size_t N>
+static void match_router(picobench::state& s)
+{
+  PathRouter<size_t> router;
+  const auto templates = make_templates(N);
+  for (size_t i = 0; i < templates.size(); ++i)
+  {
+    router.insert(templates[i], i);
+  }
+  const auto paths = make_paths(N);
+
+  size_t i = 0;
+  s.start_timer();
+  for (auto _ : s)
+  {
+    (void)_;
+    auto matches = router.match(paths[i++ % paths.size()]);
+    do_not_optimize(matches);
+    clobber_memory();
+  }
+  s.stop_timer();
+}
+
+const std::vector<int> match_counts = {1000, 10000};
+
+PICOBENCH_SUITE("match 100 routes");
+PICOBENCH(match_regex<100>).iterations(match_counts).baseline();
+PICOBENCH(match_router<100>).iterations(match_counts);
+
+PICOBENCH_SUITE("match 500 routes");
+PICOBENCH(match_regex<500>).iterations(match_counts).baseline();
+PICOBENCH(match_router<500>).iterations(match_counts);
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#pragma once
+
+#include "ds/ring_buffer.h"
+#include "proxy.h"
+
+namespace asynchost
+{
+  /**
+   * Calls Behaviour::on_doorbell() from the event loop whenever the doorbell
+   * of a ringbuffer is rung, so that the host can read messages as soon as
+   * they are written rather than on its next tick.
+   */
+  template <typename Behaviour>
+  class Doorbell : public with_uv_handle<uv_poll_t>
+  {
+  public:
+    Behaviour behaviour;
+
+  private:
+    friend class close_ptr<Doorbell<Behaviour>>;
+
+    ringbuffer::Doorbell& doorbell;
+
+    template <typename... Args>
+    Doorbell(ringbuffer::Doorbell& doorbell, Args&&... args) :
+      behaviour(std::forward<Args>(args)...),
+      doorbell(doorbell)
+    {
+      int rc;
+
+      if ((rc = uv_poll_init(uv_default_loop(), &uv_handle, doorbell.fd)) < 0)
+      {
+        LOG_FAIL_FMT("uv_poll_init failed: {}", uv_strerror(rc));
+        throw std::logic_error("uv_poll_init failed");
+      }
+
+      uv_handle.data = this;
+
+      if ((rc = uv_poll_start(&uv_handle, UV_READABLE, on_poll)) < 0)
+      {
+        LOG_FAIL_FMT("uv_poll_start failed: {}", uv_strerror(rc));
+        throw std::logic_error("uv_poll_start failed");
+      }
+    }
+
+    static void on_poll(uv_poll_t* handle, int status, int)
+    {
+      if (status < 0)
+      {
+        LOG_FAIL_FMT("uv_poll failed: {}", uv_strerror(status));
+        return;
+      }
+
+      static_cast<Doorbell*>(handle->data)->on_poll();
+    }
+
+    void on_poll()
+    {
+      ringbuffer::doorbell::clear(doorbell);
+      behaviour.on_doorbell();
+    }
+  };
+}
@@ -5,6 +5,7 @@
 #include "../ds/files.h"
 #include "../ds/logger.h"
 #include "../enclave/interface.h"
+#include "doorbell.h"
 #include "timer.h"
 
 #include <chrono>
@@ -77,8 +78,22 @@ namespace asynchost
 
     void on_timer()
     {
-      // Regularly read (and process) some outbound ringbuffer messages...
-      bp.read_n(max_messages, r);
+      process();
+    }
+
+    void process()
+    {
+      // Ask the enclave to ring the doorbell when it next writes a message.
+      // Messages written before this are read now...
+      r.prepare_wait();
+
+      // ...read (and process) some outbound ringbuffer messages...
+      if (bp.read_n(max_messages, r) == max_messages)
+      {
+        // ...ringing the doorbell ourselves if there may be more, so that
+        // they are read on the next iteration of the loop...
+        r.notify();
+      }
 
       // ...flush any pending inbound messages...
       nbwf.flush_all_inbound();
@@ -86,4 +101,25 @@ namespace asynchost
   };
 
   using HandleRingbuffer = proxy_ptr<Timer<HandleRingbufferImpl>>;
+
+  // Processes outbound ringbuffer messages as soon as the enclave writes them,
+  // in addition to the regular ticks of HandleRingbuffer, which remain for
+  // enclaves that cannot ring doorbells
+  class RingbufferDoorbellImpl
+  {
+  private:
+    HandleRingbuffer handle_ringbuffer;
+
+  public:
+    RingbufferDoorbellImpl(HandleRingbuffer& handle_ringbuffer) :
+      handle_ringbuffer(handle_ringbuffer)
+    {}
+
+    void on_doorbell()
+    {
+      handle_ringbuffer->behaviour.process();
+    }
+  };
+
+  using RingbufferDoorbell = proxy_ptr<Doorbell<RingbufferDoorbellImpl>>;
 }
@@ -6,15 +6,26 @@
 #include "ds/logger.h"
 #include "ds/messaging.h"
 #include "ds/nonstd.h"
+#include "ds/serializer.h"
 #include "kv/serialised_entry_format.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
 #include <filesystem>
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
+#include <sys/mman.h>
 #include <sys/types.h>
+#include <thread>
 #include <unistd.h>
 #include <vector>
 
@@ -24,10 +35,35 @@ namespace asynchost
 {
   static constexpr size_t ledger_max_read_cache_files_default = 5;
 
+  // Ledger entries are made durable (fdatasync) in the background once this
+  // many bytes have been written since the last sync, or once the sync
+  // interval has elapsed, whichever comes first
+  static constexpr size_t ledger_sync_threshold_bytes_default = 1 << 20;
+  static constexpr std::chrono::milliseconds ledger_sync_interval_default{10};
+
+  // Number of chunk files created and allocated ahead of time, so that new
+  // chunks can be started without creating and growing a file
+  static constexpr size_t ledger_chunk_pool_size_default = 2;
+
+  // Maximum number of threads used to open existing ledger files on startup
+  static constexpr size_t ledger_recovery_max_threads = 8;
+
+  // Maximum size of the framed entries sent to the enclave in a single
+  // ledger_entry_range message. This should remain well below the maximum
+  // ringbuffer message size.
+  static constexpr size_t ledger_max_entries_range_size_default = 1 << 22;
+
+  // Maximum size of the most recently written ledger entries kept in memory,
+  // and of each block of contiguous entries they are kept in
+  static constexpr size_t ledger_tail_cache_size_default = 1 << 24;
+  static constexpr size_t ledger_tail_cache_block_size = 1 << 20;
+
   static constexpr auto ledger_committed_suffix = "committed";
   static constexpr auto ledger_start_idx_delimiter = "_";
   static constexpr auto ledger_last_idx_delimiter = "-";
   static constexpr auto ledger_corrupt_file_suffix = "corrupted";
+  static constexpr auto ledger_preallocated_file_prefix = "preallocated";
+  static constexpr auto ledger_index_file_suffix = "index";
 
   static inline bool is_ledger_file_committed(const std::string& file_name)
   {
@@ -70,6 +106,27 @@ namespace asynchost
     return nonstd::ends_with(file_name, ledger_corrupt_file_suffix);
   }
 
+  static inline bool is_ledger_file_preallocated(const std::string& file_name)
+  {
+    return nonstd::starts_with(file_name, ledger_preallocated_file_prefix);
+  }
+
+  static inline bool is_ledger_index_file(const std::string& file_name)
+  {
+    return nonstd::ends_with(
+      file_name, fmt::format(".{}", ledger_index_file_suffix));
+  }
+
+  // Record of the index file written alongside each ledger file, one per
+  // entry, so that the positions of the entries of incomplete files can be
+  // recovered without reading all entries
+  struct LedgerIndexRecord
+  {
+    consensus::Term term;
+    uint32_t position;
+    uint32_t size;
+  };
+
   std::optional<std::string> get_file_name_with_idx(
     const std::string& dir, size_t idx)
   {
@@ -124,9 +181,227 @@ namespace asynchost
     size_t total_len = 0;
     std::vector<uint32_t> positions;
 
+    // Term of each entry (0 if unknown), recorded in the index file along with
+    // the position of each entry. Only the records of the first
+    // indexed_entries entries have been written to the index file.
+    std::vector<consensus::Term> terms;
+    size_t indexed_entries = 0;
+
     bool completed = false;
     bool committed = false;
 
+    // True if the space for this file was allocated when it was created
+    bool preallocated = false;
+
+    // Read-only mapping of the entries of committed and completed files, which
+    // are immutable. Positions are offsets into this mapping.
+    const uint8_t* mapped_data = nullptr;
+    size_t mapped_size = 0;
+
+    void map_entries()
+    {
+      if (total_len == 0)
+      {
+        return;
+      }
+
+      auto data =
+        mmap(nullptr, total_len, PROT_READ, MAP_SHARED, fileno(file), 0);
+      if (data == MAP_FAILED)
+      {
+        // Entries are read from the file instead
+        LOG_FAIL_FMT(
+          "Could not map ledger file {}: {}", file_name, strerror(errno));
+        return;
+      }
+
+      mapped_data = static_cast<const uint8_t*>(data);
+      mapped_size = total_len;
+    }
+
+    fs::path get_index_file_path() const
+    {
+      return fs::path(dir) /
+        fs::path(fmt::format(
+          "{}_{}.{}", file_name_prefix, start_idx, ledger_index_file_suffix));
+    }
+
+    std::vector<LedgerIndexRecord> read_index_records() const
+    {
+      std::vector<LedgerIndexRecord> records;
+      auto f = fopen(get_index_file_path().c_str(), "rb");
+      if (!f)
+      {
+        return records;
+      }
+
+      fseeko(f, 0, SEEK_END);
+      records.resize(ftello(f) / sizeof(LedgerIndexRecord));
+      fseeko(f, 0, SEEK_SET);
+      if (
+        fread(records.data(), sizeof(LedgerIndexRecord), records.size(), f) !=
+        records.size())
+      {
+        records.clear();
+      }
+      fclose(f);
+      return records;
+    }
+
+    // Recovers the positions of the entries of an incomplete file from its
+    // index file, stopping at the first record inconsistent with the file.
+    // Returns the offset of the end of the last recovered entry.
+    size_t recover_indexed_positions()
+    {
+      size_t pos = sizeof(positions_offset_header_t);
+      for (const auto& record : read_index_records())
+      {
+        if (
+          record.position != pos ||
+          record.size < kv::serialised_entry_header_size ||
+          record.size > total_len - pos)
+        {
+          break;
+        }
+        positions.push_back(pos);
+        terms.push_back(record.term);
+        pos += record.size;
+      }
+
+      if (positions.empty())
+      {
+        return pos;
+      }
+
+      // Records may be written before the entries reach the disk, so the
+      // last recovered entry is checked against its header. Otherwise, all
+      // entries are read again.
+      kv::SerialisedEntryHeader entry_header;
+      if (
+        pread(
+          fileno(file),
+          &entry_header,
+          kv::serialised_entry_header_size,
+          positions.back()) !=
+          static_cast<ssize_t>(kv::serialised_entry_header_size) ||
+        kv::serialised_entry_header_size + entry_header.size !=
+          pos - positions.back())
+      {
+        LOG_FAIL_FMT("Ignoring stale index of ledger file {}", file_name);
+        positions.clear();
+        terms.clear();
+        return sizeof(positions_offset_header_t);
+      }
+
+      return pos;
+    }
+
+    // Recovers the terms of the entries of a completed file from its index
+    // file
+    void recover_indexed_terms()
+    {
+      for (const auto& record : read_index_records())
+      {
+        if (
+          terms.size() == positions.size() ||
+          record.position != positions.at(terms.size()))
+        {
+          break;
+        }
+        terms.push_back(record.term);
+      }
+    }
+
+    // Writes the index records of the entries written since the last call.
+    // As the index is only used to speed up recovery, failures are not fatal.
+    void write_index()
+    {
+      if (indexed_entries == positions.size())
+      {
+        return;
+      }
+
+      std::vector<LedgerIndexRecord> records;
+      records.reserve(positions.size() - indexed_entries);
+      for (size_t i = indexed_entries; i < positions.size(); ++i)
+      {
+        const auto end =
+          (i + 1 < positions.size()) ? positions.at(i + 1) : total_len;
+        records.push_back({terms.at(i),
+                           positions.at(i),
+                           static_cast<uint32_t>(end - positions.at(i))});
+      }
+
+      const auto index_file_path = get_index_file_path();
+      auto fd = open(index_file_path.c_str(), O_WRONLY | O_CREAT, 0666);
+      if (fd == -1)
+      {
+        LOG_FAIL_FMT(
+          "Unable to open ledger index file {}: {}",
+          index_file_path,
+          strerror(errno));
+        return;
+      }
+
+      const auto offset = indexed_entries * sizeof(LedgerIndexRecord);
+      const auto len = records.size() * sizeof(LedgerIndexRecord);
+      if (
+        pwrite(fd, records.data(), len, offset) == static_cast<ssize_t>(len) &&
+        ftruncate(fd, offset + len) == 0)
+      {
+        indexed_entries = positions.size();
+      }
+      else
+      {
+        LOG_FAIL_FMT(
+          "Failed to write ledger index file {}: {}",
+          index_file_path,
+          strerror(errno));
+      }
+      close(fd);
+    }
+
+    void remove_index()
+    {
+      std::error_code ec;
+      fs::remove(get_index_file_path(), ec);
+      indexed_entries = 0;
+    }
+
+    // Rebuilds the positions table from the headers of the entries in data,
+    // which contains the bytes of the file from offset from to total_len
+    void recover_positions(
+      const uint8_t* data, size_t from, const fs::path& file_path)
+    {
+      auto len = total_len - from;
+      size_t pos = from;
+      kv::SerialisedEntryHeader entry_header;
+
+      while (len >= kv::serialised_entry_header_size)
+      {
+        std::memcpy(
+          &entry_header, data + (pos - from), kv::serialised_entry_header_size);
+        len -= kv::serialised_entry_header_size;
+
+        const auto& entry_size = entry_header.size;
+        if (len < entry_size)
+        {
+          throw std::logic_error(fmt::format(
+            "Malformed incomplete ledger file {} (expecting entry of size "
+            "{}, remaining {})",
+            file_path,
+            entry_size,
+            len));
+        }
+
+        len -= entry_size;
+
+        positions.push_back(pos);
+        terms.push_back(0);
+        pos += (kv::serialised_entry_header_size + entry_size);
+      }
+    }
+
   public:
     // Used when creating a new (empty) ledger file
     LedgerFile(const std::string& dir, size_t start_idx) :
@@ -145,6 +420,73 @@ namespace asynchost
       // Header reserved for the offset to the position table
       fseeko(file, sizeof(positions_offset_header_t), SEEK_SET);
       total_len = sizeof(positions_offset_header_t);
+
+      // Index of a previous file with the same start idx (e.g. corrupted)
+      remove_index();
+    }
+
+    // Used when starting a new (empty) ledger file from a file created by
+    // preallocate()
+    LedgerFile(
+      const std::string& dir,
+      size_t start_idx,
+      const std::string& preallocated_file_name) :
+      dir(dir),
+      file_name(fmt::format("{}_{}", file_name_prefix, start_idx)),
+      start_idx(start_idx),
+      preallocated(true)
+    {
+      auto file_path = fs::path(dir) / fs::path(file_name);
+      fs::rename(fs::path(dir) / fs::path(preallocated_file_name), file_path);
+
+      file = fopen(file_path.c_str(), "r+b");
+      if (!file)
+      {
+        throw std::logic_error(fmt::format(
+          "Unable to open ledger file {}: {}", file_path, strerror(errno)));
+      }
+
+      // Header is already reserved for the offset to the position table
+      fseeko(file, sizeof(positions_offset_header_t), SEEK_SET);
+      total_len = sizeof(positions_offset_header_t);
+
+      remove_index();
+    }
+
+    // Creates an empty ledger file, to be started later, for which size bytes
+    // are allocated upfront. The file size is not changed by the allocation so
+    // that, as for any other ledger file, it only covers written entries.
+    static bool preallocate(
+      const std::string& dir, const std::string& file_name, size_t size)
+    {
+      auto file_path = fs::path(dir) / fs::path(file_name);
+      auto f = fopen(file_path.c_str(), "w+b");
+      if (!f)
+      {
+        LOG_FAIL_FMT(
+          "Unable to create ledger file {}: {}", file_path, strerror(errno));
+        return false;
+      }
+
+      positions_offset_header_t table_offset = 0;
+      bool created = fwrite(&table_offset, sizeof(table_offset), 1, f) == 1 &&
+        fflush(f) == 0;
+      if (created && fallocate(fileno(f), FALLOC_FL_KEEP_SIZE, 0, size) != 0)
+      {
+        // Not all file systems support allocation. The file is still usable
+        // and grows as entries are written to it.
+        LOG_DEBUG_FMT(
+          "Could not allocate ledger file {}: {}", file_path, strerror(errno));
+      }
+      fclose(f);
+
+      if (!created)
+      {
+        LOG_FAIL_FMT("Unable to initialise ledger file {}", file_path);
+        std::error_code ec;
+        fs::remove(file_path, ec);
+      }
+      return created;
     }
 
     // Used when recovering an existing ledger file
@@ -196,52 +538,70 @@ namespace asynchost
             "Failed to read positions table from ledger file {}", file_path));
         }
         completed = true;
+
+        recover_indexed_terms();
+        indexed_entries = terms.size();
+        terms.resize(positions.size(), 0);
       }
       else
       {
-        // If the chunk was not completed, read all entries to reconstruct
-        // positions table
+        // If the chunk was not completed, the positions of the entries are
+        // recovered from the index file. Only the headers of the entries
+        // written after the last index record are read to reconstruct the
+        // rest of the positions table, from a mapping of the file (or, failing
+        // that, from a single read) rather than with one read per entry.
         total_len = total_file_size;
+        const auto indexed_len = recover_indexed_positions();
+        indexed_entries = positions.size();
 
-        auto len = total_len - sizeof(positions_offset_header_t);
-        size_t pos = sizeof(positions_offset_header_t);
-        kv::SerialisedEntryHeader entry_header;
-
-        while (len >= kv::serialised_entry_header_size)
+        if (indexed_len < total_file_size)
         {
-          if (
-            fread(&entry_header, kv::serialised_entry_header_size, 1, file) !=
-            1)
+          auto mapped = mmap(
+            nullptr, total_file_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+          if (mapped != MAP_FAILED)
           {
-            throw std::logic_error(fmt::format(
-              "Failed to read frame from ledger file {}", file_path));
+            try
+            {
+              recover_positions(
+                static_cast<const uint8_t*>(mapped) + indexed_len,
+                indexed_len,
+                file_path);
+            }
+            catch (const std::exception& e)
+            {
+              munmap(mapped, total_file_size);
+              throw;
+            }
+            munmap(mapped, total_file_size);
           }
-
-          len -= kv::serialised_entry_header_size;
-
-          const auto& entry_size = entry_header.size;
-          if (len < entry_size)
+          else
           {
-            throw std::logic_error(fmt::format(
-              "Malformed incomplete ledger file {} (expecting entry of size "
-              "{}, remaining {})",
-              file_path,
-              entry_size,
-              len));
+            std::vector<uint8_t> data(total_file_size - indexed_len);
+            fseeko(file, indexed_len, SEEK_SET);
+            if (fread(data.data(), data.size(), 1, file) != 1)
+            {
+              throw std::logic_error(
+                fmt::format("Failed to read ledger file {}", file_path));
+            }
+            recover_positions(data.data(), indexed_len, file_path);
           }
-
-          fseeko(file, entry_size, SEEK_CUR);
-          len -= entry_size;
-
-          positions.push_back(pos);
-          pos += (kv::serialised_entry_header_size + entry_size);
         }
         completed = false;
       }
+
+      if (committed && completed)
+      {
+        map_entries();
+      }
     }
 
     ~LedgerFile()
     {
+      if (mapped_data != nullptr)
+      {
+        munmap(const_cast<uint8_t*>(mapped_data), mapped_size);
+      }
+
       if (file)
       {
         fclose(file);
@@ -273,10 +633,15 @@ namespace asynchost
       return completed;
     }
 
-    size_t write_entry(const uint8_t* data, size_t size, bool committable)
+    size_t write_entry(
+      const uint8_t* data,
+      size_t size,
+      bool committable,
+      consensus::Term term)
     {
       fseeko(file, total_len, SEEK_SET);
       positions.push_back(total_len);
+      terms.push_back(term);
       size_t new_idx = get_last_idx();
 
       if (fwrite(data, size, 1, file) != 1)
@@ -314,6 +679,94 @@ namespace asynchost
       }
     }
 
+    // Returns the last index in [from, to] such that the framed entries from
+    // from to that index do not exceed max_size bytes. At least one entry is
+    // always included, even if it is larger than max_size.
+    size_t get_last_idx_within_size(
+      size_t from, size_t to, size_t max_size) const
+    {
+      size_t lo = from;
+      size_t hi = to;
+      while (lo < hi)
+      {
+        const auto mid = lo + (hi - lo + 1) / 2;
+        if (framed_entries_size(from, mid) <= max_size)
+        {
+          lo = mid;
+        }
+        else
+        {
+          hi = mid - 1;
+        }
+      }
+      return lo;
+    }
+
+    // Returns the term of the entry at idx, if known
+    std::optional<consensus::Term> get_term(size_t idx) const
+    {
+      if ((idx < start_idx) || (idx > get_last_idx()))
+      {
+        return std::nullopt;
+      }
+
+      auto term = terms.at(idx - start_idx);
+      if (term == 0)
+      {
+        return std::nullopt;
+      }
+      return term;
+    }
+
+    void flush()
+    {
+      if (fflush(file) != 0)
+      {
+        throw std::logic_error(
+          fmt::format("Failed to flush ledger file: {}", strerror(errno)));
+      }
+
+      // Index records are written once the entries they refer to have been
+      // flushed
+      write_index();
+    }
+
+    // Makes all previously flushed entries durable. This does not touch the
+    // stdio buffer, so it can be called from a different thread than the
+    // writer, as long as flush() was called first.
+    bool sync() const
+    {
+      if (fdatasync(fileno(file)) != 0)
+      {
+        LOG_FAIL_FMT(
+          "Failed to sync ledger file {}: {}", file_name, strerror(errno));
+        return false;
+      }
+      return true;
+    }
+
+    bool is_mapped() const
+    {
+      return mapped_data != nullptr;
+    }
+
+    // Returns a view of the framed entries from from to to in the read-only
+    // mapping of the file, without copying them. Only available for mapped
+    // files.
+    std::optional<serializer::ByteRange> get_mapped_framed_entries(
+      size_t from, size_t to) const
+    {
+      if (
+        !is_mapped() || (from < start_idx) || (to > get_last_idx()) ||
+        (to < from))
+      {
+        return std::nullopt;
+      }
+
+      return serializer::ByteRange{mapped_data + positions.at(from - start_idx),
+                                   framed_entries_size(from, to)};
+    }
+
     std::optional<std::vector<uint8_t>> read_entry(size_t idx) const
     {
       if ((idx < start_idx) || (idx > get_last_idx()))
@@ -321,6 +774,13 @@ namespace asynchost
         return std::nullopt;
       }
 
+      auto mapped = get_mapped_framed_entries(idx, idx);
+      if (mapped.has_value())
+      {
+        return std::vector<uint8_t>(
+          mapped->data, mapped->data + mapped->size);
+      }
+
       auto len = framed_entries_size(idx, idx);
       std::vector<uint8_t> entry(len);
       fseeko(file, positions.at(idx - start_idx), SEEK_SET);
@@ -343,6 +803,13 @@ namespace asynchost
         return std::nullopt;
       }
 
+      auto mapped = get_mapped_framed_entries(from, to);
+      if (mapped.has_value())
+      {
+        return std::vector<uint8_t>(
+          mapped->data, mapped->data + mapped->size);
+      }
+
       auto framed_size = framed_entries_size(from, to);
       std::vector<uint8_t> framed_entries(framed_size);
       fseeko(file, positions.at(from - start_idx), SEEK_SET);
@@ -371,9 +838,27 @@ namespace asynchost
           throw std::logic_error(
             fmt::format("Could not remove file {}", file_name));
         }
+        remove_index();
         return true;
       }
 
+      // Records of truncated entries are removed from the index file first,
+      // so that it never refers to entries which are not in the file
+      const auto truncated_entries = idx - start_idx + 1;
+      indexed_entries = std::min(indexed_entries, truncated_entries);
+      if (
+        ::truncate(
+          get_index_file_path().c_str(),
+          indexed_entries * sizeof(LedgerIndexRecord)) != 0 &&
+        errno != ENOENT)
+      {
+        LOG_FAIL_FMT(
+          "Failed to truncate ledger index file of {}, removing it: {}",
+          file_name,
+          strerror(errno));
+        remove_index();
+      }
+
       // Reset positions offset header
       fseeko(file, 0, SEEK_SET);
       positions_offset_header_t table_offset = 0;
@@ -383,8 +868,9 @@ namespace asynchost
       }
 
       completed = false;
-      total_len = positions.at(idx - start_idx + 1);
-      positions.resize(idx - start_idx + 1);
+      total_len = positions.at(truncated_entries);
+      positions.resize(truncated_entries);
+      terms.resize(truncated_entries);
 
       if (fflush(file) != 0)
       {
@@ -428,66 +914,502 @@ namespace asynchost
         throw std::logic_error("Failed to set file offset to 0");
       }
 
-      if (fwrite(&table_offset, sizeof(table_offset), 1, file) != 1)
+      if (fwrite(&table_offset, sizeof(table_offset), 1, file) != 1)
+      {
+        throw std::logic_error("Failed to write positions table to ledger");
+      }
+
+      if (fflush(file) != 0)
+      {
+        throw std::logic_error(
+          fmt::format("Failed to flush ledger file: {}", strerror(errno)));
+      }
+
+      // Release the space allocated beyond the end of the positions table
+      if (
+        preallocated &&
+        ftruncate(
+          fileno(file),
+          table_offset + positions.size() * sizeof(positions.at(0))) != 0)
+      {
+        LOG_FAIL_FMT(
+          "Failed to release unused space of ledger file {}: {}",
+          file_name,
+          strerror(errno));
+      }
+
+      write_index();
+      completed = true;
+    }
+
+    bool commit(size_t idx)
+    {
+      if (!completed || committed || (idx != get_last_idx()))
+      {
+        // No effect if commit idx is not last idx
+        return false;
+      }
+
+      if (fflush(file) != 0)
+      {
+        throw std::logic_error(
+          fmt::format("Failed to flush ledger file: {}", strerror(errno)));
+      }
+
+      const auto committed_file_name = fmt::format(
+        "{}_{}-{}.{}",
+        file_name_prefix,
+        start_idx,
+        get_last_idx(),
+        ledger_committed_suffix);
+
+      auto file_path = fs::path(dir) / fs::path(file_name);
+      auto committed_file_path = fs::path(dir) / fs::path(committed_file_name);
+
+      std::error_code ec;
+      fs::rename(file_path, committed_file_path, ec);
+      if (ec)
+      {
+        // Even if the file cannot be renamed (e.g. file was removed), report an
+        // error and continue
+        LOG_FAIL_FMT(
+          "Could not rename committed ledger file {} to {}",
+          file_path,
+          committed_file_path);
+      }
+      else
+      {
+        file_name = committed_file_name;
+        committed = true;
+        LOG_DEBUG_FMT("Committed ledger file {}", file_name);
+      }
+
+      return true;
+    }
+  };
+
+  // Creates and allocates chunk files on a dedicated thread, so that starting
+  // a new ledger chunk only requires renaming one of these files
+  class LedgerChunkPool
+  {
+  private:
+    const std::string dir;
+    const size_t pool_size;
+    const size_t chunk_size;
+
+    std::mutex lock;
+    std::condition_variable cv;
+    std::deque<std::string> ready_files;
+    size_t next_file_id = 0;
+    bool stop = false;
+    std::thread thread;
+
+    void run()
+    {
+      while (true)
+      {
+        std::string file_name;
+        {
+          std::unique_lock<std::mutex> guard(lock);
+          cv.wait(
+            guard, [this]() { return stop || ready_files.size() < pool_size; });
+          if (stop)
+          {
+            return;
+          }
+          file_name = fmt::format(
+            "{}_{}", ledger_preallocated_file_prefix, next_file_id++);
+        }
+
+        if (!LedgerFile::preallocate(dir, file_name, chunk_size))
+        {
+          LOG_FAIL_FMT("Stopping creation of ledger chunk files in advance");
+          return;
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        ready_files.push_back(file_name);
+      }
+    }
+
+  public:
+    LedgerChunkPool(
+      const std::string& dir, size_t pool_size, size_t chunk_size) :
+      dir(dir),
+      pool_size(pool_size),
+      chunk_size(chunk_size),
+      thread(&LedgerChunkPool::run, this)
+    {}
+
+    ~LedgerChunkPool()
+    {
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+      }
+      cv.notify_one();
+      thread.join();
+
+      for (const auto& file_name : ready_files)
+      {
+        std::error_code ec;
+        fs::remove(fs::path(dir) / fs::path(file_name), ec);
+      }
+    }
+
+    // Returns the name of a created file, if one is ready
+    std::optional<std::string> take()
+    {
+      std::optional<std::string> file_name = std::nullopt;
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!ready_files.empty())
+        {
+          file_name = std::move(ready_files.front());
+          ready_files.pop_front();
+        }
+      }
+      cv.notify_one();
+      return file_name;
+    }
+  };
+
+  // Syncs ledger files on a dedicated thread, so that the host main loop is not
+  // blocked while entries are made durable. At most one sync request is in
+  // flight at any time. Files which are no longer written to are handed over
+  // with release(), and are synced and closed before any later request is
+  // synced, so that the result of that request also covers them.
+  class LedgerSyncer
+  {
+  public:
+    struct Request
+    {
+      std::vector<std::shared_ptr<LedgerFile>> files;
+      size_t idx;
+      size_t generation;
+    };
+
+    struct Result
+    {
+      size_t idx;
+      size_t generation;
+    };
+
+  private:
+    std::mutex lock;
+    std::condition_variable cv;
+    std::optional<Request> pending = std::nullopt;
+    std::vector<std::shared_ptr<LedgerFile>> released_files;
+    std::optional<Result> completed = std::nullopt;
+    bool in_flight = false;
+    // Once a sync has failed, the entries it covered may never reach stable
+    // storage, so no later result is reported
+    bool failed = false;
+    bool stop = false;
+    std::thread thread;
+
+    void run()
+    {
+      while (true)
+      {
+        std::optional<Request> request = std::nullopt;
+        std::vector<std::shared_ptr<LedgerFile>> released;
+        bool stopping = false;
+        {
+          std::unique_lock<std::mutex> guard(lock);
+          cv.wait(guard, [this]() {
+            return stop || pending.has_value() || !released_files.empty();
+          });
+          std::swap(request, pending);
+          std::swap(released, released_files);
+          stopping = stop;
+        }
+
+        // Released files are synced before they are closed, even on shutdown
+        bool synced = true;
+        for (const auto& f : released)
+        {
+          synced &= f->sync();
+        }
+        released.clear();
+
+        if (stopping)
+        {
+          return;
+        }
+
+        if (request.has_value())
+        {
+          for (const auto& f : request->files)
+          {
+            synced &= f->sync();
+          }
+          request->files.clear();
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        failed |= !synced;
+        if (request.has_value())
+        {
+          in_flight = false;
+          if (!failed)
+          {
+            completed = Result{request->idx, request->generation};
+          }
+        }
+      }
+    }
+
+  public:
+    LedgerSyncer() : thread(&LedgerSyncer::run, this) {}
+
+    ~LedgerSyncer()
+    {
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+      }
+      cv.notify_one();
+      thread.join();
+    }
+
+    // Returns false if a sync is already in flight
+    bool submit(Request&& request)
+    {
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        if (in_flight)
+        {
+          return false;
+        }
+        in_flight = true;
+        pending = std::move(request);
+      }
+      cv.notify_one();
+      return true;
+    }
+
+    // Syncs and closes f, which is no longer written to, on the syncer thread
+    void release(std::shared_ptr<LedgerFile>&& f)
+    {
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        released_files.push_back(std::move(f));
+      }
+      cv.notify_one();
+    }
+
+    std::optional<Result> take_completed()
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      auto result = completed;
+      completed.reset();
+      return result;
+    }
+  };
+
+  // Block of contiguous framed entries of the ledger tail cache
+  struct LedgerTailBlock
+  {
+    size_t start_idx;
+    std::vector<uint8_t> data;
+    // Position in data of each entry, starting at start_idx
+    std::vector<size_t> positions;
+
+    size_t get_last_idx() const
+    {
+      return start_idx + positions.size() - 1;
+    }
+
+    size_t get_end_position(size_t idx) const
+    {
+      return idx == get_last_idx() ? data.size() :
+                                     positions.at(idx - start_idx + 1);
+    }
+  };
+
+  // View of consecutive framed entries in a block of the ledger tail cache,
+  // valid for as long as the block is held
+  struct CachedFramedEntries
+  {
+    std::shared_ptr<const LedgerTailBlock> block;
+    serializer::ByteRange entries;
+  };
+
+  /** Bounded cache of the framed entries most recently written to the ledger,
+   * from which entries replicated to followers just after being written are
+   * served, rather than being read back from the ledger files for each
+   * follower.
+   *
+   * Entries are appended to blocks whose capacity is reserved up front and
+   * never reallocated, so that the bytes of a block can be shared with
+   * readers, for as long as they hold it, while later entries are appended to
+   * it. Blocks holding truncated entries are replaced rather than modified.
+   */
+  class LedgerTailCache
+  {
+  private:
+    size_t max_size;
+    size_t block_size;
+
+    // Blocks of contiguous entries, from oldest to most recent
+    std::deque<std::shared_ptr<LedgerTailBlock>> blocks;
+    size_t cached_size = 0;
+
+    void pop_front()
+    {
+      cached_size -= blocks.front()->data.capacity();
+      blocks.pop_front();
+    }
+
+    void pop_back()
+    {
+      cached_size -= blocks.back()->data.capacity();
+      blocks.pop_back();
+    }
+
+    void evict()
+    {
+      // The most recent block is always kept
+      while (cached_size > max_size && blocks.size() > 1)
+      {
+        pop_front();
+      }
+    }
+
+  public:
+    LedgerTailCache(
+      size_t max_size = ledger_tail_cache_size_default,
+      size_t block_size = ledger_tail_cache_block_size) :
+      max_size(max_size),
+      block_size(block_size)
+    {}
+
+    // A maximum size of 0 disables the cache
+    void set_max_size(size_t max_size_)
+    {
+      max_size = max_size_;
+      if (max_size == 0)
+      {
+        clear();
+      }
+      evict();
+    }
+
+    size_t get_cached_size() const
+    {
+      return cached_size;
+    }
+
+    void clear()
+    {
+      blocks.clear();
+      cached_size = 0;
+    }
+
+    void append(size_t idx, const uint8_t* data, size_t size)
+    {
+      if (max_size == 0)
+      {
+        return;
+      }
+
+      // Cached entries are always contiguous
+      if (!blocks.empty() && idx != blocks.back()->get_last_idx() + 1)
       {
-        throw std::logic_error("Failed to write positions table to ledger");
+        clear();
       }
 
-      if (fflush(file) != 0)
+      if (
+        blocks.empty() ||
+        blocks.back()->data.size() + size > blocks.back()->data.capacity())
       {
-        throw std::logic_error(
-          fmt::format("Failed to flush ledger file: {}", strerror(errno)));
+        auto block = std::make_shared<LedgerTailBlock>();
+        block->start_idx = idx;
+        block->data.reserve(std::max(block_size, size));
+        cached_size += block->data.capacity();
+        blocks.push_back(std::move(block));
       }
 
-      completed = true;
+      auto& block = *blocks.back();
+      block.positions.push_back(block.data.size());
+      block.data.insert(block.data.end(), data, data + size);
+
+      evict();
     }
 
-    bool commit(size_t idx)
+    void truncate(size_t idx)
     {
-      if (!completed || committed || (idx != get_last_idx()))
+      while (!blocks.empty() && blocks.back()->start_idx > idx)
       {
-        // No effect if commit idx is not last idx
-        return false;
+        pop_back();
       }
 
-      if (fflush(file) != 0)
+      if (blocks.empty() || blocks.back()->get_last_idx() <= idx)
       {
-        throw std::logic_error(
-          fmt::format("Failed to flush ledger file: {}", strerror(errno)));
+        return;
       }
 
-      const auto committed_file_name = fmt::format(
-        "{}_{}-{}.{}",
-        file_name_prefix,
-        start_idx,
-        get_last_idx(),
-        ledger_committed_suffix);
-
-      auto file_path = fs::path(dir) / fs::path(file_name);
-      auto committed_file_path = fs::path(dir) / fs::path(committed_file_name);
+      // The last block may be held by readers, so its remaining entries are
+      // copied to a new block with the same capacity
+      const auto& last = *blocks.back();
+      auto block = std::make_shared<LedgerTailBlock>();
+      block->start_idx = last.start_idx;
+      block->positions.assign(
+        last.positions.begin(),
+        last.positions.begin() + (idx - last.start_idx + 1));
+      block->data.reserve(last.data.capacity());
+      block->data.assign(
+        last.data.begin(), last.data.begin() + last.get_end_position(idx));
+      blocks.back() = std::move(block);
+    }
 
-      std::error_code ec;
-      fs::rename(file_path, committed_file_path, ec);
-      if (ec)
+    // Returns views of the framed entries from from to to, one for each block
+    // they are in, or std::nullopt if any of these entries is not cached
+    std::optional<std::vector<CachedFramedEntries>> get_framed_entries(
+      size_t from, size_t to) const
+    {
+      if (
+        blocks.empty() || to < from || from < blocks.front()->start_idx ||
+        to > blocks.back()->get_last_idx())
       {
-        // Even if the file cannot be renamed (e.g. file was removed), report an
-        // error and continue
-        LOG_FAIL_FMT(
-          "Could not rename committed ledger file {} to {}",
-          file_path,
-          committed_file_path);
+        return std::nullopt;
       }
-      else
+
+      // Last block starting at or before from
+      auto it = std::prev(std::upper_bound(
+        blocks.begin(),
+        blocks.end(),
+        from,
+        [](size_t idx, const std::shared_ptr<LedgerTailBlock>& block) {
+          return idx < block->start_idx;
+        }));
+
+      std::vector<CachedFramedEntries> entries;
+      for (size_t idx = from; idx <= to; ++it)
       {
-        file_name = committed_file_name;
-        committed = true;
-        LOG_DEBUG_FMT("Committed ledger file {}", file_name);
+        const auto& block = *it;
+        const auto to_ = std::min(block->get_last_idx(), to);
+        const auto begin = block->positions.at(idx - block->start_idx);
+        const auto end = block->get_end_position(to_);
+        entries.push_back(
+          {block, {block->data.data() + begin, end - begin}});
+        idx = to_ + 1;
       }
 
-      return true;
+      return entries;
     }
   };
 
+  // View of consecutive framed entries in the read-only mapping of a committed
+  // ledger file, valid for as long as the file is held
+  struct MappedFramedEntries
+  {
+    std::shared_ptr<LedgerFile> file;
+    size_t last_idx;
+    serializer::ByteRange entries;
+  };
+
   class Ledger
   {
   private:
@@ -517,6 +1439,107 @@ namespace asynchost
     // True if a new file should be created when writing an entry
     bool require_new_file;
 
+    std::unique_ptr<LedgerChunkPool> chunk_pool = nullptr;
+
+    // Most recently written entries, shared with readers (e.g. to replicate
+    // them to each follower) without reading them back from the ledger files
+    LedgerTailCache tail_cache;
+
+    std::shared_ptr<LedgerFile> create_new_file(size_t start_idx)
+    {
+      if (chunk_pool != nullptr)
+      {
+        auto preallocated_file_name = chunk_pool->take();
+        if (preallocated_file_name.has_value())
+        {
+          try
+          {
+            return std::make_shared<LedgerFile>(
+              ledger_dir, start_idx, preallocated_file_name.value());
+          }
+          catch (const std::exception& e)
+          {
+            LOG_FAIL_FMT(
+              "Could not start ledger file from {}: {}",
+              preallocated_file_name.value(),
+              e.what());
+          }
+        }
+      }
+
+      return std::make_shared<LedgerFile>(ledger_dir, start_idx);
+    }
+
+    // Entries up to durable_idx have been synced to stable storage. Files
+    // written to since the last sync was started are synced together, in the
+    // background, according to the sync threshold and interval.
+    size_t sync_threshold_bytes = ledger_sync_threshold_bytes_default;
+    std::chrono::milliseconds sync_interval = ledger_sync_interval_default;
+    std::chrono::milliseconds time_since_sync{0};
+    size_t unsynced_bytes = 0;
+    std::vector<std::shared_ptr<LedgerFile>> unsynced_files;
+    size_t durable_idx = 0;
+    // Incremented on truncation, so that the result of a sync started before
+    // a truncation is not used to advance durable_idx
+    size_t sync_generation = 0;
+    std::unique_ptr<LedgerSyncer> syncer = std::make_unique<LedgerSyncer>();
+
+    void start_sync()
+    {
+      // A request is submitted even if no file was written to since the last
+      // one, as its result then reports entries in files synced on release
+      if (last_idx <= durable_idx)
+      {
+        return;
+      }
+
+      // Entries are flushed to the OS on the main thread, while the more
+      // expensive sync happens on the syncer thread
+      for (const auto& f : unsynced_files)
+      {
+        f->flush();
+      }
+
+      if (syncer->submit({unsynced_files, last_idx, sync_generation}))
+      {
+        unsynced_files.clear();
+        unsynced_bytes = 0;
+        time_since_sync = std::chrono::milliseconds(0);
+      }
+    }
+
+    // Files which are no longer written to (i.e. committed or deleted) are not
+    // kept open until the next sync. Committed files are handed over to the
+    // syncer thread, which syncs and closes them.
+    void release_unsynced_file(
+      const std::shared_ptr<LedgerFile>& f, bool sync_on_release)
+    {
+      auto it = std::find(unsynced_files.begin(), unsynced_files.end(), f);
+      if (it != unsynced_files.end())
+      {
+        if (sync_on_release)
+        {
+          f->flush();
+          syncer->release(std::shared_ptr<LedgerFile>(f));
+        }
+        unsynced_files.erase(it);
+      }
+    }
+
+    void update_durable_idx()
+    {
+      auto result = syncer->take_completed();
+      if (
+        result.has_value() && result->generation == sync_generation &&
+        result->idx > durable_idx)
+      {
+        durable_idx = result->idx;
+        LOG_TRACE_FMT("Ledger durable up to {}", durable_idx);
+        RINGBUFFER_WRITE_MESSAGE(
+          consensus::ledger_durable, to_enclave, durable_idx);
+      }
+    }
+
     auto get_it_contains_idx(size_t idx) const
     {
       if (idx == 0)
@@ -615,6 +1638,48 @@ namespace asynchost
       return get_file_from_cache(idx);
     }
 
+    // Opens existing ledger files in parallel, as opening incomplete files
+    // requires reading all their entries. Files that cannot be opened (e.g.
+    // corrupt files) are returned as nullptr.
+    static std::vector<std::shared_ptr<LedgerFile>> open_files(
+      const std::string& dir, const std::vector<fs::path>& file_paths)
+    {
+      std::vector<std::shared_ptr<LedgerFile>> opened(file_paths.size());
+      std::atomic<size_t> next = 0;
+      auto open_next_files = [&]() {
+        for (size_t i = next++; i < file_paths.size(); i = next++)
+        {
+          const auto file_name = file_paths[i].filename();
+          try
+          {
+            opened[i] = std::make_shared<LedgerFile>(dir, file_name);
+          }
+          catch (const std::exception& e)
+          {
+            LOG_TRACE_FMT(
+              "Ignoring invalid ledger file {}: {}", file_name, e.what());
+          }
+        }
+      };
+
+      const auto thread_count = std::min(
+        {file_paths.size(),
+         std::max<size_t>(std::thread::hardware_concurrency(), 1),
+         ledger_recovery_max_threads});
+      std::vector<std::thread> threads;
+      for (size_t i = 1; i < thread_count; ++i)
+      {
+        threads.emplace_back(open_next_files);
+      }
+      open_next_files();
+      for (auto& t : threads)
+      {
+        t.join();
+      }
+
+      return opened;
+    }
+
     std::shared_ptr<LedgerFile> get_latest_file() const
     {
       if (files.empty())
@@ -676,25 +1741,65 @@ namespace asynchost
       if (fs::is_directory(ledger_dir))
       {
         // If the ledger directory exists, recover ledger files from it
-        std::vector<fs::path> corrupt_files = {};
+        using Clock = std::chrono::steady_clock;
+        auto phase_start = Clock::now();
+        auto end_phase = [&phase_start]() {
+          const auto now = Clock::now();
+          const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+              now - phase_start);
+          phase_start = now;
+          return elapsed.count();
+        };
+
+        std::vector<fs::path> file_paths;
+        size_t committed_files = 0;
+        size_t main_ledger_dir_last_idx = 0;
         for (auto const& f : fs::directory_iterator(ledger_dir))
         {
-          auto file_name = f.path().filename();
-          std::shared_ptr<LedgerFile> ledger_file = nullptr;
-          try
+          const auto file_name = f.path().filename().string();
+          if (is_ledger_file_preallocated(file_name))
           {
-            ledger_file = std::make_shared<LedgerFile>(ledger_dir, file_name);
+            // Left over from a previous run, and never started
+            fs::remove(f.path());
+            continue;
           }
-          catch (const std::exception& e)
+          if (is_ledger_index_file(file_name))
           {
-            corrupt_files.emplace_back(f.path());
-            LOG_TRACE_FMT(
-              "Ignoring invalid ledger file {}: {}", file_name, e.what());
+            // Read along with the ledger file it indexes
             continue;
           }
+          if (is_ledger_file_committed(file_name))
+          {
+            // Committed files are never written to again, so are only opened
+            // when entries are read from them
+            const auto last_idx_ = get_last_idx_from_file_name(file_name);
+            if (last_idx_.has_value())
+            {
+              committed_files++;
+              main_ledger_dir_last_idx =
+                std::max(main_ledger_dir_last_idx, last_idx_.value());
+              continue;
+            }
+          }
+          file_paths.emplace_back(f.path());
+        }
+        const auto list_ms = end_phase();
 
-          files.emplace_back(std::move(ledger_file));
+        auto opened_files = open_files(ledger_dir, file_paths);
+        std::vector<fs::path> corrupt_files = {};
+        for (size_t i = 0; i < file_paths.size(); ++i)
+        {
+          if (opened_files[i] == nullptr)
+          {
+            corrupt_files.emplace_back(file_paths[i]);
+          }
+          else
+          {
+            files.emplace_back(std::move(opened_files[i]));
+          }
         }
+        const auto open_ms = end_phase();
 
         // Rename corrupt files so that they are not considered for reading
         // entries later on
@@ -717,13 +1822,26 @@ namespace asynchost
               "Corrupted ledger file {} will be ignored", f.filename());
           }
         }
-
-        if (files.empty())
+        const auto rename_ms = end_phase();
+
+        LOG_INFO_FMT(
+          "Opened {} ledger files in {}ms, skipping {} committed files "
+          "(listing: {}ms, opening: {}ms, renaming {} corrupt files: {}ms)",
+          files.size(),
+          list_ms + open_ms + rename_ms,
+          committed_files,
+          list_ms,
+          open_ms,
+          corrupt_files.size(),
+          rename_ms);
+
+        if (files.empty() && committed_files == 0)
         {
           LOG_TRACE_FMT(
             "Ledger directory \"{}\" is empty: no ledger file to recover",
             ledger_dir);
           require_new_file = true;
+          durable_idx = committed_idx;
           return;
         }
 
@@ -733,7 +1851,15 @@ namespace asynchost
           return a->get_last_idx() < b->get_last_idx();
         });
 
-        auto main_ledger_dir_last_idx = get_latest_file()->get_last_idx();
+        if (committed_files > 0)
+        {
+          committed_idx = std::max(committed_idx, main_ledger_dir_last_idx);
+        }
+        if (!files.empty())
+        {
+          main_ledger_dir_last_idx = std::max(
+            main_ledger_dir_last_idx, get_latest_file()->get_last_idx());
+        }
         if (main_ledger_dir_last_idx < last_idx)
         {
           throw std::logic_error(fmt::format(
@@ -745,21 +1871,6 @@ namespace asynchost
 
         last_idx = main_ledger_dir_last_idx;
 
-        for (auto f = files.begin(); f != files.end();)
-        {
-          if ((*f)->is_committed())
-          {
-            committed_idx = (*f)->get_last_idx();
-            auto f_ = f;
-            f++;
-            files.erase(f_);
-          }
-          else
-          {
-            f++;
-          }
-        }
-
         // Continue writing at the end of last file only if that file is not
         // complete
         if (files.size() > 0 && !files.back()->is_complete())
@@ -781,6 +1892,11 @@ namespace asynchost
         require_new_file = true;
       }
 
+      // Recovered uncommitted entries are synced again, as they may not have
+      // been made durable before the host stopped
+      durable_idx = committed_idx;
+      unsynced_files = {files.begin(), files.end()};
+
       LOG_INFO_FMT(
         "Recovered ledger entries up to {}, committed to {}",
         last_idx,
@@ -802,6 +1918,11 @@ namespace asynchost
       for (auto const& f : fs::directory_iterator(ledger_dir))
       {
         auto file_name = f.path().filename();
+        if (is_ledger_file_preallocated(file_name))
+        {
+          continue;
+        }
+
         if (get_start_idx_from_file_name(file_name) > idx)
         {
           LOG_INFO_FMT(
@@ -818,10 +1939,12 @@ namespace asynchost
         files.clear();
         require_new_file = true;
       }
+      tail_cache.clear();
 
       LOG_INFO_FMT("Setting last known/commit index to {}", idx);
       last_idx = idx;
       committed_idx = idx;
+      durable_idx = idx;
     }
 
     size_t get_last_idx() const
@@ -829,6 +1952,50 @@ namespace asynchost
       return last_idx;
     }
 
+    size_t get_durable_idx() const
+    {
+      return durable_idx;
+    }
+
+    // Keeps pool_size chunk files created and allocated ahead of time. A pool
+    // size of 0 disables this.
+    void set_chunk_pool_size(size_t pool_size)
+    {
+      chunk_pool = nullptr;
+      if (pool_size > 0)
+      {
+        chunk_pool = std::make_unique<LedgerChunkPool>(
+          ledger_dir, pool_size, chunk_threshold);
+      }
+    }
+
+    // Keeps up to max_size bytes of the most recently written entries in
+    // memory. A maximum size of 0 disables this.
+    void set_tail_cache_size(size_t max_size)
+    {
+      tail_cache.set_max_size(max_size);
+    }
+
+    void set_sync_policy(
+      size_t sync_threshold_bytes_, std::chrono::milliseconds sync_interval_)
+    {
+      sync_threshold_bytes = sync_threshold_bytes_;
+      sync_interval = sync_interval_;
+    }
+
+    // Called periodically from the host main loop to start syncing recently
+    // written entries and report newly durable entries to the enclave
+    void tick(std::chrono::milliseconds elapsed)
+    {
+      update_durable_idx();
+
+      time_since_sync += elapsed;
+      if (time_since_sync >= sync_interval)
+      {
+        start_sync();
+      }
+    }
+
     std::optional<std::vector<uint8_t>> read_entry(size_t idx)
     {
       auto f = get_file_from_idx(idx);
@@ -839,6 +2006,18 @@ namespace asynchost
       return f->read_entry(idx);
     }
 
+    // Returns the term of the entry at idx, as recorded in the index of the
+    // ledger file containing it, if known
+    std::optional<consensus::Term> get_term(size_t idx)
+    {
+      auto f = get_file_from_idx(idx);
+      if (f == nullptr)
+      {
+        return std::nullopt;
+      }
+      return f->get_term(idx);
+    }
+
     std::optional<std::vector<uint8_t>> read_framed_entries(
       size_t from, size_t to)
     {
@@ -872,16 +2051,124 @@ namespace asynchost
       return entries;
     }
 
+    // Reads as many consecutive framed entries, starting at from and up to to,
+    // as fit in max_size bytes (always at least one). Entries within the same
+    // ledger file are read with a single read. Returns the index of the last
+    // entry read along with the framed entries.
+    std::optional<std::pair<size_t, std::vector<uint8_t>>>
+    read_framed_entries_up_to_size(size_t from, size_t to, size_t max_size)
+    {
+      if ((from <= 0) || (to > last_idx) || (to < from))
+      {
+        return std::nullopt;
+      }
+
+      std::vector<uint8_t> entries;
+      size_t idx = from;
+      while (idx <= to)
+      {
+        auto f_from = get_file_from_idx(idx);
+        if (f_from == nullptr)
+        {
+          break;
+        }
+
+        const auto remaining_size = max_size - entries.size();
+        auto to_ = f_from->get_last_idx_within_size(
+          idx, std::min(f_from->get_last_idx(), to), remaining_size);
+        if (
+          !entries.empty() &&
+          f_from->framed_entries_size(idx, to_) > remaining_size)
+        {
+          // Only the first entry of the range may exceed max_size
+          break;
+        }
+
+        auto v = f_from->read_framed_entries(idx, to_);
+        if (!v.has_value())
+        {
+          break;
+        }
+        entries.insert(
+          entries.end(),
+          std::make_move_iterator(v->begin()),
+          std::make_move_iterator(v->end()));
+        idx = to_ + 1;
+
+        if (entries.size() >= max_size)
+        {
+          break;
+        }
+      }
+
+      if (idx == from)
+      {
+        return std::nullopt;
+      }
+
+      return std::make_pair(idx - 1, std::move(entries));
+    }
+
+    // Returns a view, without copying, of as many consecutive framed entries,
+    // starting at from and up to to, as fit in max_size bytes (always at least
+    // one). Only entries in a single mapped (committed) ledger file are
+    // returned.
+    std::optional<MappedFramedEntries> get_mapped_framed_entries_up_to_size(
+      size_t from,
+      size_t to,
+      size_t max_size = std::numeric_limits<size_t>::max())
+    {
+      if ((from <= 0) || (to > last_idx) || (to < from))
+      {
+        return std::nullopt;
+      }
+
+      auto f = get_file_from_idx(from);
+      if (f == nullptr || !f->is_mapped())
+      {
+        return std::nullopt;
+      }
+
+      auto to_ = f->get_last_idx_within_size(
+        from, std::min(f->get_last_idx(), to), max_size);
+      auto entries = f->get_mapped_framed_entries(from, to_);
+      if (!entries.has_value())
+      {
+        return std::nullopt;
+      }
+
+      return MappedFramedEntries{f, to_, entries.value()};
+    }
+
+    // Returns views, without copying, of the framed entries from from to to
+    // if they are all in the cache of the most recently written entries
+    std::optional<std::vector<CachedFramedEntries>> get_cached_framed_entries(
+      size_t from, size_t to) const
+    {
+      return tail_cache.get_framed_entries(from, to);
+    }
+
     size_t write_entry(
-      const uint8_t* data, size_t size, bool committable, bool force_chunk)
+      const uint8_t* data,
+      size_t size,
+      bool committable,
+      bool force_chunk,
+      consensus::Term term)
     {
       if (require_new_file)
       {
-        files.push_back(std::make_shared<LedgerFile>(ledger_dir, last_idx + 1));
+        files.push_back(create_new_file(last_idx + 1));
         require_new_file = false;
       }
       auto f = get_latest_file();
-      last_idx = f->write_entry(data, size, committable);
+      last_idx = f->write_entry(data, size, committable, term);
+      tail_cache.append(last_idx, data, size);
+
+      if (unsynced_files.empty() || unsynced_files.back() != f)
+      {
+        unsynced_files.push_back(f);
+      }
+      unsynced_bytes += size;
 
       LOG_TRACE_FMT(
         "Wrote entry at {} [committable: {}, forced: {}]",
@@ -898,6 +2185,11 @@ namespace asynchost
         LOG_DEBUG_FMT("Ledger chunk completed at {}", last_idx);
       }
 
+      if (committable && unsynced_bytes >= sync_threshold_bytes)
+      {
+        start_sync();
+      }
+
       return last_idx;
     }
 
@@ -923,6 +2215,7 @@ namespace asynchost
         auto truncate_idx = (it == f_from) ? idx : (*it)->get_start_idx() - 1;
         if ((*it)->truncate(truncate_idx))
         {
+          release_unsynced_file(*it, false);
           auto it_ = it;
           it++;
           files.erase(it_);
@@ -937,6 +2230,15 @@ namespace asynchost
       }
 
       last_idx = idx;
+      tail_cache.truncate(idx);
+
+      sync_generation++;
+      if (idx < durable_idx)
+      {
+        durable_idx = idx;
+        RINGBUFFER_WRITE_MESSAGE(
+          consensus::ledger_durable, to_enclave, durable_idx);
+      }
     }
 
     void commit(size_t idx)
@@ -962,6 +2264,7 @@ namespace asynchost
           (*it)->commit(commit_idx) &&
           (it != f_to || (idx == (*it)->get_last_idx())))
         {
+          release_unsynced_file(*it, true);
           auto it_ = it;
           it++;
           files.erase(it_);
@@ -990,7 +2293,8 @@ namespace asynchost
         [this](const uint8_t* data, size_t size) {
           auto committable = serialized::read<bool>(data, size);
           auto force_chunk = serialized::read<bool>(data, size);
-          write_entry(data, size, committable, force_chunk);
+          auto term = serialized::read<consensus::Term>(data, size);
+          write_entry(data, size, committable, force_chunk, term);
         });
 
       DISPATCHER_SET_MESSAGE_HANDLER(
@@ -1014,6 +2318,19 @@ namespace asynchost
           auto [idx, purpose] =
             ringbuffer::read_message<consensus::ledger_get>(data, size);
 
+          // Committed entries are written straight from the mapped file
+          auto mapped = get_mapped_framed_entries_up_to_size(idx, idx);
+          if (mapped.has_value())
+          {
+            RINGBUFFER_WRITE_MESSAGE(
+              consensus::ledger_entry,
+              to_enclave,
+              idx,
+              purpose,
+              mapped->entries);
+            return;
+          }
+
           auto entry = read_entry(idx);
 
           if (entry.has_value())
@@ -1027,6 +2344,63 @@ namespace asynchost
               consensus::ledger_no_entry, to_enclave, idx, purpose);
           }
         });
+
+      DISPATCHER_SET_MESSAGE_HANDLER(
+        disp,
+        consensus::ledger_get_range,
+        [&](const uint8_t* data, size_t size) {
+          auto [from_idx, to_idx, purpose] =
+            ringbuffer::read_message<consensus::ledger_get_range>(data, size);
+
+          // Reply with as many bounded-size ranges of entries as necessary,
+          // followed by the range of entries that could not be read, if any
+          auto idx = from_idx;
+          const auto last_readable_idx = std::min<size_t>(to_idx, last_idx);
+          while (idx <= last_readable_idx)
+          {
+            auto mapped = get_mapped_framed_entries_up_to_size(
+              idx, last_readable_idx, ledger_max_entries_range_size_default);
+            if (mapped.has_value())
+            {
+              RINGBUFFER_WRITE_MESSAGE(
+                consensus::ledger_entry_range,
+                to_enclave,
+                idx,
+                mapped->last_idx,
+                purpose,
+                mapped->entries);
+              idx = mapped->last_idx + 1;
+              continue;
+            }
+
+            auto entries = read_framed_entries_up_to_size(
+              idx, last_readable_idx, ledger_max_entries_range_size_default);
+            if (!entries.has_value())
+            {
+              break;
+            }
+
+            auto& [last_read_idx, framed_entries] = entries.value();
+            RINGBUFFER_WRITE_MESSAGE(
+              consensus::ledger_entry_range,
+              to_enclave,
+              idx,
+              last_read_idx,
+              purpose,
+              framed_entries);
+            idx = last_read_idx + 1;
+          }
+
+          if (idx <= to_idx)
+          {
+            RINGBUFFER_WRITE_MESSAGE(
+              consensus::ledger_no_entry_range,
+              to_enclave,
+              idx,
+              to_idx,
+              purpose);
+          }
+        });
     }
   };
 }
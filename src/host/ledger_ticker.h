@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#pragma once
+
+#include "ledger.h"
+#include "timer.h"
+
+#include <chrono>
+
+namespace asynchost
+{
+  class LedgerTickerImpl
+  {
+  private:
+    using TClock = std::chrono::steady_clock;
+
+    Ledger& ledger;
+    TClock::time_point last;
+
+  public:
+    LedgerTickerImpl(Ledger& ledger) : ledger(ledger), last(TClock::now()) {}
+
+    void on_timer()
+    {
+      const auto now = TClock::now();
+      ledger.tick(
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - last));
+      last = now;
+    }
+  };
+
+  using LedgerTicker = proxy_ptr<Timer<LedgerTickerImpl>>;
+}
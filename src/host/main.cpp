@@ -10,6 +10,8 @@
 #include "ds/stacktrace_utils.h"
 #include "enclave.h"
 #include "handle_ring_buffer.h"
+#include "http/authentication/verifier_cache.h"
+#include "ledger_ticker.h"
 #include "load_monitor.h"
 #include "node_connections.h"
 #include "process_launcher.h"
@@ -93,6 +95,30 @@ int main(int argc, char** argv)
       "Number of worker threads inside the enclave")
     ->capture_default_str();
 
+  threading::IdlePolicy worker_idle_policy;
+  app
+    .add_option(
+      "--worker-idle-spins",
+      worker_idle_policy.spins,
+      "Number of times a worker thread with no work checks for work again "
+      "straight away")
+    ->capture_default_str();
+
+  app
+    .add_option(
+      "--worker-idle-pauses",
+      worker_idle_policy.pauses,
+      "Number of further times a worker thread with no work checks for work, "
+      "pausing between checks, before sleeping until work is given to it")
+    ->capture_default_str();
+
+  bool worker_idle_no_sleep = false;
+  app.add_flag(
+    "--worker-idle-no-sleep",
+    worker_idle_no_sleep,
+    "Worker threads with no work never sleep, and keep pausing between "
+    "checks for work");
+
   cli::ParsedAddress node_address;
   cli::add_address_option(
     app,
@@ -166,6 +192,47 @@ int main(int argc, char** argv)
     ->capture_default_str()
     ->transform(CLI::AsSizeValue(true)); // 1000 is kb
 
+  size_t ledger_chunk_pool_size = asynchost::ledger_chunk_pool_size_default;
+  app
+    .add_option(
+      "--ledger-chunk-pool-size",
+      ledger_chunk_pool_size,
+      "Number of ledger chunk files created and allocated ahead of time (0 "
+      "to disable)")
+    ->capture_default_str();
+
+  size_t ledger_tail_cache_bytes =
+    asynchost::ledger_tail_cache_size_default;
+  app
+    .add_option(
+      "--ledger-tail-cache-bytes",
+      ledger_tail_cache_bytes,
+      "Size (bytes) of the most recently written ledger entries kept in "
+      "memory, from which entries are replicated to followers (0 to "
+      "disable)")
+    ->capture_default_str()
+    ->transform(CLI::AsSizeValue(true)); // 1000 is kb
+
+  size_t ledger_sync_bytes = asynchost::ledger_sync_threshold_bytes_default;
+  app
+    .add_option(
+      "--ledger-sync-bytes",
+      ledger_sync_bytes,
+      "Size (bytes) of written ledger entries after which these are synced "
+      "to stable storage")
+    ->capture_default_str()
+    ->transform(CLI::AsSizeValue(true)); // 1000 is kb
+
+  size_t ledger_sync_interval_ms =
+    asynchost::ledger_sync_interval_default.count();
+  app
+    .add_option(
+      "--ledger-sync-interval-ms",
+      ledger_sync_interval_ms,
+      "Maximum interval (milliseconds) after which written ledger entries are "
+      "synced to stable storage")
+    ->capture_default_str();
+
   size_t snapshot_tx_interval = 10'000;
   app
     .add_option(
@@ -174,6 +241,16 @@ int main(int argc, char** argv)
       "Number of transactions between snapshots")
     ->capture_default_str();
 
+  size_t snapshot_max_deltas = 0;
+  app
+    .add_option(
+      "--snapshot-max-deltas",
+      snapshot_max_deltas,
+      "Maximum number of consecutive delta snapshots, which only contain the "
+      "state changed since the previous committed snapshot, generated between "
+      "two full snapshots")
+    ->capture_default_str();
+
   size_t max_open_sessions = 1'000;
   app
     .add_option(
@@ -197,6 +274,15 @@ int main(int argc, char** argv)
       "more than --max-open-sessions",
       hard_session_cap_diff));
 
+  size_t max_cached_verifiers = ccf::VerifierCache::DEFAULT_MAX_VERIFIERS;
+  app
+    .add_option(
+      "--max-cached-verifiers",
+      max_cached_verifiers,
+      "Maximum number of verifiers for the certificates of users and members "
+      "kept by each node to authenticate signed requests")
+    ->capture_default_str();
+
   logger::Level host_log_level{logger::Level::INFO};
   std::vector<std::pair<std::string, logger::Level>> level_map;
   for (int i = logger::MOST_VERBOSE; i < logger::MAX_LOG_LEVEL; i++)
@@ -602,6 +688,11 @@ int main(int argc, char** argv)
                                          from_enclave_buffer.size(),
                                          &from_enclave_offsets};
 
+  // readers of each ring buffer are woken through its doorbell when messages
+  // are written, rather than polling it
+  ringbuffer::doorbell::open(to_enclave_offsets.doorbell);
+  ringbuffer::doorbell::open(from_enclave_offsets.doorbell);
+
   ringbuffer::Circuit circuit(to_enclave_def, from_enclave_def);
   messaging::BufferProcessor bp("Host");
 
@@ -638,6 +729,8 @@ int main(int argc, char** argv)
     // handle outbound messages from the enclave
     asynchost::HandleRingbuffer handle_ringbuffer(
       1ms, bp, circuit.read_from_inside(), non_blocking_factory);
+    asynchost::RingbufferDoorbell ringbuffer_doorbell(
+      from_enclave_offsets.doorbell, handle_ringbuffer);
 
     // graceful shutdown on sigterm
     asynchost::Sigterm sigterm(writer_factory);
@@ -648,8 +741,15 @@ int main(int argc, char** argv)
       ledger_chunk_bytes,
       asynchost::ledger_max_read_cache_files_default,
       read_only_ledger_dirs);
+    ledger.set_chunk_pool_size(ledger_chunk_pool_size);
+    ledger.set_tail_cache_size(ledger_tail_cache_bytes);
+    ledger.set_sync_policy(
+      ledger_sync_bytes, std::chrono::milliseconds(ledger_sync_interval_ms));
     ledger.register_message_handlers(bp.get_dispatcher());
 
+    // regularly sync recently written ledger entries to stable storage
+    asynchost::LedgerTicker ledger_ticker(1ms, ledger);
+
     asynchost::SnapshotManager snapshots(snapshot_dir, ledger);
     snapshots.register_message_handlers(bp.get_dispatcher());
 
@@ -722,8 +822,13 @@ int main(int argc, char** argv)
                                     public_rpc_address.port};
     ccf_config.domain = domain;
     ccf_config.snapshot_tx_interval = snapshot_tx_interval;
+    ccf_config.snapshot_max_deltas = snapshot_max_deltas;
     ccf_config.max_open_sessions_soft = max_open_sessions;
     ccf_config.max_open_sessions_hard = max_open_sessions_hard;
+    ccf_config.max_cached_verifiers = max_cached_verifiers;
+
+    worker_idle_policy.park = !worker_idle_no_sleep;
+    ccf_config.worker_idle_policy = worker_idle_policy;
 
     ccf_config.subject_name = subject_name;
     ccf_config.subject_alternative_names = subject_alternative_names;
@@ -813,13 +918,25 @@ int main(int argc, char** argv)
             snapshot));
         }
 
-        ccf_config.startup_snapshot = snapshots.read_snapshot(snapshot);
+        // Delta snapshots are preceded by the snapshots they are against
+        auto snapshot_chain = snapshots.get_snapshot_chain(snapshot);
+        if (!snapshot_chain.has_value())
+        {
+          throw std::logic_error(fmt::format(
+            "Could not find base snapshot of delta snapshot file \"{}\"",
+            snapshot));
+        }
+
+        ccf_config.startup_snapshot =
+          snapshots.read_snapshot_chain(snapshot_chain.value());
         ccf_config.startup_snapshot_evidence_seqno =
           snapshot_evidence_idx->first;
 
         LOG_INFO_FMT(
-          "Found latest snapshot file: {} (size: {}, evidence seqno: {})",
+          "Found latest snapshot file: {} (chain of {} file(s), size: {}, "
+          "evidence seqno: {})",
           snapshot,
+          snapshot_chain->size(),
           ccf_config.startup_snapshot.size(),
           ccf_config.startup_snapshot_evidence_seqno);
       }
@@ -912,5 +1029,8 @@ int main(int argc, char** argv)
   if (rc)
     LOG_FAIL_FMT("Failed to close uv loop cleanly: {}", uv_err_name(rc));
 
+  ringbuffer::doorbell::close(to_enclave_offsets.doorbell);
+  ringbuffer::doorbell::close(from_enclave_offsets.doorbell);
+
   return rc;
 }
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "consensus/aft/raft_types.h"
+#include "ds/byte_queue.h"
 #include "ledger.h"
 #include "node/node_types.h"
 #include "tcp.h"
@@ -24,7 +25,7 @@ namespace asynchost
       NodeConnections& parent;
       std::optional<ccf::NodeId> node;
       std::optional<size_t> msg_size = std::nullopt;
-      std::vector<uint8_t> pending;
+      ds::ByteQueue pending;
 
       ConnectionBehaviour(
         NodeConnections& parent,
@@ -40,10 +41,17 @@ namespace asynchost
           node.value_or(UnassociatedNode).trim(),
           len);
 
-        pending.insert(pending.end(), incoming, incoming + len);
+        // When nothing is buffered from previous reads, complete messages are
+        // parsed directly from the incoming chunk, and only a trailing
+        // partial message is copied
+        const bool buffered = !pending.empty();
+        if (buffered)
+        {
+          pending.append(incoming, len);
+        }
 
-        const uint8_t* data = pending.data();
-        size_t size = pending.size();
+        const uint8_t* data = buffered ? pending.data() : incoming;
+        size_t size = buffered ? pending.size() : len;
         const auto size_before = size;
 
         while (true)
@@ -95,11 +103,13 @@ namespace asynchost
           msg_size.reset();
         }
 
-        const auto size_after = size;
-        const auto used = size_before - size_after;
-        if (used > 0)
+        if (buffered)
         {
-          pending.erase(pending.begin(), pending.begin() + used);
+          pending.consume(size_before - size);
+        }
+        else
+        {
+          pending.append(data, size);
         }
       }
 
@@ -291,27 +301,57 @@ namespace asynchost
             const auto& ae =
               serialized::overlay<consensus::AppendEntriesIndex>(data, size);
 
-            // Find the total frame size, and write it along with the header.
+            // Find the total frame size, and write it along with the header
+            // and entries in a single write. The frame size and header are
+            // copied, while the entries are written without copying, holding
+            // on to the buffer they are in until they are written.
             uint32_t frame = (uint32_t)size_to_send;
-            std::optional<std::vector<uint8_t>> framed_entries = std::nullopt;
-
-            framed_entries =
-              ledger.read_framed_entries(ae.prev_idx + 1, ae.idx);
-            if (framed_entries.has_value())
+            std::vector<WriteBuffer> buffers = {
+              {(const uint8_t*)&frame, sizeof(uint32_t)},
+              {data_to_send, size_to_send}};
+
+            // Recently written entries are written from the ledger's cache,
+            // whose blocks are shared by the AEs sent to all followers.
+            // Committed entries are written straight from the mapped ledger
+            // file if they are all in the same file. Otherwise, they are read
+            // from the ledger.
+            auto cached =
+              ledger.get_cached_framed_entries(ae.prev_idx + 1, ae.idx);
+            if (cached.has_value())
             {
-              frame += (uint32_t)framed_entries->size();
-              node.value()->write(sizeof(uint32_t), (uint8_t*)&frame);
-              node.value()->write(size_to_send, data_to_send);
-
-              frame = (uint32_t)framed_entries->size();
-              node.value()->write(frame, framed_entries->data());
+              for (const auto& c : cached.value())
+              {
+                buffers.push_back({c.entries.data, c.entries.size, c.block});
+              }
             }
             else
             {
-              // Header-only AE
-              node.value()->write(sizeof(uint32_t), (uint8_t*)&frame);
-              node.value()->write(size_to_send, data_to_send);
+              auto mapped = ledger.get_mapped_framed_entries_up_to_size(
+                ae.prev_idx + 1, ae.idx);
+              if (mapped.has_value() && mapped->last_idx == ae.idx)
+              {
+                buffers.push_back(
+                  {mapped->entries.data, mapped->entries.size, mapped->file});
+              }
+              else
+              {
+                auto framed_entries =
+                  ledger.read_framed_entries(ae.prev_idx + 1, ae.idx);
+                if (framed_entries.has_value())
+                {
+                  auto owned = std::make_shared<std::vector<uint8_t>>(
+                    std::move(framed_entries.value()));
+                  buffers.push_back({owned->data(), owned->size(), owned});
+                }
+              }
+            }
+
+            // Header-only AE if there are no entries
+            for (size_t i = 2; i < buffers.size(); ++i)
+            {
+              frame += (uint32_t)buffers[i].len;
             }
+            node.value()->write(buffers);
 
             LOG_DEBUG_FMT(
               "send AE to node {} [{}]: {}, {}",
@@ -327,8 +367,9 @@ namespace asynchost
 
             LOG_DEBUG_FMT("node send to {} [{}]", to.trim(), frame);
 
-            node.value()->write(sizeof(uint32_t), (uint8_t*)&frame);
-            node.value()->write(size_to_send, data_to_send);
+            node.value()->write(
+              {{(const uint8_t*)&frame, sizeof(uint32_t)},
+               {data_to_send, size_to_send}});
           }
         });
     }
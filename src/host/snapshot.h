@@ -10,6 +10,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <optional>
 
 namespace fs = std::filesystem;
@@ -19,6 +20,35 @@ namespace asynchost
   static constexpr auto snapshot_file_prefix = "snapshot";
   static constexpr auto snapshot_idx_delimiter = "_";
   static constexpr auto snapshot_committed_suffix = "committed";
+  static constexpr auto snapshot_delta_suffix = "delta";
+
+  std::optional<size_t> get_snapshot_delta_base_idx_from_file_name(
+    const std::string& file_name)
+  {
+    // Returns the idx of the snapshot a delta snapshot is against
+    const auto delta_marker =
+      fmt::format(".{}{}", snapshot_delta_suffix, snapshot_idx_delimiter);
+    auto delta_pos = file_name.find(delta_marker);
+    if (delta_pos == std::string::npos)
+    {
+      // Snapshot is a full snapshot
+      return std::nullopt;
+    }
+
+    size_t base_idx;
+    const auto base_start = delta_pos + delta_marker.size();
+    if (
+      std::from_chars(
+        file_name.data() + base_start,
+        file_name.data() + file_name.size(),
+        base_idx)
+        .ec != std::errc())
+    {
+      return std::nullopt;
+    }
+
+    return base_idx;
+  }
 
   std::optional<std::pair<size_t, size_t>>
   get_snapshot_evidence_idx_from_file_name(const std::string& file_name)
@@ -54,10 +84,18 @@ namespace asynchost
       return std::nullopt;
     }
 
+    // The evidence idx of delta snapshots is followed by their base idx
+    auto evidence_end =
+      file_name.find(fmt::format(".{}", snapshot_delta_suffix));
+    if (evidence_end == std::string::npos)
+    {
+      evidence_end = commit_pos;
+    }
+
     size_t evidence_idx;
     const auto evidence_start = evidence_pos + 1;
     const auto str_evidence_idx =
-      file_name.substr(evidence_start, commit_pos - evidence_start);
+      file_name.substr(evidence_start, evidence_end - evidence_start);
     if (
       std::from_chars(
         str_evidence_idx.data(),
@@ -94,6 +132,10 @@ namespace asynchost
     static constexpr auto snapshot_idx_delimiter = "_";
     static constexpr auto snapshot_committed_suffix = "committed";
 
+    // Chunks of snapshots streamed by the enclave, held until the snapshot
+    // evidence is recorded and the snapshot file can be named
+    std::map<consensus::Index, std::vector<uint8_t>> pending_snapshots;
+
     size_t get_snapshot_idx_from_file_name(const std::string& file_name)
     {
       // Assumes snapshot file is not committed
@@ -129,11 +171,83 @@ namespace asynchost
       return files::slurp(fs::path(snapshot_dir) / fs::path(file_name));
     }
 
+    /** Returns the names of the committed snapshot files from which the
+     * state of the committed snapshot file_name is resolved, starting with a
+     * full snapshot and followed by successive deltas, or std::nullopt if the
+     * base of one of the deltas is missing or uncommitted.
+     */
+    std::optional<std::vector<std::string>> get_snapshot_chain(
+      const std::string& file_name)
+    {
+      std::vector<std::string> chain = {file_name};
+      auto base_idx = get_snapshot_delta_base_idx_from_file_name(file_name);
+      if (!base_idx.has_value())
+      {
+        return chain;
+      }
+
+      std::map<size_t, std::string> committed_snapshots;
+      for (auto const& f : fs::directory_iterator(snapshot_dir))
+      {
+        auto name = f.path().filename().string();
+        if (
+          name.rfind(
+            fmt::format("{}{}", snapshot_file_prefix, snapshot_idx_delimiter),
+            0) == 0 &&
+          get_snapshot_evidence_idx_from_file_name(name).has_value())
+        {
+          committed_snapshots.emplace(
+            get_snapshot_idx_from_file_name(name), name);
+        }
+      }
+
+      while (base_idx.has_value())
+      {
+        auto search = committed_snapshots.find(base_idx.value());
+        if (search == committed_snapshots.end())
+        {
+          LOG_INFO_FMT(
+            "Could not find committed snapshot at {} which \"{}\" is a delta "
+            "against",
+            base_idx.value(),
+            chain.front());
+          return std::nullopt;
+        }
+
+        // Bases are always earlier snapshots, so the chain cannot loop
+        if (search->first >= get_snapshot_idx_from_file_name(chain.front()))
+        {
+          return std::nullopt;
+        }
+
+        chain.insert(chain.begin(), search->second);
+        base_idx = get_snapshot_delta_base_idx_from_file_name(search->second);
+      }
+
+      return chain;
+    }
+
+    /** Concatenates the files of a snapshot chain, as expected by the enclave
+     * on startup.
+     */
+    std::vector<uint8_t> read_snapshot_chain(
+      const std::vector<std::string>& chain)
+    {
+      std::vector<uint8_t> snapshot;
+      for (const auto& file_name : chain)
+      {
+        auto link = read_snapshot(file_name);
+        snapshot.insert(snapshot.end(), link.begin(), link.end());
+      }
+      return snapshot;
+    }
+
     void write_snapshot(
       consensus::Index idx,
       consensus::Index evidence_idx,
       const uint8_t* snapshot_data,
-      size_t snapshot_size)
+      size_t snapshot_size,
+      consensus::Index base_idx = 0)
     {
       auto snapshot_file_name = fmt::format(
         "{}{}{}{}{}",
@@ -142,6 +256,11 @@ namespace asynchost
         idx,
         snapshot_idx_delimiter,
         evidence_idx);
+      if (base_idx != 0)
+      {
+        snapshot_file_name += fmt::format(
+          ".{}{}{}", snapshot_delta_suffix, snapshot_idx_delimiter, base_idx);
+      }
       auto full_snapshot_path =
         fs::path(snapshot_dir) / fs::path(snapshot_file_name);
 
@@ -162,6 +281,49 @@ namespace asynchost
         reinterpret_cast<const char*>(snapshot_data), snapshot_size);
     }
 
+    void append_snapshot_chunk(
+      consensus::Index idx,
+      bool first,
+      const uint8_t* chunk_data,
+      size_t chunk_size)
+    {
+      auto& pending_snapshot = pending_snapshots[idx];
+      if (first)
+      {
+        // Chunks left over from an earlier, abandoned snapshot at this seqno
+        pending_snapshot.clear();
+      }
+      pending_snapshot.insert(
+        pending_snapshot.end(), chunk_data, chunk_data + chunk_size);
+    }
+
+    void write_pending_snapshot(
+      consensus::Index idx,
+      consensus::Index evidence_idx,
+      consensus::Index base_idx)
+    {
+      auto search = pending_snapshots.find(idx);
+      if (search == pending_snapshots.end())
+      {
+        LOG_FAIL_FMT("Could not find snapshot chunks for seqno {}", idx);
+        return;
+      }
+
+      auto snapshot = std::move(search->second);
+      pending_snapshots.erase(search);
+
+      write_snapshot(
+        idx, evidence_idx, snapshot.data(), snapshot.size(), base_idx);
+    }
+
+    void discard_pending_snapshot(consensus::Index idx)
+    {
+      if (pending_snapshots.erase(idx) > 0)
+      {
+        LOG_INFO_FMT("Discarded pending snapshot chunks for seqno {}", idx);
+      }
+    }
+
     void commit_snapshot(
       consensus::Index snapshot_idx, consensus::Index evidence_commit_idx)
     {
@@ -251,6 +413,15 @@ namespace asynchost
         size_t snapshot_idx = std::stol(file_name.substr(pos + 1));
         if (snapshot_idx > latest_idx)
         {
+          if (!get_snapshot_chain(file_name).has_value())
+          {
+            LOG_INFO_FMT(
+              "Ignoring delta snapshot file \"{}\" whose base snapshot is "
+              "missing",
+              file_name);
+            continue;
+          }
+
           snapshot_file = file_name;
           latest_idx = snapshot_idx;
         }
@@ -262,11 +433,29 @@ namespace asynchost
     void register_message_handlers(
       messaging::Dispatcher<ringbuffer::Message>& disp)
     {
+      DISPATCHER_SET_MESSAGE_HANDLER(
+        disp,
+        consensus::snapshot_chunk,
+        [this](const uint8_t* data, size_t size) {
+          auto idx = serialized::read<consensus::Index>(data, size);
+          auto first = serialized::read<bool>(data, size);
+          append_snapshot_chunk(idx, first, data, size);
+        });
+
       DISPATCHER_SET_MESSAGE_HANDLER(
         disp, consensus::snapshot, [this](const uint8_t* data, size_t size) {
           auto idx = serialized::read<consensus::Index>(data, size);
           auto evidence_idx = serialized::read<consensus::Index>(data, size);
-          write_snapshot(idx, evidence_idx, data, size);
+          auto base_idx = serialized::read<consensus::Index>(data, size);
+          write_pending_snapshot(idx, evidence_idx, base_idx);
+        });
+
+      DISPATCHER_SET_MESSAGE_HANDLER(
+        disp,
+        consensus::snapshot_discard,
+        [this](const uint8_t* data, size_t size) {
+          auto idx = serialized::read<consensus::Index>(data, size);
+          discard_pending_snapshot(idx);
         });
 
       DISPATCHER_SET_MESSAGE_HANDLER(
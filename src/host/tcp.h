@@ -7,10 +7,23 @@
 #include "dns.h"
 #include "proxy.h"
 
+#include <memory>
 #include <optional>
+#include <vector>
 
 namespace asynchost
 {
+  /** Buffer written to a TCP socket. If owner is set, the bytes are not
+   * copied and owner is held until they have been written. Otherwise, the
+   * bytes are copied when the write is issued.
+   */
+  struct WriteBuffer
+  {
+    const uint8_t* data;
+    size_t len;
+    std::shared_ptr<const void> owner = nullptr;
+  };
+
   class TCPImpl;
   using TCP = proxy_ptr<TCPImpl>;
 
@@ -77,21 +90,57 @@ namespace asynchost
       RECONNECTING
     };
 
-    struct PendingWrite
+    // Buffers submitted to the socket with a single uv_write. Copied bytes
+    // are appended to copies, which is not reallocated once the request is
+    // submitted.
+    struct WriteRequest
     {
-      uv_write_t* req;
-      size_t len;
+      uv_write_t req;
 
-      PendingWrite(uv_write_t* req, size_t len) : req(req), len(len) {}
+      struct Segment
+      {
+        // If data is nullptr, the bytes start at offset in copies
+        const uint8_t* data;
+        size_t offset;
+        size_t len;
+      };
+      std::vector<Segment> segments;
+      std::vector<uint8_t> copies;
+      std::vector<std::shared_ptr<const void>> owners;
+      std::vector<uv_buf_t> bufs;
+      size_t len = 0;
 
-      PendingWrite(PendingWrite&& that) : req(that.req), len(that.len)
+      void append(const WriteBuffer& buffer)
       {
-        that.req = nullptr;
+        if (buffer.owner != nullptr)
+        {
+          segments.push_back({buffer.data, 0, buffer.len});
+          owners.push_back(buffer.owner);
+        }
+        else
+        {
+          segments.push_back({nullptr, copies.size(), buffer.len});
+          if (buffer.data != nullptr)
+          {
+            copies.insert(
+              copies.end(), buffer.data, buffer.data + buffer.len);
+          }
+          else
+          {
+            copies.resize(copies.size() + buffer.len);
+          }
+        }
+        len += buffer.len;
       }
 
-      ~PendingWrite()
+      void init_bufs()
       {
-        free_write(req);
+        bufs.clear();
+        for (const auto& s : segments)
+        {
+          auto base = s.data != nullptr ? s.data : copies.data() + s.offset;
+          bufs.push_back(uv_buf_init((char*)base, s.len));
+        }
       }
     };
 
@@ -99,7 +148,11 @@ namespace asynchost
     size_t connection_timeout = 0;
     Status status;
     std::unique_ptr<TCPBehaviour> behaviour;
-    std::vector<PendingWrite> pending_writes;
+
+    // Writes issued before the socket is connected, or while earlier writes
+    // are still being written to the socket, are coalesced and submitted
+    // together once it is connected or once those writes are done
+    std::unique_ptr<WriteRequest> queued_write = nullptr;
 
     std::string host;
     std::string service;
@@ -313,11 +366,18 @@ namespace asynchost
 
     bool write(size_t len, const uint8_t* data)
     {
-      auto req = new uv_write_t;
-      char* copy = new char[len];
-      if (data)
-        memcpy(copy, data, len);
-      req->data = copy;
+      return write({{data, len}});
+    }
+
+    // Writes all buffers to the socket, as a single vectored write if the
+    // socket is ready
+    bool write(const std::vector<WriteBuffer>& buffers)
+    {
+      size_t len = 0;
+      for (const auto& buffer : buffers)
+      {
+        len += buffer.len;
+      }
 
       switch (status)
       {
@@ -329,25 +389,31 @@ namespace asynchost
         case CONNECTING_FAILED:
         case RECONNECTING:
         {
-          pending_writes.emplace_back(req, len);
+          queue_write(buffers);
           break;
         }
 
         case CONNECTED:
         {
-          return send_write(req, len);
+          queue_write(buffers);
+
+          // Writes are coalesced while the socket is busy, and submitted once
+          // earlier writes are done (see on_write())
+          if (uv_handle.write_queue_size == 0)
+          {
+            return send_queued_write();
+          }
+          break;
         }
 
         case DISCONNECTED:
         {
           LOG_DEBUG_FMT("Disconnected: Ignoring write of size {}", len);
-          free_write(req);
           break;
         }
 
         default:
         {
-          free_write(req);
           throw std::logic_error(
             fmt::format("Unexpected status during write: {}", status));
         }
@@ -401,19 +467,39 @@ namespace asynchost
       return true;
     }
 
-    bool send_write(uv_write_t* req, size_t len)
+    void queue_write(const std::vector<WriteBuffer>& buffers)
     {
-      char* copy = (char*)req->data;
+      if (queued_write == nullptr)
+      {
+        queued_write = std::make_unique<WriteRequest>();
+      }
+      for (const auto& buffer : buffers)
+      {
+        queued_write->append(buffer);
+      }
+    }
 
-      uv_buf_t buf;
-      buf.base = copy;
-      buf.len = len;
+    bool send_queued_write()
+    {
+      if (queued_write == nullptr)
+      {
+        return true;
+      }
 
-      int rc;
+      auto write_req = queued_write.release();
+      write_req->req.data = write_req;
+      write_req->init_bufs();
 
-      if ((rc = uv_write(req, (uv_stream_t*)&uv_handle, &buf, 1, on_write)) < 0)
-      {
-        free_write(req);
+      int rc;
+      if (
+        (rc = uv_write(
+           &write_req->req,
+           (uv_stream_t*)&uv_handle,
+           write_req->bufs.data(),
+           write_req->bufs.size(),
+           on_write)) < 0)
+      {
+        delete write_req;
         LOG_FAIL_FMT("uv_write failed: {}", uv_strerror(rc));
         assert_status(CONNECTED, DISCONNECTED);
         behaviour->on_disconnect();
@@ -691,13 +777,7 @@ namespace asynchost
           return;
         }
 
-        for (auto& w : pending_writes)
-        {
-          send_write(w.req, w.len);
-          w.req = nullptr;
-        }
-
-        std::vector<PendingWrite>().swap(pending_writes);
+        send_queued_write();
         behaviour->on_connect();
       }
     }
@@ -771,6 +851,7 @@ namespace asynchost
       if (sz < 0)
       {
         assert_status(CONNECTED, DISCONNECTED);
+        queued_write = nullptr;
         on_free(buf);
         uv_read_stop((uv_stream_t*)&uv_handle);
 
@@ -786,19 +867,28 @@ namespace asynchost
         on_free(buf);
     }
 
-    static void on_write(uv_write_t* req, int)
+    static void on_write(uv_write_t* req, int rc)
     {
-      free_write(req);
+      auto self = static_cast<TCPImpl*>(req->handle->data);
+      delete static_cast<WriteRequest*>(req->data);
+
+      if (rc != UV_ECANCELED)
+      {
+        self->on_write();
+      }
     }
 
-    static void free_write(uv_write_t* req)
+    void on_write()
     {
-      if (req == nullptr)
-        return;
-
-      char* copy = (char*)req->data;
-      delete[] copy;
-      delete req;
+      // Writes coalesced while the socket was busy are submitted once all
+      // earlier writes are done
+      if (
+        status == CONNECTED && queued_write != nullptr &&
+        uv_handle.write_queue_size == 0 &&
+        !uv_is_closing((uv_handle_t*)&uv_handle))
+      {
+        send_queued_write();
+      }
     }
 
     static void on_reconnect(uv_handle_t* handle)
@@ -8,7 +8,9 @@
 #include "kv/serialised_entry_format.h"
 
 #include <doctest/doctest.h>
+#include <fstream>
 #include <string>
+#include <thread>
 
 using namespace asynchost;
 
@@ -82,7 +84,11 @@ size_t number_of_files_in_ledger_dir()
   size_t file_count = 0;
   for (auto const& f : fs::directory_iterator(ledger_dir))
   {
-    file_count++;
+    // Index files are written alongside ledger files
+    if (!is_ledger_index_file(f.path().filename()))
+    {
+      file_count++;
+    }
   }
   return file_count;
 }
@@ -156,6 +162,7 @@ class TestEntrySubmitter
 private:
   Ledger& ledger;
   size_t last_idx;
+  consensus::Term term = 2;
 
 public:
   TestEntrySubmitter(Ledger& ledger, size_t initial_last_idx = 0) :
@@ -168,6 +175,11 @@ public:
     return last_idx;
   }
 
+  void set_term(consensus::Term term_)
+  {
+    term = term_;
+  }
+
   void write(bool is_committable, bool force_chunk = false)
   {
     auto e = TestLedgerEntry(++last_idx);
@@ -186,7 +198,8 @@ public:
         framed_entry.data(),
         framed_entry.size(),
         is_committable,
-        force_chunk) == last_idx);
+        force_chunk,
+        term) == last_idx);
   }
 
   void truncate(size_t idx)
@@ -697,6 +710,17 @@ size_t number_open_fd()
   return fd_count;
 }
 
+// Committed files are closed by the ledger syncer thread once synced
+void wait_for_number_open_fd(size_t count)
+{
+  constexpr size_t max_attempts = 1000;
+  for (size_t i = 0; i < max_attempts && number_open_fd() != count; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  REQUIRE(number_open_fd() == count);
+}
+
 TEST_CASE("Limit number of open files")
 {
   fs::remove_all(ledger_dir);
@@ -727,21 +751,21 @@ TEST_CASE("Limit number of open files")
     REQUIRE(number_open_fd() == initial_number_fd + chunk_count + 1);
 
     ledger.commit(end_of_first_chunk_idx); // One file now committed
-    REQUIRE(number_open_fd() == initial_number_fd + chunk_count);
+    wait_for_number_open_fd(initial_number_fd + chunk_count);
     read_entry_from_ledger(ledger, 1);
     read_entries_range_from_ledger(ledger, 1, end_of_first_chunk_idx);
     // Committed file is open in read cache
     REQUIRE(number_open_fd() == initial_number_fd + chunk_count + 1);
 
     ledger.commit(2 * end_of_first_chunk_idx); // Two files now committed
-    REQUIRE(number_open_fd() == initial_number_fd + chunk_count);
+    wait_for_number_open_fd(initial_number_fd + chunk_count);
     read_entries_range_from_ledger(ledger, 1, 2 * end_of_first_chunk_idx);
     // Two committed files open in read cache
     REQUIRE(number_open_fd() == initial_number_fd + chunk_count + 1);
 
     ledger.commit(last_idx); // All but one file committed
     // One file open for write, two files open for read
-    REQUIRE(number_open_fd() == initial_number_fd + 3);
+    wait_for_number_open_fd(initial_number_fd + 3);
 
     read_entries_range_from_ledger(ledger, 1, last_idx);
     // Number of open files is capped by size of read cache
@@ -766,7 +790,7 @@ TEST_CASE("Limit number of open files")
     ledger.commit(last_idx);
 
     read_entries_range_from_ledger(ledger, 1, last_idx);
-    REQUIRE(number_open_fd() == initial_number_fd + max_read_cache_size);
+    wait_for_number_open_fd(initial_number_fd + max_read_cache_size);
   }
 
   INFO("Still possible to recover a new ledger");
@@ -1122,3 +1146,748 @@ TEST_CASE("Find latest snapshot with corresponding ledger chunk")
         snapshot_idx, snapshot_evidence_idx, snapshot_evidence_commit_idx));
   }
 }
+
+TEST_CASE("Find latest delta snapshot and its base")
+{
+  fs::remove_all(ledger_dir);
+  fs::remove_all(snapshot_dir);
+
+  size_t chunk_threshold = 30;
+  size_t chunk_count = 5;
+
+  Ledger ledger(ledger_dir, wf, chunk_threshold);
+  TestEntrySubmitter entry_submitter(ledger);
+
+  SnapshotManager snapshots(snapshot_dir, ledger);
+
+  initialise_ledger(entry_submitter, chunk_threshold, chunk_count);
+  size_t last_idx = entry_submitter.get_last_idx();
+  ledger.commit(last_idx);
+
+  // Assumes evidence idx and evidence commit idx as next indices
+  size_t full_idx = last_idx / 4;
+  size_t delta_idx = last_idx / 2;
+  const auto full_snapshot = std::vector<uint8_t>(128, 1);
+  const auto delta_snapshot = std::vector<uint8_t>(32, 2);
+
+  snapshots.write_snapshot(
+    full_idx, full_idx + 1, full_snapshot.data(), full_snapshot.size());
+  snapshots.write_snapshot(
+    delta_idx,
+    delta_idx + 1,
+    delta_snapshot.data(),
+    delta_snapshot.size(),
+    full_idx);
+
+  INFO("Delta snapshot is ignored while its base is not committed");
+  {
+    snapshots.commit_snapshot(delta_idx, delta_idx + 2);
+    REQUIRE_FALSE(snapshots.find_latest_committed_snapshot().has_value());
+  }
+
+  INFO("Delta snapshot is resolved from its committed base");
+  {
+    snapshots.commit_snapshot(full_idx, full_idx + 2);
+
+    auto latest = snapshots.find_latest_committed_snapshot();
+    REQUIRE(latest.has_value());
+    REQUIRE(
+      get_snapshot_evidence_idx_from_file_name(latest.value()) ==
+      std::make_pair(delta_idx + 1, delta_idx + 2));
+    REQUIRE(
+      get_snapshot_delta_base_idx_from_file_name(latest.value()) == full_idx);
+
+    auto chain = snapshots.get_snapshot_chain(latest.value());
+    REQUIRE(chain.has_value());
+    REQUIRE(chain->size() == 2);
+    REQUIRE(
+      fmt::format("{}/{}", snapshot_dir, chain->front()) ==
+      get_snapshot_file_name(full_idx, full_idx + 1, full_idx + 2));
+    REQUIRE(chain->back() == latest.value());
+
+    auto expected_snapshot = full_snapshot;
+    expected_snapshot.insert(
+      expected_snapshot.end(), delta_snapshot.begin(), delta_snapshot.end());
+    REQUIRE(snapshots.read_snapshot_chain(chain.value()) == expected_snapshot);
+  }
+}
+
+TEST_CASE("Streamed snapshot chunks")
+{
+  fs::remove_all(ledger_dir);
+  fs::remove_all(snapshot_dir);
+
+  size_t chunk_threshold = 30;
+  Ledger ledger(ledger_dir, wf, chunk_threshold);
+  TestEntrySubmitter entry_submitter(ledger);
+  initialise_ledger(entry_submitter, chunk_threshold, 2);
+  size_t last_idx = entry_submitter.get_last_idx();
+  ledger.commit(last_idx);
+
+  SnapshotManager snapshots(snapshot_dir, ledger);
+
+  size_t snapshot_idx = last_idx / 2;
+  const auto stale_chunk = std::vector<uint8_t>(16, 1);
+  const auto first_chunk = std::vector<uint8_t>(16, 2);
+  const auto second_chunk = std::vector<uint8_t>(8, 3);
+
+  INFO("Discarded chunks are not written");
+  {
+    snapshots.append_snapshot_chunk(
+      snapshot_idx, true, stale_chunk.data(), stale_chunk.size());
+    snapshots.discard_pending_snapshot(snapshot_idx);
+    snapshots.write_pending_snapshot(snapshot_idx, snapshot_idx + 1, 0);
+    REQUIRE(fs::is_empty(snapshot_dir));
+  }
+
+  INFO("First chunk replaces chunks from an abandoned snapshot");
+  {
+    snapshots.append_snapshot_chunk(
+      snapshot_idx, true, stale_chunk.data(), stale_chunk.size());
+    snapshots.append_snapshot_chunk(
+      snapshot_idx, true, first_chunk.data(), first_chunk.size());
+    snapshots.append_snapshot_chunk(
+      snapshot_idx, false, second_chunk.data(), second_chunk.size());
+    snapshots.write_pending_snapshot(snapshot_idx, snapshot_idx + 1, 0);
+    snapshots.commit_snapshot(snapshot_idx, snapshot_idx + 2);
+
+    auto latest = snapshots.find_latest_committed_snapshot();
+    REQUIRE(latest.has_value());
+
+    auto expected_snapshot = first_chunk;
+    expected_snapshot.insert(
+      expected_snapshot.end(), second_chunk.begin(), second_chunk.end());
+    REQUIRE(snapshots.read_snapshot(latest.value()) == expected_snapshot);
+  }
+}
+
+TEST_CASE("Read bounded ranges of entries")
+{
+  fs::remove_all(ledger_dir);
+
+  size_t chunk_threshold = 30;
+  size_t chunk_count = 3;
+  size_t entry_size =
+    kv::serialised_entry_header_size + sizeof(TestLedgerEntry);
+
+  Ledger ledger(ledger_dir, wf, chunk_threshold);
+  TestEntrySubmitter entry_submitter(ledger);
+  size_t entries_per_chunk =
+    initialise_ledger(entry_submitter, chunk_threshold, chunk_count);
+  size_t last_idx = entry_submitter.get_last_idx();
+
+  INFO("Invalid ranges");
+  {
+    REQUIRE_FALSE(
+      ledger.read_framed_entries_up_to_size(0, 1, entry_size).has_value());
+    REQUIRE_FALSE(
+      ledger.read_framed_entries_up_to_size(2, 1, entry_size).has_value());
+    REQUIRE_FALSE(ledger
+                    .read_framed_entries_up_to_size(
+                      1, last_idx + 1, last_idx * entry_size)
+                    .has_value());
+  }
+
+  INFO("Whole ledger fits in a single range, across chunks");
+  {
+    auto entries =
+      ledger.read_framed_entries_up_to_size(1, last_idx, last_idx * entry_size);
+    REQUIRE(entries.has_value());
+    REQUIRE(entries->first == last_idx);
+    verify_framed_entries_range(entries->second, 1, last_idx);
+  }
+
+  INFO("Ranges are bounded by size");
+  {
+    const size_t max_entries = entries_per_chunk + 1;
+    size_t idx = 1;
+    while (idx <= last_idx)
+    {
+      auto entries = ledger.read_framed_entries_up_to_size(
+        idx, last_idx, max_entries * entry_size);
+      REQUIRE(entries.has_value());
+      REQUIRE(entries->first == std::min(idx + max_entries - 1, last_idx));
+      verify_framed_entries_range(entries->second, idx, entries->first);
+      idx = entries->first + 1;
+    }
+  }
+
+  INFO("At least one entry is always returned");
+  {
+    auto entries = ledger.read_framed_entries_up_to_size(2, last_idx, 1);
+    REQUIRE(entries.has_value());
+    REQUIRE(entries->first == 2);
+    verify_framed_entries_range(entries->second, 2, 2);
+  }
+}
+
+TEST_CASE("Committed ledger files are read from mapped memory")
+{
+  fs::remove_all(ledger_dir);
+
+  size_t chunk_threshold = 30;
+  size_t chunk_count = 3;
+
+  Ledger ledger(ledger_dir, wf, chunk_threshold);
+  TestEntrySubmitter entry_submitter(ledger);
+  size_t entries_per_chunk =
+    initialise_ledger(entry_submitter, chunk_threshold, chunk_count);
+  size_t last_idx = entry_submitter.get_last_idx();
+  size_t end_of_first_chunk_idx = entries_per_chunk;
+
+  INFO("Uncommitted entries are not mapped");
+  {
+    REQUIRE_FALSE(
+      ledger.get_mapped_framed_entries_up_to_size(1, end_of_first_chunk_idx)
+        .has_value());
+  }
+
+  ledger.commit(end_of_first_chunk_idx);
+
+  INFO("Committed entries are mapped");
+  {
+    auto mapped =
+      ledger.get_mapped_framed_entries_up_to_size(1, end_of_first_chunk_idx);
+    REQUIRE(mapped.has_value());
+    REQUIRE(mapped->last_idx == end_of_first_chunk_idx);
+    std::vector<uint8_t> entries(
+      mapped->entries.data, mapped->entries.data + mapped->entries.size);
+    verify_framed_entries_range(entries, 1, end_of_first_chunk_idx);
+
+    read_entries_range_from_ledger(ledger, 1, end_of_first_chunk_idx);
+    read_entry_from_ledger(ledger, end_of_first_chunk_idx);
+  }
+
+  INFO("Mapped entries do not span over uncommitted files");
+  {
+    auto mapped = ledger.get_mapped_framed_entries_up_to_size(2, last_idx);
+    REQUIRE(mapped.has_value());
+    REQUIRE(mapped->last_idx == end_of_first_chunk_idx);
+    REQUIRE_FALSE(ledger
+                    .get_mapped_framed_entries_up_to_size(
+                      end_of_first_chunk_idx + 1, last_idx)
+                    .has_value());
+    read_entries_range_from_ledger(ledger, 1, last_idx);
+  }
+
+  INFO("Mapped entries are bounded by size");
+  {
+    auto mapped = ledger.get_mapped_framed_entries_up_to_size(1, last_idx, 1);
+    REQUIRE(mapped.has_value());
+    REQUIRE(mapped->last_idx == 1);
+  }
+
+  INFO("Committed files recovered from disk are mapped");
+  {
+    ledger.commit(last_idx);
+    Ledger ledger2(ledger_dir, wf, chunk_threshold);
+    auto mapped = ledger2.get_mapped_framed_entries_up_to_size(
+      end_of_first_chunk_idx + 1, last_idx);
+    REQUIRE(mapped.has_value());
+    REQUIRE(mapped->last_idx == 2 * end_of_first_chunk_idx);
+    read_entries_range_from_ledger(ledger2, 1, last_idx);
+  }
+}
+
+std::vector<uint8_t> concat_cached_framed_entries(
+  const std::vector<CachedFramedEntries>& cached)
+{
+  std::vector<uint8_t> entries;
+  for (const auto& c : cached)
+  {
+    entries.insert(
+      entries.end(), c.entries.data, c.entries.data + c.entries.size);
+  }
+  return entries;
+}
+
+TEST_CASE("Recently written entries are read from the tail cache")
+{
+  fs::remove_all(ledger_dir);
+
+  size_t chunk_threshold = 30;
+  size_t chunk_count = 3;
+
+  Ledger ledger(ledger_dir, wf, chunk_threshold);
+  TestEntrySubmitter entry_submitter(ledger);
+  initialise_ledger(entry_submitter, chunk_threshold, chunk_count);
+  size_t last_idx = entry_submitter.get_last_idx();
+
+  INFO("Entries across ledger files are cached");
+  {
+    auto cached = ledger.get_cached_framed_entries(1, last_idx);
+    REQUIRE(cached.has_value());
+    auto entries = concat_cached_framed_entries(cached.value());
+    verify_framed_entries_range(entries, 1, last_idx);
+    REQUIRE(entries == ledger.read_framed_entries(1, last_idx).value());
+
+    REQUIRE_FALSE(ledger.get_cached_framed_entries(0, last_idx).has_value());
+    REQUIRE_FALSE(
+      ledger.get_cached_framed_entries(1, last_idx + 1).has_value());
+  }
+
+  INFO("Cached entries held by readers outlive truncation");
+  {
+    auto cached = ledger.get_cached_framed_entries(1, last_idx);
+    REQUIRE(cached.has_value());
+
+    entry_submitter.truncate(last_idx - 2);
+    REQUIRE_FALSE(
+      ledger.get_cached_framed_entries(last_idx - 1, last_idx).has_value());
+    verify_framed_entries_range(
+      concat_cached_framed_entries(cached.value()), 1, last_idx);
+
+    entry_submitter.write(true);
+    auto rewritten = ledger.get_cached_framed_entries(1, last_idx - 1);
+    REQUIRE(rewritten.has_value());
+    verify_framed_entries_range(
+      concat_cached_framed_entries(rewritten.value()), 1, last_idx - 1);
+  }
+
+  INFO("Disabled cache");
+  {
+    ledger.set_tail_cache_size(0);
+    REQUIRE_FALSE(ledger.get_cached_framed_entries(1, 1).has_value());
+    entry_submitter.write(true);
+    REQUIRE_FALSE(
+      ledger
+        .get_cached_framed_entries(
+          entry_submitter.get_last_idx(), entry_submitter.get_last_idx())
+        .has_value());
+  }
+}
+
+TEST_CASE("Tail cache blocks")
+{
+  size_t entry_size = 10;
+  size_t block_size = 4 * entry_size;
+  LedgerTailCache cache(3 * block_size, block_size);
+
+  auto append = [&](size_t idx) {
+    cache.append(idx, std::vector<uint8_t>(entry_size, idx).data(), entry_size);
+  };
+  auto check = [&](size_t from, size_t to) {
+    auto cached = cache.get_framed_entries(from, to);
+    REQUIRE(cached.has_value());
+    auto entries = concat_cached_framed_entries(cached.value());
+    REQUIRE(entries.size() == (to - from + 1) * entry_size);
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+      REQUIRE(entries[i] == from + i / entry_size);
+    }
+    return cached->size();
+  };
+
+  INFO("Entries are spread across blocks");
+  {
+    for (size_t idx = 1; idx <= 12; ++idx)
+    {
+      append(idx);
+    }
+    REQUIRE(cache.get_cached_size() == 3 * block_size);
+    REQUIRE(check(1, 4) == 1);
+    REQUIRE(check(4, 5) == 2);
+    REQUIRE(check(1, 12) == 3);
+  }
+
+  INFO("Oldest blocks are evicted");
+  {
+    append(13);
+    REQUIRE(cache.get_cached_size() == 3 * block_size);
+    REQUIRE_FALSE(cache.get_framed_entries(4, 13).has_value());
+    REQUIRE(check(5, 13) == 3);
+  }
+
+  INFO("Large entries are cached in their own block");
+  {
+    cache.append(
+      14, std::vector<uint8_t>(2 * block_size, 14).data(), 2 * block_size);
+    REQUIRE_FALSE(cache.get_framed_entries(12, 14).has_value());
+    REQUIRE(cache.get_framed_entries(13, 14).has_value());
+  }
+
+  INFO("Non-contiguous entries reset the cache");
+  {
+    append(20);
+    REQUIRE_FALSE(cache.get_framed_entries(14, 14).has_value());
+    REQUIRE(check(20, 20) == 1);
+  }
+}
+
+void wait_for_durable_idx(Ledger& ledger, size_t idx)
+{
+  constexpr size_t max_attempts = 1000;
+  for (size_t i = 0; i < max_attempts && ledger.get_durable_idx() < idx; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ledger.tick(std::chrono::milliseconds(0));
+  }
+  REQUIRE(ledger.get_durable_idx() == idx);
+}
+
+// Returns the index reported by the last ledger_durable message sent to the
+// enclave, if any, discarding all other messages
+std::optional<size_t> read_last_reported_durable_idx()
+{
+  std::optional<size_t> durable_idx = std::nullopt;
+  eio.read_from_outside().read(
+    -1, [&](ringbuffer::Message m, const uint8_t* data, size_t size) {
+      if (m == consensus::ledger_durable)
+      {
+        durable_idx = serialized::read<consensus::Index>(data, size);
+      }
+    });
+  return durable_idx;
+}
+
+TEST_CASE("Durable watermark")
+{
+  fs::remove_all(ledger_dir);
+
+  size_t chunk_threshold = 30;
+  const auto sync_interval = std::chrono::milliseconds(10);
+
+  Ledger ledger(ledger_dir, wf, chunk_threshold);
+  ledger.set_sync_policy(std::numeric_limits<size_t>::max(), sync_interval);
+  TestEntrySubmitter entry_submitter(ledger);
+
+  INFO("Entries are synced once the sync interval has elapsed");
+  {
+    size_t chunk_count = 2;
+    initialise_ledger(entry_submitter, chunk_threshold, chunk_count);
+    entry_submitter.write(false);
+
+    ledger.tick(std::chrono::milliseconds(0));
+    REQUIRE(ledger.get_durable_idx() == 0);
+
+    ledger.tick(sync_interval);
+    wait_for_durable_idx(ledger, entry_submitter.get_last_idx());
+  }
+
+  INFO("Truncation lowers the durable watermark");
+  {
+    read_last_reported_durable_idx();
+    auto truncation_idx = entry_submitter.get_last_idx() - 2;
+    entry_submitter.truncate(truncation_idx);
+    REQUIRE(ledger.get_durable_idx() == truncation_idx);
+    REQUIRE(read_last_reported_durable_idx() == truncation_idx);
+
+    // Truncating at or above the watermark leaves it unchanged
+    entry_submitter.truncate(truncation_idx);
+    REQUIRE(!read_last_reported_durable_idx().has_value());
+  }
+
+  INFO("Entries are synced once enough bytes have been written");
+  {
+    ledger.set_sync_policy(1, std::chrono::milliseconds::max());
+    entry_submitter.write(false);
+    ledger.tick(std::chrono::milliseconds(0));
+    entry_submitter.write(true);
+    wait_for_durable_idx(ledger, entry_submitter.get_last_idx());
+  }
+
+  INFO("Committed files are synced on the syncer thread");
+  {
+    ledger.set_sync_policy(std::numeric_limits<size_t>::max(), sync_interval);
+    for (size_t i = 0; i < 2 * get_entries_per_chunk(chunk_threshold); ++i)
+    {
+      entry_submitter.write(true);
+    }
+    auto last_idx = entry_submitter.get_last_idx();
+    ledger.commit(last_idx);
+
+    // Even though the committed files are no longer written to, the next
+    // sync reports that their entries are durable
+    ledger.tick(sync_interval);
+    wait_for_durable_idx(ledger, last_idx);
+  }
+}
+
+size_t number_of_preallocated_files_in_ledger_dir()
+{
+  size_t preallocated_file_count = 0;
+  for (auto const& f : fs::directory_iterator(ledger_dir))
+  {
+    if (is_ledger_file_preallocated(f.path().filename()))
+    {
+      preallocated_file_count++;
+    }
+  }
+  return preallocated_file_count;
+}
+
+void wait_for_preallocated_files(size_t count)
+{
+  constexpr size_t max_attempts = 1000;
+  for (size_t i = 0;
+       i < max_attempts && number_of_preallocated_files_in_ledger_dir() < count;
+       ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  REQUIRE(number_of_preallocated_files_in_ledger_dir() == count);
+}
+
+TEST_CASE("Pre-allocated chunk files")
+{
+  fs::remove_all(ledger_dir);
+
+  size_t chunk_threshold = 30;
+  size_t chunk_count = 4;
+  size_t pool_size = 2;
+  size_t last_idx = 0;
+
+  {
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    ledger.set_chunk_pool_size(pool_size);
+    TestEntrySubmitter entry_submitter(ledger);
+
+    INFO("Chunk files are created ahead of time");
+    {
+      wait_for_preallocated_files(pool_size);
+    }
+
+    INFO("New chunks are started from pre-allocated files");
+    {
+      size_t entries_per_chunk = get_entries_per_chunk(chunk_threshold);
+      for (size_t i = 0; i < entries_per_chunk * chunk_count; i++)
+      {
+        entry_submitter.write(true);
+      }
+      // Incomplete chunk
+      entry_submitter.write(false);
+      last_idx = entry_submitter.get_last_idx();
+
+      wait_for_preallocated_files(pool_size);
+      REQUIRE(
+        number_of_files_in_ledger_dir() == chunk_count + 1 + pool_size);
+      read_entries_range_from_ledger(ledger, 1, last_idx);
+    }
+
+    INFO("Completed chunks only contain entries and positions table");
+    {
+      for (auto const& f : fs::directory_iterator(ledger_dir))
+      {
+        if (!is_ledger_file_preallocated(f.path().filename()))
+        {
+          REQUIRE(fs::file_size(f.path()) <= 2 * chunk_threshold);
+        }
+      }
+    }
+  }
+
+  INFO("Unused pre-allocated files are removed");
+  {
+    REQUIRE(number_of_preallocated_files_in_ledger_dir() == 0);
+  }
+
+  INFO("Ledger written to pre-allocated files can be recovered");
+  {
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    REQUIRE(ledger.get_last_idx() == last_idx);
+    read_entries_range_from_ledger(ledger, 1, last_idx);
+  }
+}
+
+TEST_CASE("Recover many ledger files")
+{
+  fs::remove_all(ledger_dir);
+
+  size_t chunk_threshold = 30;
+  size_t chunk_count = 4 * ledger_recovery_max_threads;
+  size_t corrupt_file_count = 3;
+  size_t last_idx = 0;
+
+  INFO("Write many chunks, some committed, and an incomplete one");
+  {
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    TestEntrySubmitter entry_submitter(ledger);
+    size_t entries_per_chunk =
+      initialise_ledger(entry_submitter, chunk_threshold, chunk_count);
+    ledger.commit((chunk_count / 2) * entries_per_chunk);
+    entry_submitter.write(false);
+    entry_submitter.write(false);
+    last_idx = entry_submitter.get_last_idx();
+  }
+
+  for (size_t i = 0; i < corrupt_file_count; ++i)
+  {
+    std::ofstream f(
+      fs::path(ledger_dir) / fmt::format("ledger_{}", last_idx + 100 + i));
+    f << "not a ledger file";
+  }
+
+  INFO("All files are recovered, and corrupt ones are ignored");
+  {
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    REQUIRE(ledger.get_last_idx() == last_idx);
+    read_entries_range_from_ledger(ledger, 1, last_idx);
+
+    size_t renamed_corrupt_files = 0;
+    for (auto const& f : fs::directory_iterator(ledger_dir))
+    {
+      if (is_ledger_file_name_corrupted(f.path().filename()))
+      {
+        renamed_corrupt_files++;
+      }
+    }
+    REQUIRE(renamed_corrupt_files == corrupt_file_count);
+  }
+}
+
+TEST_CASE("Committed ledger files are not opened on recovery")
+{
+  fs::remove_all(ledger_dir);
+
+  size_t chunk_threshold = 30;
+  size_t chunk_count = 5;
+  size_t committed_idx = 0;
+  size_t last_idx = 0;
+
+  INFO("Write some committed chunks, and some uncommitted entries");
+  {
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    TestEntrySubmitter entry_submitter(ledger);
+    size_t entries_per_chunk =
+      initialise_ledger(entry_submitter, chunk_threshold, chunk_count);
+    committed_idx = 2 * entries_per_chunk;
+    ledger.commit(committed_idx);
+    entry_submitter.write(false);
+    last_idx = entry_submitter.get_last_idx();
+  }
+  REQUIRE(number_of_committed_files_in_ledger_dir() == 2);
+
+  // Overwrite the contents of committed files, which would make them corrupt
+  // if they were opened
+  for (auto const& f : fs::directory_iterator(ledger_dir))
+  {
+    if (is_ledger_file_committed(f.path().filename()))
+    {
+      std::ofstream(f.path(), std::ios::trunc) << "not a ledger file";
+    }
+  }
+
+  INFO("Committed files are recovered from their names alone");
+  {
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    REQUIRE(ledger.get_last_idx() == last_idx);
+    read_entries_range_from_ledger(ledger, committed_idx + 1, last_idx);
+
+    for (auto const& f : fs::directory_iterator(ledger_dir))
+    {
+      REQUIRE_FALSE(is_ledger_file_name_corrupted(f.path().filename()));
+    }
+
+    // Entries cannot be truncated before the recovered commit idx
+    ledger.truncate(committed_idx - 1);
+    REQUIRE(ledger.get_last_idx() == last_idx);
+  }
+}
+
+TEST_CASE("Recover incomplete ledger file from index")
+{
+  fs::remove_all(ledger_dir);
+
+  size_t chunk_threshold = 1000;
+  const auto ledger_file = fs::path(ledger_dir) / "ledger_1";
+  const auto index_file = fs::path(ledger_dir) /
+    fmt::format("ledger_1.{}", ledger_index_file_suffix);
+  auto index_record_count = [&]() {
+    return fs::file_size(index_file) / sizeof(LedgerIndexRecord);
+  };
+  size_t last_idx = 0;
+
+  INFO("Index records are written once entries are flushed");
+  {
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    ledger.set_sync_policy(0, std::chrono::milliseconds::max());
+    TestEntrySubmitter entry_submitter(ledger);
+
+    entry_submitter.write(false);
+    entry_submitter.write(true);
+    entry_submitter.set_term(3);
+    entry_submitter.write(false);
+    entry_submitter.write(true);
+    REQUIRE(index_record_count() == 4);
+
+    entry_submitter.write(false);
+    entry_submitter.write(false);
+    REQUIRE(index_record_count() == 4);
+    last_idx = entry_submitter.get_last_idx();
+  }
+
+  INFO("Positions and terms are recovered from index");
+  {
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    REQUIRE(ledger.get_last_idx() == last_idx);
+    read_entries_range_from_ledger(ledger, 1, last_idx);
+
+    REQUIRE(ledger.get_term(1) == 2);
+    REQUIRE(ledger.get_term(2) == 2);
+    REQUIRE(ledger.get_term(3) == 3);
+    REQUIRE(ledger.get_term(4) == 3);
+    // Entries written after the last index record have an unknown term
+    REQUIRE_FALSE(ledger.get_term(5).has_value());
+    REQUIRE_FALSE(ledger.get_term(last_idx + 1).has_value());
+  }
+
+  INFO("Truncation removes index records of truncated entries");
+  {
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    ledger.set_sync_policy(0, std::chrono::milliseconds::max());
+    TestEntrySubmitter entry_submitter(ledger, last_idx);
+
+    entry_submitter.truncate(3);
+    REQUIRE(index_record_count() == 3);
+
+    entry_submitter.set_term(4);
+    entry_submitter.write(false);
+    entry_submitter.write(true);
+    REQUIRE(index_record_count() == 5);
+    last_idx = entry_submitter.get_last_idx();
+  }
+
+  INFO("Indexed entries are not read on recovery");
+  {
+    // Corrupt the header of the first entry
+    std::fstream f(
+      ledger_file, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(sizeof(size_t));
+    kv::SerialisedEntryHeader header;
+    header.set_size(chunk_threshold * 2);
+    f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    f.close();
+
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    REQUIRE(ledger.get_last_idx() == last_idx);
+    read_entries_range_from_ledger(ledger, 2, last_idx);
+    REQUIRE(ledger.get_term(3) == 3);
+    REQUIRE(ledger.get_term(last_idx) == 4);
+  }
+
+  INFO("Index inconsistent with ledger file is ignored");
+  {
+    // Restore the header of the first entry
+    std::fstream f(
+      ledger_file, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(sizeof(size_t));
+    kv::SerialisedEntryHeader header;
+    header.set_size(sizeof(TestLedgerEntry));
+    f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    f.close();
+
+    // Index claiming that the file contains a single entry
+    LedgerIndexRecord record{5,
+                             sizeof(size_t),
+                             static_cast<uint32_t>(
+                               fs::file_size(ledger_file) - sizeof(size_t))};
+    std::ofstream index(index_file, std::ios::binary | std::ios::trunc);
+    index.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    index.close();
+
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    REQUIRE(ledger.get_last_idx() == last_idx);
+    read_entries_range_from_ledger(ledger, 1, last_idx);
+    REQUIRE_FALSE(ledger.get_term(1).has_value());
+  }
+}
@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#include "host/ledger.h"
+#include "kv/serialised_entry_format.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#define PICOBENCH_IMPLEMENT
+#include <picobench/picobench.hpp>
+
+using namespace asynchost;
+
+static constexpr auto ledger_dir = "ledger_bench_dir";
+
+// Small chunks, so that each sample crosses many chunk boundaries
+static constexpr size_t chunk_threshold = 1 << 16;
+
+constexpr auto buffer_size = 1 << 16;
+auto in_buffer = std::make_unique<ringbuffer::TestBuffer>(buffer_size);
+auto out_buffer = std::make_unique<ringbuffer::TestBuffer>(buffer_size);
+ringbuffer::Circuit eio(in_buffer->bd, out_buffer->bd);
+auto wf = ringbuffer::WriterFactory(eio);
+
+static std::vector<uint8_t> make_entry(size_t size)
+{
+  std::vector<uint8_t> entry(kv::serialised_entry_header_size + size, 42);
+  kv::SerialisedEntryHeader header;
+  header.set_size(size);
+  std::memcpy(entry.data(), &header, sizeof(header));
+  return entry;
+}
+
+static void wait_for_chunk_pool(size_t pool_size)
+{
+  size_t ready = 0;
+  while (ready < pool_size)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ready = 0;
+    for (auto const& f : fs::directory_iterator(ledger_dir))
+    {
+      if (is_ledger_file_preallocated(f.path().filename()))
+      {
+        ready++;
+      }
+    }
+  }
+}
+
+// Reports the 99th percentile latency of a single append, across chunk
+// boundaries, rather than the mean
+static void append_p99(
+  picobench::state& s, size_t entry_size, size_t chunk_pool_size)
+{
+  fs::remove_all(ledger_dir);
+
+  const auto entry = make_entry(entry_size);
+  std::vector<int64_t> latencies;
+  latencies.reserve(s.iterations());
+
+  {
+    Ledger ledger(ledger_dir, wf, chunk_threshold);
+    ledger.set_chunk_pool_size(chunk_pool_size);
+    wait_for_chunk_pool(chunk_pool_size);
+
+    for (size_t i = 0; i < s.iterations(); ++i)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      ledger.write_entry(entry.data(), entry.size(), true, false, 2);
+      const auto end = std::chrono::steady_clock::now();
+      latencies.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count());
+    }
+  }
+
+  const auto p99 = latencies.begin() + (latencies.size() * 99) / 100;
+  std::nth_element(latencies.begin(), p99, latencies.end());
+  s.add_custom_duration(*p99 * s.iterations());
+
+  fs::remove_all(ledger_dir);
+}
+
+template <size_t ENTRY_SIZE>
+static void append_p99_no_pool(picobench::state& s)
+{
+  append_p99(s, ENTRY_SIZE, 0);
+}
+
+template <size_t ENTRY_SIZE>
+static void append_p99_pool(picobench::state& s)
+{
+  append_p99(s, ENTRY_SIZE, ledger_chunk_pool_size_default);
+}
+
+const std::vector<int> append_count = {1000, 10000};
+const uint32_t sample_size = 10;
+
+PICOBENCH_SUITE("append_p99");
+PICOBENCH(append_p99_no_pool<100>)
+  .iterations(append_count)
+  .samples(sample_size)
+  .baseline();
+PICOBENCH(append_p99_pool<100>).iterations(append_count).samples(sample_size);
+PICOBENCH(append_p99_no_pool<1000>)
+  .iterations(append_count)
+  .samples(sample_size)
+  .baseline();
+PICOBENCH(append_p99_pool<1000>).iterations(append_count).samples(sample_size);
+
+int main(int argc, char* argv[])
+{
+  logger::config::level() = logger::FATAL;
+
+  picobench::runner runner;
+  runner.parse_cmd_line(argc, argv);
+  return runner.run();
+}
@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "host/tcp.h"
+
+#include <chrono>
+#include <doctest/doctest.h>
+#include <memory>
+#include <vector>
+
+using namespace asynchost;
+
+size_t asynchost::TCPImpl::remaining_read_quota;
+
+using Bytes = std::vector<uint8_t>;
+
+// Successive bytes depend on their position in the stream, so that bytes
+// arriving out of order are detected
+class Stream
+{
+  size_t next = 0;
+
+public:
+  Bytes expected;
+
+  Bytes take(size_t len)
+  {
+    Bytes bytes(len);
+    for (auto& b : bytes)
+    {
+      b = static_cast<uint8_t>((next++ * 2654435761u) >> 13);
+    }
+    expected.insert(expected.end(), bytes.begin(), bytes.end());
+    return bytes;
+  }
+
+  std::shared_ptr<const Bytes> take_owned(size_t len)
+  {
+    return std::make_shared<const Bytes>(take(len));
+  }
+};
+
+class ReceiverBehaviour : public TCPBehaviour
+{
+  std::shared_ptr<Bytes> received;
+
+public:
+  ReceiverBehaviour(std::shared_ptr<Bytes> received_) : received(received_) {}
+
+  void on_read(size_t len, uint8_t*& data) override
+  {
+    received->insert(received->end(), data, data + len);
+  }
+};
+
+class ServerBehaviour : public TCPServerBehaviour
+{
+  std::shared_ptr<Bytes> received;
+  std::vector<TCP> peers;
+
+public:
+  ServerBehaviour(std::shared_ptr<Bytes> received_) : received(received_) {}
+
+  void on_accept(TCP& peer) override
+  {
+    peer->set_behaviour(std::make_unique<ReceiverBehaviour>(received));
+    peers.push_back(peer);
+  }
+};
+
+class ClientBehaviour : public TCPBehaviour
+{
+  std::shared_ptr<bool> connected;
+
+public:
+  ClientBehaviour(std::shared_ptr<bool> connected_) : connected(connected_) {}
+
+  void on_connect() override
+  {
+    *connected = true;
+  }
+};
+
+template <typename F>
+static bool run_until(F&& done)
+{
+  const auto deadline =
+    std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (!done() && std::chrono::steady_clock::now() < deadline)
+  {
+    uv_run(uv_default_loop(), UV_RUN_NOWAIT);
+  }
+  return done();
+}
+
+TEST_CASE("Writes arrive in order across partial and coalesced writes")
+{
+  {
+    ResetTCPReadQuota reset_read_quota;
+    auto received = std::make_shared<Bytes>();
+    auto connected = std::make_shared<bool>(false);
+    Stream stream;
+
+    TCP server;
+    server->set_behaviour(std::make_unique<ServerBehaviour>(received));
+    REQUIRE(server->listen("127.0.0.1", "0"));
+
+    TCP client(true);
+    client->set_behaviour(std::make_unique<ClientBehaviour>(connected));
+    REQUIRE(client->connect("127.0.0.1", server->get_service()));
+
+    INFO("Writes issued while connecting are coalesced");
+    {
+      auto copied = stream.take(100);
+      REQUIRE(client->write(copied.size(), copied.data()));
+      // Copied bytes can be reused as soon as write() returns
+      std::fill(copied.begin(), copied.end(), 0);
+
+      auto owned = stream.take_owned(1000);
+      REQUIRE(client->write({{owned->data(), owned->size(), owned}}));
+
+      REQUIRE(run_until([&]() { return *connected; }));
+    }
+
+    INFO("Writes issued while the socket is busy are coalesced");
+    {
+      // Larger than the socket buffers, so that it is only partially
+      // written straight away and the following writes are queued
+      auto large = stream.take_owned(32 << 20);
+      REQUIRE(client->write({{large->data(), large->size(), large}}));
+
+      for (size_t i = 0; i < 100; ++i)
+      {
+        auto copied = stream.take(17 + i);
+        auto owned = stream.take_owned(1 + 3 * i);
+        auto more_copied = stream.take(i);
+        REQUIRE(client->write(
+          {{copied.data(), copied.size()},
+           {owned->data(), owned->size(), owned},
+           {more_copied.data(), more_copied.size()}}));
+      }
+    }
+
+    INFO("Single writes go out once the socket is idle again");
+    {
+      REQUIRE(run_until(
+        [&]() { return received->size() == stream.expected.size(); }));
+
+      auto copied = stream.take(12345);
+      REQUIRE(client->write(copied.size(), copied.data()));
+      REQUIRE(run_until(
+        [&]() { return received->size() == stream.expected.size(); }));
+    }
+
+    REQUIRE(*received == stream.expected);
+  }
+
+  // Let handles close
+  for (size_t i = 0; i < 100 && uv_loop_alive(uv_default_loop()); ++i)
+  {
+    uv_run(uv_default_loop(), UV_RUN_NOWAIT);
+  }
+  REQUIRE(uv_loop_close(uv_default_loop()) == 0);
+}
@@ -13,6 +13,37 @@
 
 namespace ccf
 {
+  namespace
+  {
+    static const std::string& get_caller_cert_digest(
+      enclave::SessionContext& session)
+    {
+      if (!session.caller_cert_digest.has_value())
+      {
+        session.caller_cert_digest =
+          crypto::Sha256Hash(session.caller_cert).hex_str();
+      }
+      return session.caller_cert_digest.value();
+    }
+
+    // Returns true if caller_id is in the certificates table read by certs.
+    // The result is cached in lookup, and the table is only searched again
+    // once it has changed.
+    template <typename THandle>
+    static bool find_caller_cert(
+      THandle* certs,
+      const std::string& caller_id,
+      std::optional<enclave::SessionContext::CertLookup>& lookup)
+    {
+      const auto version = certs->get_state_version();
+      if (!lookup.has_value() || lookup->version != version)
+      {
+        lookup = {version, certs->has(caller_id)};
+      }
+      return lookup->found;
+    }
+  }
+
   struct UserCertAuthnIdentity : public AuthnIdentity
   {
     /** CCF user ID */
@@ -29,11 +60,11 @@ namespace ccf
       const std::shared_ptr<enclave::RpcContext>& ctx,
       std::string& error_reason) override
     {
-      const auto& caller_cert = ctx->session->caller_cert;
-      auto caller_id = crypto::Sha256Hash(caller_cert).hex_str();
+      auto& session = *ctx->session;
+      const auto& caller_id = get_caller_cert_digest(session);
 
       auto user_certs = tx.ro<UserCerts>(Tables::USER_CERTS);
-      if (user_certs->has(caller_id))
+      if (find_caller_cert(user_certs, caller_id, session.user_cert_lookup))
       {
         auto identity = std::make_unique<UserCertAuthnIdentity>();
         identity->user_id = caller_id;
@@ -70,11 +101,12 @@ namespace ccf
       const std::shared_ptr<enclave::RpcContext>& ctx,
       std::string& error_reason) override
     {
-      const auto& caller_cert = ctx->session->caller_cert;
-      auto caller_id = crypto::Sha256Hash(caller_cert).hex_str();
+      auto& session = *ctx->session;
+      const auto& caller_id = get_caller_cert_digest(session);
 
       auto member_certs = tx.ro<MemberCerts>(Tables::MEMBER_CERTS);
-      if (member_certs->has(caller_id))
+      if (find_caller_cert(
+            member_certs, caller_id, session.member_cert_lookup))
       {
         auto identity = std::make_unique<MemberCertAuthnIdentity>();
         identity->member_id = caller_id;
@@ -109,10 +141,15 @@ namespace ccf
       const std::shared_ptr<enclave::RpcContext>& ctx,
       std::string& error_reason) override
     {
-      auto caller_public_key_der =
-        crypto::make_unique_verifier(ctx->session->caller_cert)
-          ->public_key_der();
-      auto node_caller_id = crypto::Sha256Hash(caller_public_key_der).hex_str();
+      auto& session = *ctx->session;
+      if (!session.caller_public_key_digest.has_value())
+      {
+        auto caller_public_key_der =
+          crypto::make_unique_verifier(session.caller_cert)->public_key_der();
+        session.caller_public_key_digest =
+          crypto::Sha256Hash(caller_public_key_der).hex_str();
+      }
+      const auto& node_caller_id = session.caller_public_key_digest.value();
 
       auto nodes = tx.ro<ccf::Nodes>(Tables::NODES);
       auto node = nodes->get(node_caller_id);
@@ -3,11 +3,183 @@
 #pragma once
 
 #include "authentication_types.h"
+#include "crypto/hash_provider.h"
+#include "enclave/enclave_time.h"
 #include "http/http_jwt.h"
 #include "node/jwt.h"
 
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
 namespace ccf
 {
+  /** Node-wide cache of verifiers for JWT public signing keys, and of tokens
+   * whose signature has already been verified.
+   *
+   * Verifiers are keyed by key ID and digest of the key, and validated tokens
+   * record the digest of the key they were verified with, so a key replaced in
+   * the KV is never used once the new key is read, even before its entries are
+   * evicted. Validated tokens are kept until their expiry, and at most for
+   * MAX_TOKEN_TTL.
+   */
+  class JwtVerifierCache
+  {
+  public:
+    static constexpr size_t MAX_VALIDATED_TOKENS = 1000;
+    static constexpr std::chrono::seconds MAX_TOKEN_TTL{60};
+
+  private:
+    struct KeyEntry
+    {
+      crypto::Sha256Hash digest;
+      crypto::VerifierPtr verifier;
+    };
+
+    struct TokenEntry
+    {
+      JwtKeyId key_id;
+      crypto::Sha256Hash key_digest;
+      std::chrono::microseconds expiry;
+    };
+
+    std::mutex lock;
+    std::unordered_map<JwtKeyId, KeyEntry> verifiers;
+    std::unordered_map<std::string, TokenEntry> validated_tokens;
+
+    // signed_content contains a single '.', between header and payload, so
+    // separating the signature with another '.' is unambiguous
+    static std::string get_token_cache_key(
+      const http::JwtVerifier::Token& token)
+    {
+      std::string key;
+      key.reserve(token.signed_content.size() + 1 + token.signature.size());
+      key.append(token.signed_content);
+      key.push_back('.');
+      key.append(token.signature.begin(), token.signature.end());
+      return key;
+    }
+
+    static std::chrono::microseconds get_token_expiry(
+      const http::JwtVerifier::Token& token, std::chrono::microseconds now)
+    {
+      std::chrono::microseconds expiry = now + MAX_TOKEN_TTL;
+      const auto exp = token.payload.find("exp");
+      if (exp != token.payload.end() && exp->is_number())
+      {
+        // Compared in seconds, as exp may be too large to convert
+        const auto exp_s = std::chrono::seconds(exp->get<int64_t>());
+        if (exp_s < std::chrono::duration_cast<std::chrono::seconds>(expiry))
+        {
+          expiry = exp_s;
+        }
+      }
+      return expiry;
+    }
+
+    void add_validated_token(
+      std::string&& token_key,
+      const JwtKeyId& key_id,
+      const crypto::Sha256Hash& key_digest,
+      std::chrono::microseconds expiry,
+      std::chrono::microseconds now)
+    {
+      if (validated_tokens.size() >= MAX_VALIDATED_TOKENS)
+      {
+        for (auto it = validated_tokens.begin(); it != validated_tokens.end();)
+        {
+          it = it->second.expiry <= now ? validated_tokens.erase(it) : ++it;
+        }
+
+        if (validated_tokens.size() >= MAX_VALIDATED_TOKENS)
+        {
+          validated_tokens.clear();
+        }
+      }
+
+      validated_tokens[std::move(token_key)] = {key_id, key_digest, expiry};
+    }
+
+  public:
+    /** Returns true if the signature of token is valid for the key key_der,
+     * registered under key_id. Tokens already verified with the same key are
+     * not verified again.
+     */
+    bool validate_token_signature(
+      const http::JwtVerifier::Token& token,
+      const JwtKeyId& key_id,
+      const std::vector<uint8_t>& key_der)
+    {
+      const crypto::Sha256Hash key_digest(key_der);
+      const auto now = enclave::get_enclave_time();
+      auto token_key = get_token_cache_key(token);
+
+      crypto::VerifierPtr verifier = nullptr;
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        auto token_it = validated_tokens.find(token_key);
+        if (token_it != validated_tokens.end())
+        {
+          const auto& entry = token_it->second;
+          if (
+            entry.expiry > now && entry.key_id == key_id &&
+            entry.key_digest == key_digest)
+          {
+            return true;
+          }
+          validated_tokens.erase(token_it);
+        }
+
+        auto key_it = verifiers.find(key_id);
+        if (key_it != verifiers.end() && key_it->second.digest == key_digest)
+        {
+          verifier = key_it->second.verifier;
+        }
+      }
+
+      if (verifier == nullptr)
+      {
+        verifier = crypto::make_verifier(key_der);
+        std::lock_guard<std::mutex> guard(lock);
+        verifiers[key_id] = {key_digest, verifier};
+      }
+
+      if (!http::JwtVerifier::validate_token_signature(token, *verifier))
+      {
+        return false;
+      }
+
+      const auto expiry = get_token_expiry(token, now);
+      if (expiry > now)
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        add_validated_token(
+          std::move(token_key), key_id, key_digest, expiry, now);
+      }
+
+      return true;
+    }
+
+    /** Drops the verifier and validated tokens of key_id, when the key is
+     * updated or removed.
+     */
+    void evict(const JwtKeyId& key_id)
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      verifiers.erase(key_id);
+      for (auto it = validated_tokens.begin(); it != validated_tokens.end();)
+      {
+        it = it->second.key_id == key_id ? validated_tokens.erase(it) : ++it;
+      }
+    }
+  };
+
+  inline JwtVerifierCache& get_jwt_verifier_cache()
+  {
+    static JwtVerifierCache cache;
+    return cache;
+  }
+
   struct JwtAuthnIdentity : public AuthnIdentity
   {
     /** JWT key issuer, as defined in @c
@@ -49,8 +221,8 @@ namespace ccf
         {
           error_reason = "JWT signing key not found";
         }
-        else if (!http::JwtVerifier::validate_token_signature(
-                   token.value(), token_key.value()))
+        else if (!get_jwt_verifier_cache().validate_token_signature(
+                   token.value(), key_id, token_key.value()))
         {
           error_reason = "JWT signature is invalid";
         }
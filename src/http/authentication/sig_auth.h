@@ -3,8 +3,8 @@
 #pragma once
 
 #include "authentication_types.h"
-#include "ds/lru.h"
 #include "http/http_sig.h"
+#include "verifier_cache.h"
 
 namespace ccf
 {
@@ -31,38 +31,10 @@ namespace ccf
     SignedReq signed_request;
   };
 
-  struct VerifierCache
-  {
-    static constexpr size_t DEFAULT_MAX_VERIFIERS = 50;
-
-    std::mutex verifiers_lock;
-    LRU<crypto::Pem, crypto::VerifierPtr> verifiers;
-
-    VerifierCache(size_t max_verifiers = DEFAULT_MAX_VERIFIERS) :
-      verifiers(max_verifiers)
-    {}
-
-    crypto::VerifierPtr get_verifier(const crypto::Pem& pem)
-    {
-      std::lock_guard<std::mutex> guard(verifiers_lock);
-
-      crypto::VerifierPtr verifier = nullptr;
-
-      auto it = verifiers.find(pem);
-      if (it == verifiers.end())
-      {
-        it = verifiers.insert(pem, crypto::make_verifier(pem));
-      }
-
-      return it->second;
-    }
-  };
-
   class UserSignatureAuthnPolicy : public AuthnPolicy
   {
   protected:
     static const OpenAPISecuritySchema security_schema;
-    VerifierCache verifiers;
 
   public:
     static constexpr auto SECURITY_SCHEME_NAME = "user_signature";
@@ -80,7 +52,8 @@ namespace ccf
         auto user_cert = users_certs->get(signed_request->key_id);
         if (user_cert.has_value())
         {
-          auto verifier = verifiers.get_verifier(user_cert.value());
+          auto verifier = get_verifier_cache().get_verifier(
+            signed_request->key_id, user_cert.value());
           if (verifier->verify(
                 signed_request->req, signed_request->sig, signed_request->md))
           {
@@ -160,7 +133,6 @@ namespace ccf
   {
   protected:
     static const OpenAPISecuritySchema security_schema;
-    VerifierCache verifiers;
 
   public:
     static constexpr auto SECURITY_SCHEME_NAME = "member_signature";
@@ -179,7 +151,8 @@ namespace ccf
         if (member_cert.has_value())
         {
           std::vector<uint8_t> digest;
-          auto verifier = verifiers.get_verifier(member_cert.value());
+          auto verifier = get_verifier_cache().get_verifier(
+            signed_request->key_id, member_cert.value());
           if (verifier->verify(
                 signed_request->req,
                 signed_request->sig,
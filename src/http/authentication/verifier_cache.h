@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#pragma once
+
+#include "crypto/pem.h"
+#include "crypto/verifier.h"
+#include "ds/lru.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace ccf
+{
+  struct VerifierCacheMetrics
+  {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t max_verifiers = 0;
+  };
+
+  /** Cache of verifiers for the certificates of request signers, shared by
+   * all threads and signature authentication policies authenticating
+   * requests.
+   *
+   * Entries are keyed by certificate digest, which is the ID of users and
+   * members, and spread across shards which each have their own lock and LRU,
+   * so that threads verifying requests from different signers rarely contend.
+   * The certificate of each entry is checked on lookup, so an entry is never
+   * used for a different certificate registered under the same digest.
+   */
+  class VerifierCache
+  {
+  public:
+    static constexpr size_t DEFAULT_MAX_VERIFIERS = 256;
+    static constexpr size_t NUM_SHARDS = 16;
+
+  private:
+    struct Entry
+    {
+      crypto::Pem cert;
+      crypto::VerifierPtr verifier;
+    };
+
+    struct Shard
+    {
+      std::mutex lock;
+      LRU<std::string, Entry> verifiers{0};
+    };
+
+    std::array<Shard, NUM_SHARDS> shards;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> evictions{0};
+    std::atomic<size_t> max_verifiers{0};
+
+    Shard& get_shard(const std::string& cert_digest)
+    {
+      return shards[std::hash<std::string>{}(cert_digest) % NUM_SHARDS];
+    }
+
+  public:
+    VerifierCache(size_t max_verifiers_ = DEFAULT_MAX_VERIFIERS)
+    {
+      set_max_verifiers(max_verifiers_);
+    }
+
+    /** Set the maximum number of cached verifiers, which is shared evenly
+     * between shards. Each shard holds at least one verifier.
+     */
+    void set_max_verifiers(size_t max_verifiers_)
+    {
+      max_verifiers = max_verifiers_;
+      const auto max_per_shard =
+        std::max<size_t>(1, (max_verifiers_ + NUM_SHARDS - 1) / NUM_SHARDS);
+      for (auto& shard : shards)
+      {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.verifiers.set_max_size(max_per_shard);
+      }
+    }
+
+    crypto::VerifierPtr get_verifier(
+      const std::string& cert_digest, const crypto::Pem& cert)
+    {
+      auto& shard = get_shard(cert_digest);
+
+      {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        auto it = shard.verifiers.find(cert_digest);
+        if (it != shard.verifiers.end() && it->second.cert == cert)
+        {
+          shard.verifiers.promote(it);
+          hits++;
+          return it->second.verifier;
+        }
+      }
+
+      // Parse the certificate outside of the shard's lock
+      misses++;
+      auto verifier = crypto::make_verifier(cert);
+
+      std::lock_guard<std::mutex> guard(shard.lock);
+      const auto size_before = shard.verifiers.size();
+      const auto existed = shard.verifiers.contains(cert_digest);
+      auto it = shard.verifiers.insert(cert_digest, {cert, verifier});
+      it->second = {cert, verifier};
+      if (!existed && shard.verifiers.size() == size_before)
+      {
+        evictions++;
+      }
+
+      return verifier;
+    }
+
+    VerifierCacheMetrics get_metrics() const
+    {
+      return {
+        hits.load(), misses.load(), evictions.load(), max_verifiers.load()};
+    }
+  };
+
+  inline VerifierCache& get_verifier_cache()
+  {
+    static VerifierCache cache;
+    return cache;
+  }
+}
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#include "http/authentication/verifier_cache.h"
+
+#include "crypto/hash_provider.h"
+#include "crypto/key_pair.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+struct Signer
+{
+  std::string cert_digest;
+  crypto::Pem cert;
+};
+
+static Signer make_signer(const std::string& name)
+{
+  auto kp = crypto::make_key_pair();
+  auto cert = kp->self_sign(fmt::format("CN={}", name));
+  auto cert_der = crypto::make_verifier(cert)->cert_der();
+  return {crypto::Sha256Hash(cert_der).hex_str(), cert};
+}
+
+TEST_CASE("Verifier cache metrics")
+{
+  ccf::VerifierCache cache;
+  REQUIRE(
+    cache.get_metrics().max_verifiers ==
+    ccf::VerifierCache::DEFAULT_MAX_VERIFIERS);
+
+  const auto alice = make_signer("alice");
+  const auto bob = make_signer("bob");
+
+  auto v = cache.get_verifier(alice.cert_digest, alice.cert);
+  REQUIRE(v != nullptr);
+  auto m = cache.get_metrics();
+  REQUIRE(m.hits == 0);
+  REQUIRE(m.misses == 1);
+
+  REQUIRE(cache.get_verifier(alice.cert_digest, alice.cert) == v);
+  m = cache.get_metrics();
+  REQUIRE(m.hits == 1);
+  REQUIRE(m.misses == 1);
+
+  INFO("A different certificate under the same digest is never a hit");
+  auto v2 = cache.get_verifier(alice.cert_digest, bob.cert);
+  REQUIRE(v2 != v);
+  m = cache.get_metrics();
+  REQUIRE(m.hits == 1);
+  REQUIRE(m.misses == 2);
+  REQUIRE(m.evictions == 0);
+}
+
+TEST_CASE("Verifier cache capacity")
+{
+  // Each shard holds at least one verifier, so a cache never holds fewer
+  // than NUM_SHARDS verifiers
+  constexpr auto max_verifiers = ccf::VerifierCache::NUM_SHARDS;
+  ccf::VerifierCache cache(max_verifiers);
+  REQUIRE(cache.get_metrics().max_verifiers == max_verifiers);
+
+  std::vector<Signer> signers;
+  for (size_t i = 0; i < 4 * max_verifiers; ++i)
+  {
+    signers.push_back(make_signer(fmt::format("signer{}", i)));
+  }
+
+  for (const auto& signer : signers)
+  {
+    cache.get_verifier(signer.cert_digest, signer.cert);
+  }
+  auto m = cache.get_metrics();
+  REQUIRE(m.misses == signers.size());
+  REQUIRE(m.evictions > 0);
+  REQUIRE(m.evictions < signers.size());
+
+  INFO("Raising the capacity stops evictions");
+  // Large enough for all signers to land in the same shard
+  const auto new_max_verifiers = signers.size() * max_verifiers;
+  cache.set_max_verifiers(new_max_verifiers);
+  REQUIRE(cache.get_metrics().max_verifiers == new_max_verifiers);
+  for (const auto& signer : signers)
+  {
+    cache.get_verifier(signer.cert_digest, signer.cert);
+  }
+  m = cache.get_metrics();
+  const auto evictions = m.evictions;
+  const auto misses = m.misses;
+  for (const auto& signer : signers)
+  {
+    cache.get_verifier(signer.cert_digest, signer.cert);
+  }
+  m = cache.get_metrics();
+  REQUIRE(m.evictions == evictions);
+  REQUIRE(m.misses == misses);
+  REQUIRE(m.hits > 0);
+}
+
+TEST_CASE("Node-wide verifier cache")
+{
+  auto& cache = ccf::get_verifier_cache();
+  REQUIRE(&cache == &ccf::get_verifier_cache());
+
+  cache.set_max_verifiers(42);
+  REQUIRE(ccf::get_verifier_cache().get_metrics().max_verifiers == 42);
+}
@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#include "crypto/hash_provider.h"
+#include "crypto/key_pair.h"
+#include "http/authentication/verifier_cache.h"
+
+#define PICOBENCH_IMPLEMENT_WITH_MAIN
+#include <picobench/picobench.hpp>
+#include <thread>
+
+template <class A>
+inline void do_not_optimize(A const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber_memory()
+{
+  asm volatile("" : : : "memory");
+}
+
+// VerifierCache as it was before sharding, with a single lock around an LRU
+// keyed by certificate
+class SingleLockVerifierCache
+{
+  std::mutex lock;
+  LRU<crypto::Pem, crypto::VerifierPtr> verifiers{
+    ccf::VerifierCache::DEFAULT_MAX_VERIFIERS};
+
+public:
+  crypto::VerifierPtr get_verifier(const std::string&, const crypto::Pem& cert)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = verifiers.find(cert);
+    if (it == verifiers.end())
+    {
+      it = verifiers.insert(cert, crypto::make_verifier(cert));
+    }
+    return it->second;
+  }
+};
+
+static const std::vector<uint8_t> request = {
+  'P', 'O', 'S', 'T', ' ', '/', 'a', 'p', 'p', '/', 'l', 'o', 'g'};
+
+struct Signer
+{
+  std::string cert_digest;
+  crypto::Pem cert;
+  std::vector<uint8_t> signature;
+};
+
+static const std::vector<Signer>& get_signers()
+{
+  static constexpr size_t num_signers = 32;
+  static std::vector<Signer> signers;
+  if (signers.empty())
+  {
+    for (size_t i = 0; i < num_signers; ++i)
+    {
+      auto kp = crypto::make_key_pair();
+      auto cert = kp->self_sign(fmt::format("CN=signer{}", i));
+      auto cert_der = crypto::make_verifier(cert)->cert_der();
+      signers.push_back({crypto::Sha256Hash(cert_der).hex_str(),
+                         cert,
+                         kp->sign(request, crypto::MDType::SHA256)});
+    }
+  }
+  return signers;
+}
+
+// Each of NThreads threads looks up the verifier of successive signers and,
+// if Verify, checks their signature of the request, as the signature auth
+// policies do for each request
+template <typename Cache, size_t NThreads, bool Verify>
+static void authenticate(picobench::state& s)
+{
+  const auto& signers = get_signers();
+  Cache cache;
+  const size_t calls_per_thread = s.iterations() / NThreads;
+
+  s.start_timer();
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < NThreads; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      for (size_t i = 0; i < calls_per_thread; ++i)
+      {
+        const auto& signer = signers[(t + i) % signers.size()];
+        auto verifier = cache.get_verifier(signer.cert_digest, signer.cert);
+        if constexpr (Verify)
+        {
+          auto valid =
+            verifier->verify(request, signer.signature, crypto::MDType::SHA256);
+          do_not_optimize(valid);
+        }
+        do_not_optimize(verifier);
+        clobber_memory();
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  s.stop_timer();
+}
+
+const std::vector<int> lookup_counts = {100000};
+const std::vector<int> verify_counts = {1000};
+
+#define PICO_LOOKUP_SUFFIX() iterations(lookup_counts).samples(10)
+#define PICO_VERIFY_SUFFIX() iterations(verify_counts).samples(10)
+
+using Sharded = ccf::VerifierCache;
+using SingleLock = SingleLockVerifierCache;
+
+PICOBENCH_SUITE("get_verifier");
+namespace LOOKUP
+{
+  auto single_lock_1 = authenticate<SingleLock, 1, false>;
+  PICOBENCH(single_lock_1).PICO_LOOKUP_SUFFIX().baseline();
+  auto sharded_1 = authenticate<Sharded, 1, false>;
+  PICOBENCH(sharded_1).PICO_LOOKUP_SUFFIX();
+
+  auto single_lock_4 = authenticate<SingleLock, 4, false>;
+  PICOBENCH(single_lock_4).PICO_LOOKUP_SUFFIX();
+  auto sharded_4 = authenticate<Sharded, 4, false>;
+  PICOBENCH(sharded_4).PICO_LOOKUP_SUFFIX();
+
+  auto single_lock_8 = authenticate<SingleLock, 8, false>;
+  PICOBENCH(single_lock_8).PICO_LOOKUP_SUFFIX();
+  auto sharded_8 = authenticate<Sharded, 8, false>;
+  PICOBENCH(sharded_8).PICO_LOOKUP_SUFFIX();
+}
+
+PICOBENCH_SUITE("get_verifier and verify");
+namespace VERIFY
+{
+  auto single_lock_1 = authenticate<SingleLock, 1, true>;
+  PICOBENCH(single_lock_1).PICO_VERIFY_SUFFIX().baseline();
+  auto sharded_1 = authenticate<Sharded, 1, true>;
+  PICOBENCH(sharded_1).PICO_VERIFY_SUFFIX();
+
+  auto single_lock_4 = authenticate<SingleLock, 4, true>;
+  PICOBENCH(single_lock_4).PICO_VERIFY_SUFFIX();
+  auto sharded_4 = authenticate<Sharded, 4, true>;
+  PICOBENCH(sharded_4).PICO_VERIFY_SUFFIX();
+
+  auto single_lock_8 = authenticate<SingleLock, 8, true>;
+  PICOBENCH(single_lock_8).PICO_VERIFY_SUFFIX();
+  auto sharded_8 = authenticate<Sharded, 8, true>;
+  PICOBENCH(sharded_8).PICO_VERIFY_SUFFIX();
+}
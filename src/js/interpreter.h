@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#pragma once
+
+#include "js/module_cache.h"
+#include "js/wrap.h"
+#include "node/entities.h"
+#include "node/modules.h"
+
+#include <map>
+#include <optional>
+#include <string>
+
+namespace js
+{
+  /** QuickJS runtime and context which can be reused to execute endpoints of
+   * successive requests, on a single thread.
+   *
+   * The ccf, console and openenclave globals are populated once and rebound to
+   * each request. Modules are loaded and evaluated once, and kept for as long
+   * as the app modules they were loaded from are unchanged. As a result,
+   * module-level state is shared by successive requests.
+   */
+  class Interpreter
+  {
+  private:
+    Runtime rt;
+    Context ctx;
+    TxContext txctx{nullptr, TxAccess::APP};
+    bool globals_populated = false;
+
+    // Transaction from which app modules are loaded, for the current request
+    kv::Tx* modules_tx = nullptr;
+
+    struct LoadedModule
+    {
+      JSModuleDef* module_def;
+      std::optional<kv::Version> version;
+      std::optional<kv::Version> bytecode_version;
+    };
+    std::map<std::string, LoadedModule> loaded_modules;
+
+    // Name of module in the MODULES table, as in load_app_module()
+    static std::string get_module_kv_name(const std::string& module_name)
+    {
+      if (!module_name.empty() && module_name[0] == '/')
+      {
+        return module_name;
+      }
+      return "/" + module_name;
+    }
+
+    static std::pair<std::optional<kv::Version>, std::optional<kv::Version>>
+    get_module_versions(kv::Tx& tx, const std::string& module_kv_name)
+    {
+      auto modules = tx.ro<ccf::Modules>(ccf::Tables::MODULES);
+      auto modules_bytecode = tx.ro<ccf::ModulesQuickJsBytecode>(
+        ccf::Tables::MODULES_QUICKJS_BYTECODE);
+      return {modules->get_version_of_previous_write(module_kv_name),
+              modules_bytecode->get_version_of_previous_write(module_kv_name)};
+    }
+
+    void add_loaded_module(
+      const std::string& module_kv_name, JSModuleDef* module_def)
+    {
+      auto [version, bytecode_version] =
+        get_module_versions(*modules_tx, module_kv_name);
+      loaded_modules[module_kv_name] = {module_def, version, bytecode_version};
+    }
+
+    // Loads modules imported by other modules
+    static JSModuleDef* module_loader(
+      JSContext* ctx, const char* module_name, void* opaque)
+    {
+      auto interpreter = static_cast<Interpreter*>(opaque);
+      auto module_def =
+        js_app_module_loader(ctx, module_name, interpreter->modules_tx);
+      if (module_def != nullptr)
+      {
+        interpreter->add_loaded_module(
+          get_module_kv_name(module_name), module_def);
+      }
+      return module_def;
+    }
+
+  public:
+    Interpreter() : ctx(rt)
+    {
+      rt.add_ccf_classdefs();
+      JS_SetModuleLoaderFunc(rt, nullptr, module_loader, this);
+    }
+
+    Interpreter(const Interpreter&) = delete;
+
+    operator JSContext*() const
+    {
+      return ctx;
+    }
+
+    Context& get_context()
+    {
+      return ctx;
+    }
+
+    // Returns false if any module loaded by this interpreter has changed since
+    // it was loaded, in which case this interpreter should not be used
+    bool are_modules_current(kv::Tx& tx) const
+    {
+      for (const auto& [name, module] : loaded_modules)
+      {
+        if (
+          get_module_versions(tx, name) !=
+          std::make_pair(module.version, module.bytecode_version))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Binds the interpreter to a request, whose endpoint reads from and writes
+    // to target_tx and whose app modules are loaded from tx
+    void bind_request(
+      kv::Tx& tx,
+      kv::Tx& target_tx,
+      enclave::RpcContext* rpc_ctx,
+      const std::optional<ccf::TxID>& transaction_id,
+      ccf::historical::TxReceiptPtr receipt,
+      ccf::AbstractNodeState* host_node_state)
+    {
+      modules_tx = &tx;
+      txctx.tx = &target_tx;
+
+      if (!globals_populated)
+      {
+        register_request_body_class(ctx);
+        populate_global_console(ctx);
+        populate_global_ccf(
+          &txctx,
+          rpc_ctx,
+          transaction_id,
+          receipt,
+          nullptr,
+          host_node_state,
+          nullptr,
+          ctx);
+        populate_global_openenclave(ctx);
+        globals_populated = true;
+      }
+      else
+      {
+        rebind_global_ccf(rpc_ctx, transaction_id, receipt, ctx);
+      }
+    }
+
+    // Releases the transactions of the current request
+    void unbind_request()
+    {
+      modules_tx = nullptr;
+      txctx.tx = nullptr;
+    }
+
+    // Returns the exported function func of the app module module_name,
+    // loading and evaluating the module if it was not already. If this throws,
+    // the interpreter should be discarded as the module may be partially
+    // evaluated.
+    JSValue get_exported_function(
+      const std::string& module_name, const std::string& func)
+    {
+      const auto module_kv_name = get_module_kv_name(module_name);
+      auto it = loaded_modules.find(module_kv_name);
+      if (it == loaded_modules.end())
+      {
+        auto module_val =
+          load_app_module(ctx, module_kv_name.c_str(), modules_tx);
+        add_loaded_module(
+          module_kv_name, (JSModuleDef*)JS_VALUE_GET_PTR(module_val));
+        ctx.evaluate_module(module_val, module_name);
+        it = loaded_modules.find(module_kv_name);
+      }
+      else
+      {
+        get_module_cache().record_hit();
+      }
+
+      return ctx.exported_function(it->second.module_def, func, module_name);
+    }
+  };
+}
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the Apache 2.0 License.
+#pragma once
+
+#include "crypto/hash_provider.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace js
+{
+  struct ModuleCacheMetrics
+  {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+  };
+
+  /** Node-wide cache of the bytecode of app modules, shared by the
+   * interpreters of all threads.
+   *
+   * Modules for which the KV holds no bytecode compiled by this version of
+   * QuickJS are compiled from source once, rather than once per interpreter.
+   * Entries are keyed by module name, digest of the module source and QuickJS
+   * version, and only the most recent entry for each module is kept.
+   */
+  class ModuleCache
+  {
+  public:
+    using Bytecode = std::shared_ptr<const std::vector<uint8_t>>;
+
+  private:
+    struct Entry
+    {
+      crypto::Sha256Hash digest;
+      std::string quickjs_version;
+      Bytecode bytecode;
+    };
+
+    std::mutex lock;
+    std::unordered_map<std::string, Entry> entries;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+
+  public:
+    Bytecode get(
+      const std::string& module_name,
+      const crypto::Sha256Hash& digest,
+      const std::string& quickjs_version)
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      auto it = entries.find(module_name);
+      if (
+        it == entries.end() || it->second.digest != digest ||
+        it->second.quickjs_version != quickjs_version)
+      {
+        return nullptr;
+      }
+      return it->second.bytecode;
+    }
+
+    void put(
+      const std::string& module_name,
+      const crypto::Sha256Hash& digest,
+      const std::string& quickjs_version,
+      std::vector<uint8_t>&& bytecode)
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      entries[module_name] = {
+        digest,
+        quickjs_version,
+        std::make_shared<const std::vector<uint8_t>>(std::move(bytecode))};
+    }
+
+    // A hit is a module load served by an interpreter's already evaluated
+    // module, or by bytecode held in this cache. A miss is a module load which
+    // decodes the module from the KV.
+    void record_hit()
+    {
+      hits++;
+    }
+
+    void record_miss()
+    {
+      misses++;
+    }
+
+    ModuleCacheMetrics get_metrics() const
+    {
+      return {hits.load(), misses.load()};
+    }
+  };
+
+  inline ModuleCache& get_module_cache()
+  {
+    static ModuleCache cache;
+    return cache;
+  }
+}
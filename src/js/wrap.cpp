@@ -8,6 +8,7 @@
 #include "enclave/rpc_context.h"
 #include "js/conv.cpp"
 #include "js/crypto.cpp"
+#include "js/module_cache.h"
 #include "js/oe.cpp"
 #include "kv/untyped_map.h"
 #include "node/jwt.h"
@@ -43,11 +44,40 @@ namespace js
   JSClassDef rpc_class_def = {};
   JSClassDef host_class_def = {};
 
+  // Map handles are looked up in the current transaction of their TxContext on
+  // each call, rather than holding on to the handle of the transaction they
+  // were created in. This keeps them valid if they outlive that transaction,
+  // e.g. when held by a module which is reused across requests.
+  struct KVMapHandleRef
+  {
+    TxContext* txctx;
+    std::string map_name;
+  };
+
+  static KVMap::Handle* get_map_handle(JSContext* ctx, JSValueConst this_val)
+  {
+    auto ref = static_cast<KVMapHandleRef*>(
+      JS_GetOpaque(this_val, kv_map_handle_class_id));
+    if (ref == nullptr || ref->txctx->tx == nullptr)
+    {
+      JS_ThrowInternalError(ctx, "No transaction available");
+      return nullptr;
+    }
+    return ref->txctx->tx->rw<KVMap>(ref->map_name);
+  }
+
+  static void js_kv_map_handle_finalizer(JSRuntime*, JSValue val)
+  {
+    delete static_cast<KVMapHandleRef*>(
+      JS_GetOpaque(val, kv_map_handle_class_id));
+  }
+
   static JSValue js_kv_map_has(
     JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv)
   {
-    auto handle = static_cast<KVMap::Handle*>(
-      JS_GetOpaque(this_val, kv_map_handle_class_id));
+    auto handle = get_map_handle(ctx, this_val);
+    if (handle == nullptr)
+      return JS_EXCEPTION;
 
     if (argc != 1)
       return JS_ThrowTypeError(
@@ -67,8 +97,9 @@ namespace js
   static JSValue js_kv_map_get(
     JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv)
   {
-    auto handle = static_cast<KVMap::Handle*>(
-      JS_GetOpaque(this_val, kv_map_handle_class_id));
+    auto handle = get_map_handle(ctx, this_val);
+    if (handle == nullptr)
+      return JS_EXCEPTION;
 
     if (argc != 1)
       return JS_ThrowTypeError(
@@ -97,8 +128,9 @@ namespace js
   static JSValue js_kv_map_size_getter(
     JSContext* ctx, JSValueConst this_val, int argc, JSValueConst*)
   {
-    auto handle = static_cast<KVMap::Handle*>(
-      JS_GetOpaque(this_val, kv_map_handle_class_id));
+    auto handle = get_map_handle(ctx, this_val);
+    if (handle == nullptr)
+      return JS_EXCEPTION;
     const uint64_t size = handle->size();
     if (size > INT64_MAX)
     {
@@ -111,8 +143,9 @@ namespace js
   static JSValue js_kv_map_delete(
     JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv)
   {
-    auto handle = static_cast<KVMap::Handle*>(
-      JS_GetOpaque(this_val, kv_map_handle_class_id));
+    auto handle = get_map_handle(ctx, this_val);
+    if (handle == nullptr)
+      return JS_EXCEPTION;
 
     if (argc != 1)
       return JS_ThrowTypeError(
@@ -138,8 +171,9 @@ namespace js
   static JSValue js_kv_map_set(
     JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv)
   {
-    auto handle = static_cast<KVMap::Handle*>(
-      JS_GetOpaque(this_val, kv_map_handle_class_id));
+    auto handle = get_map_handle(ctx, this_val);
+    if (handle == nullptr)
+      return JS_EXCEPTION;
 
     if (argc != 2)
       return JS_ThrowTypeError(
@@ -168,8 +202,9 @@ namespace js
   static JSValue js_kv_map_clear(
     JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv)
   {
-    auto handle = static_cast<KVMap::Handle*>(
-      JS_GetOpaque(this_val, kv_map_handle_class_id));
+    auto handle = get_map_handle(ctx, this_val);
+    if (handle == nullptr)
+      return JS_EXCEPTION;
 
     if (argc != 0)
     {
@@ -188,11 +223,170 @@ namespace js
     return JS_ThrowTypeError(ctx, "Cannot call clear on read-only map");
   }
 
+  // Bytes of a chunk of KV entries handed to JS, shared by the ArrayBuffers of
+  // their keys and values and freed once all of these have been collected.
+  // Scripts may modify ArrayBuffers, so they are never backed by KV memory,
+  // but a whole chunk is copied with a single allocation.
+  struct KVEntriesChunk
+  {
+    std::vector<uint8_t> bytes;
+    size_t refs = 0;
+  };
+
+  static void js_free_kv_entries_chunk(JSRuntime*, void* opaque, void*)
+  {
+    auto chunk = static_cast<KVEntriesChunk*>(opaque);
+    if (--chunk->refs == 0)
+    {
+      delete chunk;
+    }
+  }
+
+  // Copies the keys and values of at most max_size entries of a map, from
+  // which it then creates ArrayBuffers
+  class KVEntriesChunkBuilder
+  {
+  private:
+    using SerialisedEntry = kv::serialisers::SerialisedEntry;
+
+    // ArrayBuffers start at aligned offsets, so that they can be read through
+    // any typed array without unaligned accesses
+    static constexpr size_t alignment = 8;
+
+    // Offset and size of each key and value, in order
+    std::vector<std::pair<size_t, size_t>> entries;
+    std::unique_ptr<KVEntriesChunk> chunk;
+    size_t max_size;
+
+    void append(const SerialisedEntry& e)
+    {
+      auto& bytes = chunk->bytes;
+      const auto offset = bytes.size();
+      entries.emplace_back(offset, e.size());
+      bytes.resize(offset + ((e.size() + alignment - 1) & ~(alignment - 1)));
+      std::copy(e.begin(), e.end(), bytes.begin() + offset);
+    }
+
+  public:
+    KVEntriesChunkBuilder(size_t max_size_) :
+      chunk(std::make_unique<KVEntriesChunk>()),
+      max_size(max_size_)
+    {}
+
+    // Returns true once the chunk is full
+    bool add(const SerialisedEntry& k, const SerialisedEntry& v)
+    {
+      append(k);
+      append(v);
+      return entries.size() / 2 == max_size;
+    }
+
+    bool empty() const
+    {
+      return entries.empty();
+    }
+
+    // Creates the ArrayBuffers of the keys and values of the chunk, and starts
+    // a new chunk. Returns false if any could not be created, in which case
+    // none are returned.
+    bool build(
+      JSContext* ctx, std::vector<JSValue>& keys, std::vector<JSValue>& values)
+    {
+      // Owned by the ArrayBuffers from here, and by this function until it
+      // returns
+      auto shared_chunk = chunk.release();
+      shared_chunk->refs++;
+      bool failed = false;
+
+      for (size_t i = 0; i < entries.size(); ++i)
+      {
+        const auto [offset, size] = entries[i];
+        auto buf = JS_NewArrayBuffer(
+          ctx,
+          shared_chunk->bytes.data() + offset,
+          size,
+          js_free_kv_entries_chunk,
+          shared_chunk,
+          false);
+        if (JS_IsException(buf))
+        {
+          failed = true;
+        }
+        else
+        {
+          shared_chunk->refs++;
+        }
+        (i % 2 == 0 ? keys : values).push_back(buf);
+      }
+
+      if (failed)
+      {
+        for (auto& buf : keys)
+        {
+          JS_FreeValue(ctx, buf);
+        }
+        for (auto& buf : values)
+        {
+          JS_FreeValue(ctx, buf);
+        }
+        keys.clear();
+        values.clear();
+      }
+      js_free_kv_entries_chunk(nullptr, shared_chunk, nullptr);
+
+      entries.clear();
+      chunk = std::make_unique<KVEntriesChunk>();
+      return !failed;
+    }
+  };
+
+  static constexpr size_t default_kv_chunk_size = 100;
+
+  // Calls f with the keys and values of successive chunks of at most
+  // chunk_size entries of the map. f returns false to stop the iteration, in
+  // which case this returns false.
+  template <typename F>
+  static bool foreach_kv_chunk(
+    JSContext* ctx, KVMap::Handle* handle, size_t chunk_size, F&& f)
+  {
+    KVEntriesChunkBuilder chunk(chunk_size);
+    std::vector<JSValue> keys;
+    std::vector<JSValue> values;
+
+    auto flush = [&]() {
+      keys.clear();
+      values.clear();
+      if (!chunk.build(ctx, keys, values))
+      {
+        js_dump_error(ctx);
+        return false;
+      }
+      return f(keys, values);
+    };
+
+    bool ok = true;
+    handle->foreach([&](const auto& k, const auto& v) {
+      if (chunk.add(k, v))
+      {
+        ok = flush();
+      }
+      return ok;
+    });
+
+    if (ok && !chunk.empty())
+    {
+      ok = flush();
+    }
+
+    return ok;
+  }
+
   static JSValue js_kv_map_foreach(
     JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv)
   {
-    auto handle = static_cast<KVMap::Handle*>(
-      JS_GetOpaque(this_val, kv_map_handle_class_id));
+    auto handle = get_map_handle(ctx, this_val);
+    if (handle == nullptr)
+      return JS_EXCEPTION;
 
     if (argc != 1)
       return JS_ThrowTypeError(
@@ -203,14 +397,98 @@ namespace js
     if (!JS_IsFunction(ctx, func))
       return JS_ThrowTypeError(ctx, "Argument must be a function");
 
-    bool failed = false;
-    handle->foreach(
-      [ctx, this_val, func, &failed](const auto& k, const auto& v) {
+    // Entries are read in chunks, but the callback is still called once per
+    // entry. Since foreach() iterates over the state of the map when it is
+    // called, this is not observable by the callback.
+    auto ok = foreach_kv_chunk(
+      ctx,
+      handle,
+      default_kv_chunk_size,
+      [ctx, this_val, func](auto& keys, auto& values) {
+        bool failed = false;
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+          if (!failed)
+          {
+            JSValue args[3];
+
+            // JS forEach expects (v, k, map) rather than (k, v)
+            args[0] = values[i];
+            args[1] = keys[i];
+            args[2] = JS_DupValue(ctx, this_val);
+
+            auto val = JS_Call(ctx, func, JS_UNDEFINED, 3, args);
+            JS_FreeValue(ctx, args[2]);
+
+            if (JS_IsException(val))
+            {
+              js_dump_error(ctx);
+              failed = true;
+            }
+
+            JS_FreeValue(ctx, val);
+          }
+
+          JS_FreeValue(ctx, values[i]);
+          JS_FreeValue(ctx, keys[i]);
+        }
+
+        return !failed;
+      });
+
+    if (!ok)
+    {
+      return JS_EXCEPTION;
+    }
+
+    return JS_UNDEFINED;
+  }
+
+  static JSValue js_kv_map_foreach_chunk(
+    JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv)
+  {
+    auto handle = get_map_handle(ctx, this_val);
+    if (handle == nullptr)
+      return JS_EXCEPTION;
+
+    if (argc != 1 && argc != 2)
+      return JS_ThrowTypeError(
+        ctx, "Passed %d arguments, but expected 1 or 2", argc);
+
+    JSValue func = argv[0];
+
+    if (!JS_IsFunction(ctx, func))
+      return JS_ThrowTypeError(ctx, "First argument must be a function");
+
+    uint64_t chunk_size = default_kv_chunk_size;
+    if (argc == 2)
+    {
+      if (JS_ToIndex(ctx, &chunk_size, argv[1]) < 0)
+        return JS_EXCEPTION;
+
+      if (chunk_size == 0)
+        return JS_ThrowRangeError(ctx, "Chunk size must be positive");
+    }
+
+    auto to_array = [ctx](auto& buffers) {
+      auto array = JS_NewArray(ctx);
+      for (size_t i = 0; i < buffers.size(); ++i)
+      {
+        JS_SetPropertyUint32(ctx, array, i, buffers[i]);
+      }
+      return array;
+    };
+
+    auto ok = foreach_kv_chunk(
+      ctx,
+      handle,
+      chunk_size,
+      [ctx, this_val, func, &to_array](auto& keys, auto& values) {
         JSValue args[3];
 
-        // JS forEach expects (v, k, map) rather than (k, v)
-        args[0] = JS_NewArrayBufferCopy(ctx, v.data(), v.size());
-        args[1] = JS_NewArrayBufferCopy(ctx, k.data(), k.size());
+        // As in forEach, values are passed before keys
+        args[0] = to_array(values);
+        args[1] = to_array(keys);
         args[2] = JS_DupValue(ctx, this_val);
 
         auto val = JS_Call(ctx, func, JS_UNDEFINED, 3, args);
@@ -219,10 +497,10 @@ namespace js
         JS_FreeValue(ctx, args[1]);
         JS_FreeValue(ctx, args[2]);
 
+        // The callback's exception is left pending, so that the caller of
+        // forEachChunk can catch it
         if (JS_IsException(val))
         {
-          js_dump_error(ctx);
-          failed = true;
           return false;
         }
 
@@ -231,7 +509,7 @@ namespace js
         return true;
       });
 
-    if (failed)
+    if (!ok)
     {
       return JS_EXCEPTION;
     }
@@ -290,14 +568,12 @@ namespace js
       }
     }
 
-    auto handle = tx_ctx_ptr->tx->rw<KVMap>(property_name);
-
     // This follows the interface of Map:
     // https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map
     // Keys and values are ArrayBuffers. Keys are matched based on their
     // contents.
     auto view_val = JS_NewObjectClass(ctx, kv_map_handle_class_id);
-    JS_SetOpaque(view_val, handle);
+    JS_SetOpaque(view_val, new KVMapHandleRef{tx_ctx_ptr, property_name});
 
     JS_SetPropertyStr(
       ctx, view_val, "has", JS_NewCFunction(ctx, js_kv_map_has, "has", 1));
@@ -345,6 +621,12 @@ namespace js
       "forEach",
       JS_NewCFunction(ctx, js_kv_map_foreach, "forEach", 1));
 
+    JS_SetPropertyStr(
+      ctx,
+      view_val,
+      "forEachChunk",
+      JS_NewCFunction(ctx, js_kv_map_foreach_chunk, "forEachChunk", 2));
+
     desc->flags = 0;
     desc->value = view_val;
 
@@ -769,6 +1051,28 @@ namespace js
     return JS_UNDEFINED;
   }
 
+  static JSValue read_module_bytecode(
+    JSContext* ctx,
+    const std::vector<uint8_t>& bytecode,
+    const char* module_name)
+  {
+    auto module_val = JS_ReadObject(
+      ctx, bytecode.data(), bytecode.size(), JS_READ_OBJ_BYTECODE);
+    if (JS_IsException(module_val))
+    {
+      js::js_dump_error(ctx);
+      throw std::runtime_error(fmt::format(
+        "Failed to deserialize bytecode for module '{}'", module_name));
+    }
+    if (JS_ResolveModule(ctx, module_val) < 0)
+    {
+      js::js_dump_error(ctx);
+      throw std::runtime_error(fmt::format(
+        "Failed to resolve dependencies for module '{}'", module_name));
+    }
+    return module_val;
+  }
+
   JSValue load_app_module(JSContext* ctx, const char* module_name, kv::Tx* tx)
   {
     std::string module_name_kv(module_name);
@@ -793,15 +1097,27 @@ namespace js
         bytecode = std::nullopt;
     }
 
+    auto& module_cache = get_module_cache();
     JSValue module_val;
 
     if (!bytecode.has_value())
     {
-      LOG_TRACE_FMT("Loading module '{}'", module_name_kv);
-
       auto module = modules->get(module_name_kv);
       auto& js = module.value();
 
+      const crypto::Sha256Hash digest(js);
+      auto cached_bytecode =
+        module_cache.get(module_name_kv, digest, ccf::quickjs_version);
+      if (cached_bytecode != nullptr)
+      {
+        LOG_TRACE_FMT("Loading module from node cache '{}'", module_name_kv);
+        module_cache.record_hit();
+        return read_module_bytecode(ctx, *cached_bytecode, module_name);
+      }
+
+      LOG_TRACE_FMT("Loading module '{}'", module_name_kv);
+      module_cache.record_miss();
+
       const char* buf = js.c_str();
       size_t buf_len = js.size();
       module_val = JS_Eval(
@@ -816,26 +1132,33 @@ namespace js
         throw std::runtime_error(
           fmt::format("Failed to compile module '{}'", module_name));
       }
-    }
-    else
-    {
-      LOG_TRACE_FMT("Loading module from cache '{}'", module_name_kv);
 
-      module_val = JS_ReadObject(
-        ctx, bytecode->data(), bytecode->size(), JS_READ_OBJ_BYTECODE);
-      if (JS_IsException(module_val))
+      // Keep the compiled module, so that other interpreters do not need to
+      // compile it again
+      size_t out_buf_len;
+      uint8_t* out_buf =
+        JS_WriteObject(ctx, &out_buf_len, module_val, JS_WRITE_OBJ_BYTECODE);
+      if (out_buf != nullptr)
       {
-        js::js_dump_error(ctx);
-        throw std::runtime_error(fmt::format(
-          "Failed to deserialize bytecode for module '{}'", module_name));
+        module_cache.put(
+          module_name_kv,
+          digest,
+          ccf::quickjs_version,
+          {out_buf, out_buf + out_buf_len});
+        js_free(ctx, out_buf);
       }
-      if (JS_ResolveModule(ctx, module_val) < 0)
+      else
       {
-        js::js_dump_error(ctx);
-        throw std::runtime_error(fmt::format(
-          "Failed to resolve dependencies for module '{}'", module_name));
+        JS_FreeValue(ctx, JS_GetException(ctx));
       }
     }
+    else
+    {
+      LOG_TRACE_FMT("Loading module from cache '{}'", module_name_kv);
+      module_cache.record_miss();
+
+      module_val = read_module_bytecode(ctx, bytecode.value(), module_name);
+    }
     return module_val;
   }
 
@@ -950,6 +1273,7 @@ namespace js
 
     JS_NewClassID(&kv_map_handle_class_id);
     kv_map_handle_class_def.class_name = "KV Map Handle";
+    kv_map_handle_class_def.finalizer = js_kv_map_handle_finalizer;
 
     JS_NewClassID(&body_class_id);
     body_class_def.class_name = "Body";
@@ -1085,6 +1409,14 @@ namespace js
   JSValue Context::function(
     JSValue module, const std::string& func, const std::string& path)
   {
+    return exported_function(evaluate_module(module, path), func, path);
+  }
+
+  JSModuleDef* Context::evaluate_module(JSValue module, const std::string& path)
+  {
+    assert(JS_VALUE_GET_TAG(module) == JS_TAG_MODULE);
+    auto module_def = (JSModuleDef*)JS_VALUE_GET_PTR(module);
+
     auto eval_val = JS_EvalFunction(ctx, module);
     if (JS_IsException(eval_val))
     {
@@ -1094,9 +1426,13 @@ namespace js
     }
     JS_FreeValue(ctx, eval_val);
 
+    return module_def;
+  }
+
+  JSValue Context::exported_function(
+    JSModuleDef* module_def, const std::string& func, const std::string& path)
+  {
     // Get exported function from module
-    assert(JS_VALUE_GET_TAG(module) == JS_TAG_MODULE);
-    auto module_def = (JSModuleDef*)JS_VALUE_GET_PTR(module);
     auto export_count = JS_GetModuleExportEntriesCount(module_def);
     for (auto i = 0; i < export_count; i++)
     {
@@ -1172,6 +1508,59 @@ namespace js
     JS_FreeValue(ctx, global_obj);
   }
 
+  static JSValue create_historical_state_obj(
+    const std::optional<ccf::TxID>& transaction_id,
+    ccf::historical::TxReceiptPtr receipt,
+    JSContext* ctx)
+  {
+    CCF_ASSERT(
+      transaction_id.has_value(),
+      "Expected receipt and transaction_id to both be passed");
+
+    auto state = JS_NewObject(ctx);
+
+    JS_SetPropertyStr(
+      ctx,
+      state,
+      "transactionId",
+      JS_NewString(ctx, transaction_id->to_str().c_str()));
+
+    ccf::Receipt receipt_out;
+    receipt->describe(receipt_out);
+    auto js_receipt = JS_NewObject(ctx);
+    JS_SetPropertyStr(
+      ctx,
+      js_receipt,
+      "signature",
+      JS_NewString(ctx, receipt_out.signature.c_str()));
+    JS_SetPropertyStr(
+      ctx, js_receipt, "root", JS_NewString(ctx, receipt_out.root.c_str()));
+    JS_SetPropertyStr(
+      ctx, js_receipt, "leaf", JS_NewString(ctx, receipt_out.leaf.c_str()));
+    JS_SetPropertyStr(
+      ctx,
+      js_receipt,
+      "nodeId",
+      JS_NewString(ctx, receipt_out.node_id.value().c_str()));
+    auto proof = JS_NewArray(ctx);
+    uint32_t i = 0;
+    for (auto& element : receipt_out.proof)
+    {
+      auto js_element = JS_NewObject(ctx);
+      auto is_left = element.left.has_value();
+      JS_SetPropertyStr(
+        ctx,
+        js_element,
+        is_left ? "left" : "right",
+        JS_NewString(
+          ctx, (is_left ? element.left : element.right).value().c_str()));
+      JS_DefinePropertyValueUint32(ctx, proof, i++, js_element, JS_PROP_C_W_E);
+    }
+    JS_SetPropertyStr(ctx, js_receipt, "proof", proof);
+    JS_SetPropertyStr(ctx, state, "receipt", js_receipt);
+    return state;
+  }
+
   JSValue create_ccf_obj(
     TxContext* txctx,
     enclave::RpcContext* rpc_ctx,
@@ -1273,53 +1662,11 @@ namespace js
     // Historical queries
     if (receipt != nullptr)
     {
-      CCF_ASSERT(
-        transaction_id.has_value(),
-        "Expected receipt and transaction_id to both be passed");
-
-      auto state = JS_NewObject(ctx);
-
-      JS_SetPropertyStr(
-        ctx,
-        state,
-        "transactionId",
-        JS_NewString(ctx, transaction_id->to_str().c_str()));
-
-      ccf::Receipt receipt_out;
-      receipt->describe(receipt_out);
-      auto js_receipt = JS_NewObject(ctx);
-      JS_SetPropertyStr(
-        ctx,
-        js_receipt,
-        "signature",
-        JS_NewString(ctx, receipt_out.signature.c_str()));
-      JS_SetPropertyStr(
-        ctx, js_receipt, "root", JS_NewString(ctx, receipt_out.root.c_str()));
-      JS_SetPropertyStr(
-        ctx, js_receipt, "leaf", JS_NewString(ctx, receipt_out.leaf.c_str()));
       JS_SetPropertyStr(
         ctx,
-        js_receipt,
-        "nodeId",
-        JS_NewString(ctx, receipt_out.node_id.value().c_str()));
-      auto proof = JS_NewArray(ctx);
-      uint32_t i = 0;
-      for (auto& element : receipt_out.proof)
-      {
-        auto js_element = JS_NewObject(ctx);
-        auto is_left = element.left.has_value();
-        JS_SetPropertyStr(
-          ctx,
-          js_element,
-          is_left ? "left" : "right",
-          JS_NewString(
-            ctx, (is_left ? element.left : element.right).value().c_str()));
-        JS_DefinePropertyValueUint32(
-          ctx, proof, i++, js_element, JS_PROP_C_W_E);
-      }
-      JS_SetPropertyStr(ctx, js_receipt, "proof", proof);
-      JS_SetPropertyStr(ctx, state, "receipt", js_receipt);
-      JS_SetPropertyStr(ctx, ccf, "historicalState", state);
+        ccf,
+        "historicalState",
+        create_historical_state_obj(transaction_id, receipt, ctx));
     }
 
     // Node state
@@ -1438,6 +1785,38 @@ namespace js
     JS_FreeValue(ctx, global_obj);
   }
 
+  void rebind_global_ccf(
+    enclave::RpcContext* rpc_ctx,
+    const std::optional<ccf::TxID>& transaction_id,
+    ccf::historical::TxReceiptPtr receipt,
+    JSContext* ctx)
+  {
+    auto global_obj = JS_GetGlobalObject(ctx);
+    auto ccf = JS_GetPropertyStr(ctx, global_obj, "ccf");
+
+    auto rpc = JS_GetPropertyStr(ctx, ccf, "rpc");
+    JS_SetOpaque(rpc, rpc_ctx);
+    JS_FreeValue(ctx, rpc);
+
+    if (receipt != nullptr)
+    {
+      JS_SetPropertyStr(
+        ctx,
+        ccf,
+        "historicalState",
+        create_historical_state_obj(transaction_id, receipt, ctx));
+    }
+    else
+    {
+      auto historical_state_atom = JS_NewAtom(ctx, "historicalState");
+      JS_DeleteProperty(ctx, ccf, historical_state_atom, 0);
+      JS_FreeAtom(ctx, historical_state_atom);
+    }
+
+    JS_FreeValue(ctx, ccf);
+    JS_FreeValue(ctx, global_obj);
+  }
+
   void Runtime::add_ccf_classdefs()
   {
     // Register class for KV
@@ -57,6 +57,13 @@ namespace js
     ccf::AbstractNodeState* host_node_state,
     ccf::NetworkState* network_state,
     JSContext* ctx);
+  // Rebinds the ccf global, populated by populate_global_ccf(), to another
+  // request. The KV is rebound by updating the TxContext it was populated with.
+  void rebind_global_ccf(
+    enclave::RpcContext* rpc_ctx,
+    const std::optional<ccf::TxID>& transaction_id,
+    ccf::historical::TxReceiptPtr receipt,
+    JSContext* ctx);
   void populate_global_openenclave(JSContext* ctx);
 
   JSValue js_print(JSContext* ctx, JSValueConst, int argc, JSValueConst* argv);
@@ -204,6 +211,14 @@ namespace js
       const std::string& path);
     JSValue function(
       JSValue module, const std::string& func, const std::string& path);
+
+    // Evaluates a compiled module. The returned module definition remains
+    // valid for the lifetime of this context.
+    JSModuleDef* evaluate_module(JSValue module, const std::string& path);
+    JSValue exported_function(
+      JSModuleDef* module_def,
+      const std::string& func,
+      const std::string& path);
   };
 
 #pragma clang diagnostic pop
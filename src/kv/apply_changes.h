@@ -56,6 +56,15 @@ namespace kv
       views[map_name] = mc.map->create_committer(mc.changeset.get());
     }
 
+    // Read sets are validated against the latest state of each map before
+    // any map is locked, so that prepare() only checks the commits made
+    // since, and transactions on disjoint keys of a map spend little time
+    // holding its lock
+    for (auto it = views.begin(); it != views.end(); ++it)
+    {
+      it->second->prevalidate(track_read_versions);
+    }
+
     for (auto it = changes.begin(); it != changes.end(); ++it)
     {
       bool changeset_has_writes = it->second.changeset->has_writes();
@@ -45,6 +45,26 @@ namespace kv
     return version < 0;
   }
 
+  // MapStateVersion identifies the state of a single map at the start of a
+  // transaction. The rollback counter distinguishes states which have been
+  // rolled back from later states reusing the same version.
+  struct MapStateVersion
+  {
+    size_t rollback_counter = 0;
+    Version version = NoVersion;
+
+    bool operator==(const MapStateVersion& other) const
+    {
+      return rollback_counter == other.rollback_counter &&
+        version == other.version;
+    }
+
+    bool operator!=(const MapStateVersion& other) const
+    {
+      return !(*this == other);
+    }
+  };
+
   // Term describes an epoch of Versions. It is incremented when global kv's
   // writer(s) changes. Term and Version combined give a unique identifier for
   // all accepted kv modifications. Terms are handled by Consensus via the
@@ -357,6 +377,7 @@ namespace kv
       const std::vector<uint8_t>& request,
       uint8_t frame_format) = 0;
     virtual void append(const std::vector<uint8_t>& data) = 0;
+    virtual void append_entry(const crypto::Sha256Hash& digest) = 0;
     virtual void rollback(
       const kv::TxID& tx_id, kv::Term term_of_next_version_) = 0;
     virtual void compact(Version v) = 0;
@@ -461,6 +482,9 @@ namespace kv
     std::vector<uint8_t> data;
     std::vector<ConsensusHookPtr> hooks;
 
+    // Digest of data, if it was computed before the transaction was ordered
+    std::optional<crypto::Sha256Hash> digest = std::nullopt;
+
     PendingTxInfo(
       CommitResult success_,
       std::vector<uint8_t>&& data_,
@@ -475,6 +499,15 @@ namespace kv
   {
   public:
     virtual PendingTxInfo call() = 0;
+
+    // True if call() does not depend on the state of the Store or of its
+    // TxHistory, in which case it may be called before the transaction is
+    // ordered (ie. outside of the Store's version_lock)
+    virtual bool is_independent() const
+    {
+      return false;
+    }
+
     virtual ~PendingTx() = default;
   };
 
@@ -495,6 +528,30 @@ namespace kv
       return PendingTxInfo(
         CommitResult::SUCCESS, std::move(data), std::move(hooks));
     }
+
+    bool is_independent() const override
+    {
+      return true;
+    }
+  };
+
+  class PreparedPendingTx : public PendingTx
+  {
+  private:
+    PendingTxInfo info;
+
+  public:
+    PreparedPendingTx(PendingTxInfo&& info_) : info(std::move(info_)) {}
+
+    PendingTxInfo call() override
+    {
+      return std::move(info);
+    }
+
+    bool is_independent() const override
+    {
+      return true;
+    }
   };
 
   class AbstractTxEncryptor
@@ -539,6 +596,9 @@ namespace kv
     virtual ~AbstractCommitter() = default;
 
     virtual bool has_writes() = 0;
+    // Called before the map is locked for prepare(), so that work which
+    // does not need the lock can be done without holding it
+    virtual void prevalidate(bool) {}
     virtual bool prepare(bool track_commits, Version& max_conflict_version) = 0;
     virtual void commit(Version v, bool track_read_versions) = 0;
     virtual ConsensusHookPtr post_commit() = 0;
@@ -565,6 +625,11 @@ namespace kv
     }
   };
 
+  // Calls f(i) for each i in [0, n) and returns once all calls have
+  // completed. Calls may be made in parallel, from other threads.
+  using ParallelFor =
+    std::function<void(size_t n, const std::function<void(size_t)>& f)>;
+
   class AbstractStore;
   class AbstractMap : public std::enable_shared_from_this<AbstractMap>,
                       public NamedHandleMixin
@@ -574,7 +639,28 @@ namespace kv
     {
     public:
       virtual ~Snapshot() = default;
-      virtual void serialise(KvStoreSerialiser& s) = 0;
+
+      virtual size_t get_serialised_size() = 0;
+
+      /** Serialise the state of the map in segments of consecutive entries,
+       * each of at most max_segment_size bytes unless it holds a single
+       * larger entry. Snapshots of different maps may be serialised in
+       * parallel.
+       */
+      virtual std::vector<std::vector<uint8_t>> serialise_segments(
+        size_t max_segment_size) = 0;
+
+      /// Write a segment produced by serialise_segments() to s
+      virtual void write_segment(
+        KvStoreSerialiser& s, const std::vector<uint8_t>& segment) = 0;
+
+      /** Snapshot of the entries of the map which changed since base, a
+       * snapshot of the same map at an earlier version, or nullptr if the map
+       * is unchanged. If base is nullptr, the map did not exist then and all
+       * its entries are included.
+       */
+      virtual std::unique_ptr<Snapshot> diff(const Snapshot* base) = 0;
+      virtual const std::string& get_name() const = 0;
       virtual SecurityDomain get_security_domain() = 0;
     };
 
@@ -626,13 +712,30 @@ namespace kv
   class AbstractStore
   {
   public:
+    // Called with each serialised chunk of a snapshot, in order
+    using SnapshotChunkHandler =
+      std::function<void(std::vector<uint8_t>&& chunk)>;
+
     class AbstractSnapshot
     {
     public:
       virtual ~AbstractSnapshot() = default;
       virtual Version get_version() const = 0;
-      virtual std::vector<uint8_t> serialise(
-        std::shared_ptr<AbstractTxEncryptor> encryptor) = 0;
+
+      /** Delta snapshot holding only the maps and entries which changed since
+       * base, a snapshot of the same store at an earlier version whose
+       * serialisation hashes to base_hash. The delta can only be deserialised
+       * after base.
+       */
+      virtual std::unique_ptr<AbstractSnapshot> diff(
+        const AbstractSnapshot& base,
+        const std::vector<uint8_t>& base_hash) = 0;
+
+      virtual void serialise(
+        std::shared_ptr<AbstractTxEncryptor> encryptor,
+        size_t max_chunk_size,
+        const SnapshotChunkHandler& f,
+        const ParallelFor& parallel_for) = 0;
     };
 
     virtual ~AbstractStore() {}
@@ -676,6 +779,10 @@ namespace kv
     virtual std::unique_ptr<AbstractSnapshot> snapshot(Version v) = 0;
     virtual std::vector<uint8_t> serialise_snapshot(
       std::unique_ptr<AbstractSnapshot> snapshot) = 0;
+    virtual void serialise_snapshot(
+      AbstractSnapshot& snapshot,
+      size_t max_chunk_size,
+      const SnapshotChunkHandler& f) = 0;
     virtual ApplyResult deserialise_snapshot(
       const std::vector<uint8_t>& data,
       ConsensusHookPtrs& hooks,
@@ -108,6 +108,21 @@ namespace kv
         KSerialiser::to_serialised(key));
     }
 
+    /** Get the version of the state of this map at the start of this
+     * transaction.
+     *
+     * Two transactions which get the same version see the same entries in this
+     * map, ignoring their own pending writes. This can be used to reuse a value
+     * derived from the entire map, rather than iterating over it again. As with
+     * iteration, this introduces a read dependency on the entire map.
+     *
+     * @return Version of the applied state of this map
+     */
+    MapStateVersion get_state_version()
+    {
+      return read_handle.get_state_version();
+    }
+
     /** Iterate over all entries in the map.
      *
      * The passed functor should have the signature `bool(const K& k, const V&
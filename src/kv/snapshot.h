@@ -2,10 +2,93 @@
 // Licensed under the Apache 2.0 License.
 #pragma once
 
+#include "kv/kv_serialiser.h"
 #include "kv/kv_types.h"
 
+#include <limits>
+#include <map>
+
 namespace kv
 {
+  // Maps are serialised and deserialised in parallel in windows of about this
+  // many chunks at a time, which bounds the memory used by the serialised
+  // maps
+  static constexpr size_t snapshot_parallel_window_chunks = 16;
+
+  // A delta snapshot records the version and hash of the snapshot it is
+  // against as the first map of its first chunk, under this name. This is not
+  // a map of the store.
+  static constexpr auto snapshot_delta_base_name =
+    "public:ccf.internal.snapshot_delta_base";
+
+  /** Split a snapshot into the chain of snapshots it is made of, as resolved
+   * by the host: a full snapshot followed by deltas, each against the
+   * previous snapshot of the chain. Snapshots are told apart by the version
+   * of their chunks, which increases along the chain. Returns std::nullopt if
+   * the chunks are malformed.
+   */
+  static std::optional<std::vector<CBuffer>> split_snapshot_chain(
+    const std::vector<uint8_t>& data,
+    const std::shared_ptr<AbstractTxEncryptor>& encryptor)
+  {
+    std::vector<CBuffer> chain;
+    Version last_version = NoVersion;
+
+    const uint8_t* chunk = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0)
+    {
+      size_t chunk_size = serialised_entry_header_size;
+      if (remaining >= chunk_size)
+      {
+        chunk_size +=
+          serialized::peek<SerialisedEntryHeader>(chunk, remaining).size;
+      }
+      if (chunk_size > remaining)
+      {
+        LOG_FAIL_FMT(
+          "Snapshot chunk of size {} exceeds remaining snapshot size {}",
+          chunk_size,
+          remaining);
+        return std::nullopt;
+      }
+
+      // Only the public header of the chunk is read
+      auto d = KvStoreDeserialiser(encryptor, SecurityDomain::PUBLIC);
+      kv::Term term;
+      auto v_ = d.init(chunk, chunk_size, term);
+      if (!v_.has_value())
+      {
+        LOG_FAIL_FMT("Initialisation of deserialise object failed");
+        return std::nullopt;
+      }
+      auto [v, _] = v_.value();
+
+      if (chain.empty() || v > last_version)
+      {
+        chain.emplace_back(chunk, chunk_size);
+      }
+      else if (v == last_version)
+      {
+        chain.back() = {chain.back().p, chain.back().n + chunk_size};
+      }
+      else
+      {
+        LOG_FAIL_FMT(
+          "Snapshot chunk at version {} follows chunk at later version {}",
+          v,
+          last_version);
+        return std::nullopt;
+      }
+      last_version = v;
+
+      chunk += chunk_size;
+      remaining -= chunk_size;
+    }
+
+    return chain;
+  }
+
   class StoreSnapshot : public AbstractStore::AbstractSnapshot
   {
   private:
@@ -15,6 +98,14 @@ namespace kv
     std::optional<std::vector<uint8_t>> hash_at_snapshot = std::nullopt;
     std::optional<std::vector<Version>> view_history = std::nullopt;
 
+    struct DeltaBase
+    {
+      Version version;
+      std::vector<uint8_t> hash;
+    };
+    // Only set for delta snapshots
+    std::optional<DeltaBase> delta_base = std::nullopt;
+
   public:
     StoreSnapshot(Version version_) : version(version_) {}
 
@@ -33,43 +124,162 @@ namespace kv
       view_history = std::move(view_history_);
     }
 
-    Version get_version() const
+    Version get_version() const override
     {
       return version;
     }
 
-    std::vector<uint8_t> serialise(
-      std::shared_ptr<AbstractTxEncryptor> encryptor)
+    std::unique_ptr<AbstractSnapshot> diff(
+      const AbstractSnapshot& base_,
+      const std::vector<uint8_t>& base_hash) override
+    {
+      const auto& base = dynamic_cast<const StoreSnapshot&>(base_);
+      if (base.version >= version)
+      {
+        throw std::logic_error(fmt::format(
+          "Cannot create delta snapshot at version {} against snapshot at "
+          "later version {}",
+          version,
+          base.version));
+      }
+
+      std::map<std::string, const kv::AbstractMap::Snapshot*> base_snapshots;
+      for (const auto& it : base.snapshots)
+      {
+        base_snapshots[it->get_name()] = it.get();
+      }
+
+      auto delta = std::make_unique<StoreSnapshot>(version);
+      for (const auto& it : snapshots)
+      {
+        auto search = base_snapshots.find(it->get_name());
+        auto map_delta = it->diff(
+          search != base_snapshots.end() ? search->second : nullptr);
+        if (map_delta != nullptr)
+        {
+          delta->add_map_snapshot(std::move(map_delta));
+        }
+      }
+      delta->hash_at_snapshot = hash_at_snapshot;
+      delta->view_history = view_history;
+      delta->delta_base = DeltaBase{base.version, base_hash};
+
+      return delta;
+    }
+
+    void serialise(
+      std::shared_ptr<AbstractTxEncryptor> encryptor,
+      size_t max_chunk_size,
+      const AbstractStore::SnapshotChunkHandler& f,
+      const ParallelFor& parallel_for) override
     {
+      // The snapshot is serialised as a sequence of chunks, each of which is a
+      // serialised entry whose private domain is encrypted on its own. Chunks
+      // hold whole map segments and are only larger than max_chunk_size when
+      // a single segment is. Chunks are passed to f as soon as they are
+      // complete so that the entire snapshot is never held in memory.
+      Term chunk_idx = 0;
+      size_t chunk_size = 0;
+
       // Set the execution dependency for the snapshot to be the version
       // previous to said snapshot to ensure that the correct snapshot is
       // serialized.
       // Note: Snapshots are always taken at compacted state so version only is
-      // unique enough to prevent IV reuse
-      KvStoreSerialiser serialiser(encryptor, {0, version}, version - 1, true);
+      // unique enough to prevent IV reuse across snapshots. Within a snapshot,
+      // the chunk index takes the place of the term in the IV so that each
+      // chunk is encrypted with a distinct IV.
+      auto make_serialiser = [&]() {
+        return std::make_unique<KvStoreSerialiser>(
+          encryptor, TxID{chunk_idx, version}, version - 1, true);
+      };
+      auto serialiser = make_serialiser();
 
       if (hash_at_snapshot.has_value())
       {
-        serialiser.serialise_raw(hash_at_snapshot.value());
+        serialiser->serialise_raw(hash_at_snapshot.value());
       }
 
       if (view_history.has_value())
       {
-        serialiser.serialise_view_history(view_history.value());
+        serialiser->serialise_view_history(view_history.value());
       }
 
+      if (delta_base.has_value())
+      {
+        serialiser->start_map(snapshot_delta_base_name, SecurityDomain::PUBLIC);
+        serialiser->serialise_entry_version(delta_base->version);
+        serialiser->serialise_raw(delta_base->hash);
+      }
+
+      auto get_serialiser = [&](size_t segment_size) -> KvStoreSerialiser& {
+        if (chunk_size > 0 && chunk_size + segment_size > max_chunk_size)
+        {
+          f(serialiser->get_raw_data());
+          chunk_idx++;
+          chunk_size = 0;
+          serialiser = make_serialiser();
+        }
+        chunk_size += segment_size;
+        return *serialiser;
+      };
+
+      std::vector<kv::AbstractMap::Snapshot*> ordered_snapshots;
       for (auto domain : {SecurityDomain::PUBLIC, SecurityDomain::PRIVATE})
       {
         for (const auto& it : snapshots)
         {
           if (it->get_security_domain() == domain)
           {
-            it->serialise(serialiser);
+            ordered_snapshots.push_back(it.get());
           }
         }
       }
 
-      return serialiser.get_raw_data();
+      // Maps are serialised in parallel, a window of maps at a time, and their
+      // segments are then written to chunks in order so that the serialised
+      // snapshot does not depend on the number of threads
+      const auto max_window_size =
+        max_chunk_size > std::numeric_limits<size_t>::max() /
+            snapshot_parallel_window_chunks ?
+        std::numeric_limits<size_t>::max() :
+        max_chunk_size * snapshot_parallel_window_chunks;
+
+      size_t window_start = 0;
+      while (window_start < ordered_snapshots.size())
+      {
+        size_t window_end = window_start;
+        size_t window_size = 0;
+        while (
+          window_end < ordered_snapshots.size() &&
+          (window_end == window_start || window_size < max_window_size))
+        {
+          window_size += ordered_snapshots[window_end]->get_serialised_size();
+          window_end++;
+        }
+
+        std::vector<std::vector<std::vector<uint8_t>>> window_segments(
+          window_end - window_start);
+        parallel_for(window_segments.size(), [&](size_t i) {
+          window_segments[i] =
+            ordered_snapshots[window_start + i]->serialise_segments(
+              max_chunk_size);
+        });
+
+        for (size_t i = 0; i < window_segments.size(); ++i)
+        {
+          auto map_snapshot = ordered_snapshots[window_start + i];
+          for (auto& segment : window_segments[i])
+          {
+            auto& s = get_serialiser(segment.size());
+            map_snapshot->write_segment(s, segment);
+            segment = {};
+          }
+        }
+
+        window_start = window_end;
+      }
+
+      f(serialiser->get_raw_data());
     }
   };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "apply_changes.h"
+#include "crypto/hash.h"
 #include "deserialise.h"
 #include "ds/ccf_exception.h"
 #include "kv/committable_tx.h"
@@ -15,6 +16,7 @@
 
 #define FMT_HEADER_ONLY
 #include <fmt/format.h>
+#include <set>
 
 namespace kv
 {
@@ -50,6 +52,11 @@ namespace kv
     std::unordered_map<Version, std::pair<std::unique_ptr<PendingTx>, bool>>
       pending_txs;
 
+    // Set while a thread is replicating pending transactions to consensus.
+    // Other committing threads then only queue their transactions in
+    // pending_txs, and rely on that thread to flush them.
+    bool flush_in_progress = false;
+
   public:
     void clear()
     {
@@ -67,6 +74,7 @@ namespace kv
       last_replicated = 0;
       last_committable = 0;
       rollback_count = 0;
+      flush_in_progress = false;
     }
   };
 
@@ -85,6 +93,13 @@ namespace kv
     std::shared_ptr<TxHistory> history = nullptr;
     std::shared_ptr<ccf::ProgressTracker> progress_tracker = nullptr;
     EncryptorPtr encryptor = nullptr;
+    ParallelFor parallel_for =
+      [](size_t n, const std::function<void(size_t)>& f) {
+        for (size_t i = 0; i < n; ++i)
+        {
+          f(i);
+        }
+      };
 
     kv::ReplicateType replicate_type = kv::ReplicateType::ALL;
     std::unordered_set<std::string> replicated_tables;
@@ -217,6 +232,15 @@ namespace kv
       return encryptor;
     }
 
+    /** Set the function used to serialise and deserialise the maps of
+     * snapshots in parallel. By default, maps are processed sequentially on
+     * the calling thread.
+     */
+    void set_parallel_for(const ParallelFor& parallel_for_)
+    {
+      parallel_for = parallel_for_;
+    }
+
     /** Get a map by name, iff it exists at the given version.
      *
      * This means a prior transaction must have created the map, and
@@ -392,9 +416,24 @@ namespace kv
 
     std::vector<uint8_t> serialise_snapshot(
       std::unique_ptr<AbstractSnapshot> snapshot) override
+    {
+      std::vector<uint8_t> serialised_snapshot;
+      serialise_snapshot(
+        *snapshot,
+        std::numeric_limits<size_t>::max(),
+        [&serialised_snapshot](std::vector<uint8_t>&& chunk) {
+          serialised_snapshot = std::move(chunk);
+        });
+      return serialised_snapshot;
+    }
+
+    void serialise_snapshot(
+      AbstractSnapshot& snapshot,
+      size_t max_chunk_size,
+      const SnapshotChunkHandler& f) override
     {
       auto e = get_encryptor();
-      return snapshot->serialise(e);
+      snapshot.serialise(e, max_chunk_size, f, parallel_for);
     }
 
     ApplyResult deserialise_snapshot(
@@ -404,97 +443,308 @@ namespace kv
       bool public_only = false) override
     {
       auto e = get_encryptor();
-      auto d = KvStoreDeserialiser(
-        e,
-        public_only ? kv::SecurityDomain::PUBLIC :
-                      std::optional<kv::SecurityDomain>());
+      const auto domain_restriction = public_only ?
+        kv::SecurityDomain::PUBLIC :
+        std::optional<kv::SecurityDomain>();
+      auto h = get_history();
 
-      kv::Term term;
-      auto v_ = d.init(data.data(), data.size(), term, is_historical);
-      if (!v_.has_value())
-      {
-        LOG_FAIL_FMT("Initialisation of deserialise object failed");
-        return ApplyResult::FAIL;
-      }
-      auto [v, _] = v_.value();
+      std::optional<Version> snapshot_version = std::nullopt;
+      std::vector<uint8_t> hash_at_snapshot;
+      std::vector<Version> view_history_;
 
-      std::lock_guard<std::mutex> mguard(maps_lock);
+      OrderedChanges changes;
+      MapCollection new_maps;
 
-      for (auto& it : maps)
+      // The snapshot may be a chain of a full snapshot followed by deltas, each
+      // of which only contains the maps and entries which changed since the
+      // previous snapshot of the chain
+      auto chain = split_snapshot_chain(data, e);
+      if (!chain.has_value())
       {
-        auto& [_, map] = it.second;
-        map->lock();
+        return ApplyResult::FAIL;
       }
 
-      std::vector<uint8_t> hash_at_snapshot;
-      auto h = get_history();
-      if (h)
+      // Per snapshot of the chain
+      bool first_chunk = true;
+      std::optional<std::string> last_map_name = std::nullopt;
+      std::set<std::string> snapshot_maps;
+      std::optional<std::pair<Version, std::vector<uint8_t>>> delta_base =
+        std::nullopt;
+      Version previous_snapshot_version = NoVersion;
+
+      // Segments of each map read from the current window of chunks, which
+      // are deserialised into change sets in parallel once the window is full
+      struct MapSegments
       {
-        hash_at_snapshot = d.deserialise_raw();
-      }
+        std::shared_ptr<kv::untyped::Map> map;
+        std::unique_ptr<untyped::ChangeSet>* changeset;
+        std::vector<kv::untyped::Map::SnapshotSegment> segments;
+      };
+      std::vector<MapSegments> window;
+
+      // Each chunk of the snapshot is a serialised entry, decrypted on its own.
+      // The raw segments of each map it contains are kept until the end of
+      // the window, and are then added to the change set deserialised from
+      // the previous windows, so that only a window of chunks is held in
+      // memory at a time.
+      auto deserialise_chunk = [&](const uint8_t* chunk, size_t chunk_size) {
+        auto d = KvStoreDeserialiser(e, domain_restriction);
+
+        kv::Term term;
+        auto v_ = d.init(chunk, chunk_size, term, is_historical);
+        if (!v_.has_value())
+        {
+          LOG_FAIL_FMT("Initialisation of deserialise object failed");
+          return false;
+        }
+        auto [v, _] = v_.value();
 
-      std::vector<Version> view_history_;
-      if (view_history)
-      {
-        view_history_ = d.deserialise_view_history();
-      }
+        if (first_chunk)
+        {
+          // The first chunk also contains the snapshot metadata
+          snapshot_version = v;
 
-      OrderedChanges changes;
-      MapCollection new_maps;
+          if (h)
+          {
+            hash_at_snapshot = d.deserialise_raw();
+          }
 
-      for (auto r = d.start_map(); r.has_value(); r = d.start_map())
-      {
-        const auto map_name = r.value();
+          if (view_history)
+          {
+            view_history_ = d.deserialise_view_history();
+          }
+        }
+        else if (v != snapshot_version.value())
+        {
+          LOG_FAIL_FMT(
+            "Snapshot chunk at version {} does not match snapshot version {}",
+            v,
+            snapshot_version.value());
+          return false;
+        }
+
+        for (auto r = d.start_map(); r.has_value(); r = d.start_map())
+        {
+          const auto map_name = r.value();
+
+          if (map_name == snapshot_delta_base_name)
+          {
+            if (!first_chunk || !snapshot_maps.empty())
+            {
+              LOG_FAIL_FMT(
+                "Unexpected delta snapshot base in snapshot at version {}", v);
+              return false;
+            }
+            auto base_version = d.deserialise_entry_version();
+            delta_base = std::make_pair(base_version, d.deserialise_raw());
+            continue;
+          }
+
+          if (map_name == last_map_name)
+          {
+            // Further segment of the same map, possibly from a previous
+            // window
+            if (window.empty() || window.back().map->get_name() != map_name)
+            {
+              auto& map_changes = changes[map_name];
+              window.push_back(
+                {std::dynamic_pointer_cast<kv::untyped::Map>(map_changes.map),
+                 &map_changes.changeset,
+                 {}});
+            }
+            window.back().segments.push_back(
+              window.back().map->deserialise_snapshot_segment(d));
+            continue;
+          }
+
+          // Segments of the same map must be contiguous
+          if (!snapshot_maps.insert(map_name).second)
+          {
+            LOG_FAIL_FMT("Failed to deserialise snapshot at version {}", v);
+            LOG_DEBUG_FMT("Multiple writes on map {}", map_name);
+            return false;
+          }
+
+          std::shared_ptr<kv::untyped::Map> map = nullptr;
+
+          auto changes_search = changes.find(map_name);
+          auto search = maps.find(map_name);
+          if (changes_search != changes.end())
+          {
+            // Map already deserialised from a previous snapshot of the chain
+            map = std::dynamic_pointer_cast<kv::untyped::Map>(
+              changes_search->second.map);
+          }
+          else if (search != maps.end())
+          {
+            map = search->second.second;
+          }
+          else
+          {
+            map = std::make_shared<kv::untyped::Map>(
+              this,
+              map_name,
+              get_security_domain(map_name),
+              is_map_replicated(map_name),
+              should_track_dependencies(map_name));
+            new_maps[map_name] = map;
+            LOG_DEBUG_FMT(
+              "Creating map {} while deserialising snapshot at version {}",
+              map_name,
+              v);
+          }
 
-        std::shared_ptr<kv::untyped::Map> map = nullptr;
+          auto& map_changes = changes[map_name];
+          map_changes.map = map;
+          window.push_back({map, &map_changes.changeset, {}});
+          window.back().segments.push_back(
+            map->deserialise_snapshot_segment(d));
+          last_map_name = map_name;
+        }
 
-        auto search = maps.find(map_name);
-        if (search == maps.end())
+        if (!d.end())
         {
-          map = std::make_shared<kv::untyped::Map>(
-            this,
-            map_name,
-            get_security_domain(map_name),
-            is_map_replicated(map_name),
-            should_track_dependencies(map_name));
-          new_maps[map_name] = map;
-          LOG_DEBUG_FMT(
-            "Creating map {} while deserialising snapshot at version {}",
-            map_name,
-            v);
+          LOG_FAIL_FMT("Unexpected content in snapshot at version {}", v);
+          return false;
         }
-        else
+
+        first_chunk = false;
+        return true;
+      };
+
+      // Deserialise the segments of each map of the window into its change
+      // set, each map on its own thread
+      auto deserialise_window = [&]() {
+        std::vector<uint8_t> failed(window.size(), false);
+        parallel_for(window.size(), [&](size_t i) {
+          auto& map_segments = window[i];
+          auto deserialised_snapshot_changes =
+            map_segments.map->deserialise_snapshot_changes(
+              map_segments.segments, *map_segments.changeset);
+          if (deserialised_snapshot_changes == nullptr)
+          {
+            failed[i] = true;
+            return;
+          }
+          *map_segments.changeset = std::move(deserialised_snapshot_changes);
+        });
+
+        for (size_t i = 0; i < window.size(); ++i)
         {
-          map = search->second.second;
+          if (failed[i])
+          {
+            LOG_FAIL_FMT(
+              "Failed to deserialise snapshot at version {}",
+              snapshot_version.value());
+            LOG_DEBUG_FMT(
+              "Inconsistent segments for map {}", window[i].map->get_name());
+            return false;
+          }
         }
 
-        auto changes_search = changes.find(map_name);
-        if (changes_search != changes.end())
+        window.clear();
+        return true;
+      };
+
+      // Each delta must be against the previous snapshot of the chain, which
+      // it identifies by version and hash, and the chain must start with a
+      // full snapshot
+      auto check_delta_base = [&](size_t i) {
+        if (i == 0)
         {
-          LOG_FAIL_FMT("Failed to deserialise snapshot at version {}", v);
-          LOG_DEBUG_FMT("Multiple writes on map {}", map_name);
-          return ApplyResult::FAIL;
+          if (delta_base.has_value())
+          {
+            LOG_FAIL_FMT(
+              "Delta snapshot at version {} is not preceded by its base "
+              "snapshot at version {}",
+              snapshot_version.value(),
+              delta_base->first);
+            return false;
+          }
+          return true;
         }
 
-        auto deserialised_snapshot_changes =
-          map->deserialise_snapshot_changes(d);
+        if (!delta_base.has_value())
+        {
+          LOG_FAIL_FMT(
+            "Full snapshot at version {} follows another snapshot",
+            snapshot_version.value());
+          return false;
+        }
 
-        // Take ownership of the produced change set, store it to be committed
-        // later
-        changes[map_name] = {map, std::move(deserialised_snapshot_changes)};
+        const auto base_hash = crypto::Sha256Hash(chain.value()[i - 1]);
+        if (
+          delta_base->first != previous_snapshot_version ||
+          delta_base->second !=
+            std::vector<uint8_t>(base_hash.h.begin(), base_hash.h.end()))
+        {
+          LOG_FAIL_FMT(
+            "Delta snapshot at version {} is not against the previous "
+            "snapshot at version {}",
+            snapshot_version.value(),
+            previous_snapshot_version);
+          return false;
+        }
+        return true;
+      };
+
+      std::lock_guard<std::mutex> mguard(maps_lock);
+
+      bool success = true;
+      for (size_t i = 0; success && i < chain->size(); ++i)
+      {
+        if (snapshot_version.has_value())
+        {
+          previous_snapshot_version = snapshot_version.value();
+        }
+        first_chunk = true;
+        last_map_name = std::nullopt;
+        snapshot_maps.clear();
+        delta_base = std::nullopt;
+
+        size_t window_chunks = 0;
+        const uint8_t* chunk = chain.value()[i].p;
+        size_t remaining = chain.value()[i].n;
+        while (success && remaining > 0)
+        {
+          // Chunk sizes have already been checked by split_snapshot_chain()
+          const auto chunk_size = serialised_entry_header_size +
+            serialized::peek<SerialisedEntryHeader>(chunk, remaining).size;
+          const auto is_first_chunk = first_chunk;
+
+          success = deserialise_chunk(chunk, chunk_size);
+          chunk += chunk_size;
+          remaining -= chunk_size;
+
+          if (success && is_first_chunk)
+          {
+            success = check_delta_base(i);
+          }
+
+          // Windows end with each snapshot of the chain, so that segments of
+          // a map from different snapshots are never in the same window
+          if (
+            success &&
+            (++window_chunks == snapshot_parallel_window_chunks ||
+             remaining == 0))
+          {
+            success = deserialise_window();
+            window_chunks = 0;
+          }
+        }
       }
 
-      for (auto& it : maps)
+      if (!success)
       {
-        auto& [_, map] = it.second;
-        map->unlock();
+        return ApplyResult::FAIL;
       }
 
-      if (!d.end())
+      if (!snapshot_version.has_value())
       {
-        LOG_FAIL_FMT("Unexpected content in snapshot at version {}", v);
+        LOG_FAIL_FMT("Snapshot is empty");
         return ApplyResult::FAIL;
       }
+      const auto v = snapshot_version.value();
 
       // Each map is committed at a different version, independently of the
       // overall snapshot version. The commit versions for each map are
@@ -990,11 +1240,16 @@ namespace kv
         txid.version,
         (globally_committable ? " globally_committable" : ""));
 
-      BatchVector batch;
-      Version previous_last_replicated = 0;
-      Version next_last_replicated = 0;
-      Version previous_rollback_count = 0;
-      ccf::View replication_view = 0;
+      auto h = get_history();
+      if (h && pending_tx->is_independent())
+      {
+        // The serialised entry does not depend on the order in which it is
+        // committed, so it is produced and hashed here by the committing
+        // thread, rather than under version_lock
+        auto info = pending_tx->call();
+        info.digest = crypto::Sha256Hash({info.data.data(), info.data.size()});
+        pending_tx = std::make_unique<PreparedPendingTx>(std::move(info));
+      }
 
       {
         std::lock_guard<std::mutex> vguard(version_lock);
@@ -1019,66 +1274,141 @@ namespace kv
           {txid.version,
            std::make_pair(std::move(pending_tx), globally_committable)});
 
-        auto h = get_history();
-        auto c = get_consensus();
+        // Group commit: a single thread at a time flushes contiguous pending
+        // transactions to consensus. If a flush is already in progress, it
+        // will pick up this transaction once its current batch is replicated.
+        if (flush_in_progress)
+        {
+          return CommitResult::SUCCESS;
+        }
+
+        flush_in_progress = true;
+      }
+
+      try
+      {
+        return flush_pending_txs(c, h, txid.version);
+      }
+      catch (...)
+      {
+        // Let the next committing thread flush the remaining transactions
+        std::lock_guard<std::mutex> vguard(version_lock);
+        flush_in_progress = false;
+        throw;
+      }
+    }
+
+    // Replicates batches of contiguous pending transactions until none are
+    // left, or until a batch fails to replicate. Returns the result of the
+    // batch containing own_version, which is SUCCESS if it is not replicated
+    // by this thread.
+    CommitResult flush_pending_txs(
+      const std::shared_ptr<Consensus>& c,
+      const std::shared_ptr<TxHistory>& h,
+      Version own_version)
+    {
+      auto result = CommitResult::SUCCESS;
+
+      while (true)
+      {
+        BatchVector batch;
+        Version previous_last_replicated = 0;
+        Version next_last_replicated = 0;
+        Version previous_rollback_count = 0;
+        ccf::View replication_view = 0;
 
-        for (Version offset = 1; true; ++offset)
         {
-          auto search = pending_txs.find(last_replicated + offset);
-          if (search == pending_txs.end())
+          std::lock_guard<std::mutex> vguard(version_lock);
+
+          for (Version offset = 1; true; ++offset)
           {
-            break;
+            auto search = pending_txs.find(last_replicated + offset);
+            if (search == pending_txs.end())
+            {
+              break;
+            }
+
+            auto& [pending_tx_, committable_] = search->second;
+            auto [success_, data_, hooks_, digest_] = pending_tx_->call();
+            auto data_shared =
+              std::make_shared<std::vector<uint8_t>>(std::move(data_));
+            auto hooks_shared =
+              std::make_shared<kv::ConsensusHookPtrs>(std::move(hooks_));
+
+            // NB: this cannot happen currently. Regular Tx only make it here
+            // if they did succeed, and signatures cannot conflict because they
+            // execute in order with a read_version that's version - 1, so even
+            // two contiguous signatures are fine
+            if (success_ != CommitResult::SUCCESS)
+            {
+              LOG_DEBUG_FMT("Failed Tx commit {}", last_replicated + offset);
+            }
+
+            if (h)
+            {
+              if (digest_.has_value())
+              {
+                h->append_entry(digest_.value());
+              }
+              else
+              {
+                h->append(*data_shared);
+              }
+            }
+
+            LOG_DEBUG_FMT(
+              "Batching {} ({})",
+              last_replicated + offset,
+              data_shared->size());
+
+            batch.emplace_back(
+              last_replicated + offset,
+              data_shared,
+              committable_,
+              hooks_shared);
           }
 
-          auto& [pending_tx_, committable_] = search->second;
-          auto [success_, data_, hooks_] = pending_tx_->call();
-          auto data_shared =
-            std::make_shared<std::vector<uint8_t>>(std::move(data_));
-          auto hooks_shared =
-            std::make_shared<kv::ConsensusHookPtrs>(std::move(hooks_));
-
-          // NB: this cannot happen currently. Regular Tx only make it here if
-          // they did succeed, and signatures cannot conflict because they
-          // execute in order with a read_version that's version - 1, so even
-          // two contiguous signatures are fine
-          if (success_ != CommitResult::SUCCESS)
+          if (batch.size() == 0)
           {
-            LOG_DEBUG_FMT("Failed Tx commit {}", last_replicated + offset);
+            flush_in_progress = false;
+            return result;
           }
 
-          if (h)
+          previous_rollback_count = rollback_count;
+          previous_last_replicated = last_replicated;
+          next_last_replicated = last_replicated + batch.size();
+
+          replication_view = term_of_next_version;
+
+          if (consensus->type() == ConsensusType::BFT && consensus->is_backup())
           {
-            h->append(*data_shared);
+            last_replicated = next_last_replicated;
           }
+        }
 
-          LOG_DEBUG_FMT(
-            "Batching {} ({})", last_replicated + offset, data_shared->size());
+        const auto replicated = c->replicate(batch, replication_view);
+        const auto own_batch = own_version > previous_last_replicated &&
+          own_version <= next_last_replicated;
 
-          batch.emplace_back(
-            last_replicated + offset, data_shared, committable_, hooks_shared);
-          pending_txs.erase(search);
-        }
+        std::lock_guard<std::mutex> vguard(version_lock);
 
-        if (batch.size() == 0)
+        // Pending transactions are only dropped once their batch has been
+        // handed to consensus, unless a rollback has already discarded them
+        if (previous_rollback_count == rollback_count)
         {
-          return CommitResult::SUCCESS;
+          for (const auto& entry : batch)
+          {
+            pending_txs.erase(std::get<0>(entry));
+          }
         }
 
-        previous_rollback_count = rollback_count;
-        previous_last_replicated = last_replicated;
-        next_last_replicated = last_replicated + batch.size();
-
-        replication_view = term_of_next_version;
-
-        if (consensus->type() == ConsensusType::BFT && consensus->is_backup())
+        if (!replicated)
         {
-          last_replicated = next_last_replicated;
+          LOG_DEBUG_FMT("Failed to replicate");
+          flush_in_progress = false;
+          return own_batch ? CommitResult::FAIL_NO_REPLICATE : result;
         }
-      }
 
-      if (c->replicate(batch, replication_view))
-      {
-        std::lock_guard<std::mutex> vguard(version_lock);
         if (
           last_replicated == previous_last_replicated &&
           previous_rollback_count == rollback_count &&
@@ -1086,12 +1416,6 @@ namespace kv
         {
           last_replicated = next_last_replicated;
         }
-        return CommitResult::SUCCESS;
-      }
-      else
-      {
-        LOG_DEBUG_FMT("Failed to replicate");
-        return CommitResult::FAIL_NO_REPLICATE;
       }
     }
 
@@ -5,10 +5,20 @@
 #include "kv/store.h"
 #include "kv/test/stub_consensus.h"
 #include "node/encryptor.h"
+#include "node/history.h"
 
 #include <msgpack/msgpack.hpp>
 #include <picobench/picobench.hpp>
 #include <string>
+#include <thread>
+
+threading::ThreadMessaging threading::ThreadMessaging::thread_messaging;
+std::atomic<uint16_t> threading::ThreadMessaging::thread_count = 0;
+
+namespace threading
+{
+  std::map<std::thread::id, uint16_t> thread_ids;
+}
 
 using KeyType = kv::serialisers::SerialisedEntry;
 using ValueType = kv::serialisers::SerialisedEntry;
@@ -167,6 +177,155 @@ static void commit_latency(picobench::state& s)
   s.stop_timer();
 }
 
+// Commits s.iterations() single-write transactions from THREAD_COUNT
+// concurrent threads, each writing to its own map. Entries are appended to a
+// Merkle tree, as on a node, so that the cost of hashing them is included.
+template <size_t THREAD_COUNT>
+static void commit_concurrent(picobench::state& s)
+{
+  logger::config::level() = logger::INFO;
+
+  auto consensus = std::make_shared<kv::test::StubConsensus>();
+  kv::Store kv_store(consensus);
+  auto secrets = create_ledger_secrets();
+  auto encryptor = std::make_shared<ccf::NodeEncryptor>(secrets);
+  kv_store.set_encryptor(encryptor);
+
+  auto kp = crypto::make_key_pair();
+  auto history = std::make_shared<ccf::MerkleTxHistory>(
+    kv_store, kv::test::PrimaryNodeId, *kp);
+  kv_store.set_history(history);
+
+  std::vector<std::string> map_names;
+  {
+    auto tx = kv_store.create_tx();
+    for (size_t t = 0; t < THREAD_COUNT; ++t)
+    {
+      map_names.push_back(fmt::format("map{}", t));
+      tx.rw<MapType>(map_names.back())->put(gen_key(0), gen_value(0));
+    }
+    auto rc = tx.commit();
+    if (rc != kv::CommitResult::SUCCESS)
+      throw std::logic_error(
+        "Transaction commit failed: " + std::to_string(rc));
+  }
+
+  const size_t tx_count = s.iterations();
+  std::atomic<size_t> failures = 0;
+
+  s.start_timer();
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < THREAD_COUNT; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      for (size_t i = t; i < tx_count; i += THREAD_COUNT)
+      {
+        auto tx = kv_store.create_tx();
+        auto handle = tx.rw<MapType>(map_names[t]);
+        handle->put(gen_key(i), gen_value(i));
+        if (tx.commit() != kv::CommitResult::SUCCESS)
+        {
+          ++failures;
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  s.stop_timer();
+
+  if (failures != 0)
+    throw std::logic_error(
+      "Transaction commit failed: " + std::to_string(failures));
+}
+
+// Commits s.iterations() read-modify-write transactions from 4 concurrent
+// threads to a single shared map. OVERLAP_PERCENT of the keys touched by each
+// transaction are drawn from a small set shared by all threads, and the
+// rest from keys private to each thread.
+template <size_t OVERLAP_PERCENT>
+static void commit_contention(picobench::state& s)
+{
+  logger::config::level() = logger::INFO;
+
+  constexpr size_t thread_count = 4;
+  constexpr size_t keys_per_tx = 8;
+  constexpr size_t shared_key_count = 16;
+  constexpr size_t private_key_count = 1024;
+
+  auto consensus = std::make_shared<kv::test::StubConsensus>();
+  kv::Store kv_store(consensus);
+  auto secrets = create_ledger_secrets();
+  auto encryptor = std::make_shared<ccf::NodeEncryptor>(secrets);
+  kv_store.set_encryptor(encryptor);
+
+  const auto map_name = "map0";
+  {
+    auto tx = kv_store.create_tx();
+    tx.rw<MapType>(map_name)->put(gen_key(0), gen_value(0));
+    auto rc = tx.commit();
+    if (rc != kv::CommitResult::SUCCESS)
+      throw std::logic_error(
+        "Transaction commit failed: " + std::to_string(rc));
+  }
+
+  const size_t tx_count = s.iterations();
+  std::atomic<size_t> conflicts = 0;
+
+  s.start_timer();
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < thread_count; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      std::vector<KeyType> keys;
+      for (size_t i = t; i < tx_count; i += thread_count)
+      {
+        keys.clear();
+        for (size_t k = 0; k < keys_per_tx; ++k)
+        {
+          if ((i * keys_per_tx + k) % 100 < OVERLAP_PERCENT)
+          {
+            keys.push_back(gen_key((i + k) % shared_key_count, "shared"));
+          }
+          else
+          {
+            keys.push_back(
+              gen_key((i + k) % private_key_count, std::to_string(t)));
+          }
+        }
+
+        while (true)
+        {
+          auto tx = kv_store.create_tx();
+          auto handle = tx.rw<MapType>(map_name);
+          for (const auto& key : keys)
+          {
+            handle->get(key);
+            handle->put(key, gen_value(i));
+          }
+
+          if (tx.commit() == kv::CommitResult::SUCCESS)
+          {
+            break;
+          }
+          ++conflicts;
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  s.stop_timer();
+
+  s.set_result(conflicts.load());
+}
+
 template <size_t KEY_COUNT>
 static void ser_snap(picobench::state& s)
 {
@@ -247,6 +406,26 @@ PICOBENCH_SUITE("commit_latency");
 PICOBENCH(commit_latency<10>).iterations(tx_count).samples(10).baseline();
 PICOBENCH(commit_latency<100>).iterations(tx_count).samples(10);
 
+const std::vector<int> concurrent_tx_count = {1000, 10000};
+
+PICOBENCH_SUITE("commit_concurrent");
+PICOBENCH(commit_concurrent<1>)
+  .iterations(concurrent_tx_count)
+  .samples(10)
+  .baseline();
+PICOBENCH(commit_concurrent<2>).iterations(concurrent_tx_count).samples(10);
+PICOBENCH(commit_concurrent<4>).iterations(concurrent_tx_count).samples(10);
+PICOBENCH(commit_concurrent<8>).iterations(concurrent_tx_count).samples(10);
+
+PICOBENCH_SUITE("commit_contention");
+PICOBENCH(commit_contention<0>)
+  .iterations(concurrent_tx_count)
+  .samples(10)
+  .baseline();
+PICOBENCH(commit_contention<10>).iterations(concurrent_tx_count).samples(10);
+PICOBENCH(commit_contention<50>).iterations(concurrent_tx_count).samples(10);
+PICOBENCH(commit_contention<100>).iterations(concurrent_tx_count).samples(10);
+
 PICOBENCH_SUITE("serialise");
 PICOBENCH(serialise<SD::PUBLIC>)
   .iterations(tx_count)
@@ -1,11 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the Apache 2.0 License.
 
+#include "crypto/hash.h"
 #include "kv/kv_serialiser.h"
 #include "kv/store.h"
 #include "kv/test/null_encryptor.h"
 
+#include <atomic>
 #include <doctest/doctest.h>
+#include <thread>
 #undef FAIL
 
 struct MapTypes
@@ -200,6 +203,351 @@ TEST_CASE(
   }
 }
 
+TEST_CASE("Chunked snapshot" * doctest::test_suite("snapshot"))
+{
+  auto encryptor = std::make_shared<kv::NullTxEncryptor>();
+  kv::Store store;
+  store.set_encryptor(encryptor);
+  MapTypes::NumNum empty_map("public:empty_map");
+  MapTypes::StringString public_map("public:string_map");
+  MapTypes::StringString private_map("string_map");
+
+  constexpr size_t entry_count = 100;
+  const std::string value(100, 'x');
+
+  INFO("Apply transactions to original store");
+  {
+    auto tx = store.create_tx();
+    tx.rw(empty_map)->put(0, 0);
+    REQUIRE(tx.commit() == kv::CommitResult::SUCCESS);
+
+    auto tx2 = store.create_tx();
+    tx2.rw(empty_map)->remove(0);
+    auto public_handle = tx2.rw(public_map);
+    auto private_handle = tx2.rw(private_map);
+    for (size_t i = 0; i < entry_count; ++i)
+    {
+      public_handle->put(std::to_string(i), value);
+      private_handle->put(std::to_string(i), value);
+    }
+    REQUIRE(tx2.commit() == kv::CommitResult::SUCCESS);
+  }
+
+  const auto snapshot_version = store.current_version();
+  const size_t max_chunk_size = 1024;
+
+  std::vector<uint8_t> serialised_snapshot;
+  size_t chunk_count = 0;
+  store.serialise_snapshot(
+    *store.snapshot(snapshot_version),
+    max_chunk_size,
+    [&](std::vector<uint8_t>&& chunk) {
+      // Chunks also hold entry and map headers
+      REQUIRE_LT(chunk.size(), 2 * max_chunk_size);
+      serialised_snapshot.insert(
+        serialised_snapshot.end(), chunk.begin(), chunk.end());
+      chunk_count++;
+    });
+  REQUIRE_GT(chunk_count, 2);
+
+  INFO("Apply chunked snapshot to new store");
+  {
+    kv::Store new_store;
+    new_store.set_encryptor(encryptor);
+
+    kv::ConsensusHookPtrs hooks;
+    REQUIRE_EQ(
+      new_store.deserialise_snapshot(serialised_snapshot, hooks),
+      kv::ApplyResult::PASS);
+    REQUIRE_EQ(new_store.current_version(), snapshot_version);
+
+    auto tx = new_store.create_tx();
+    REQUIRE(!tx.ro(empty_map)->has(0));
+    auto public_handle = tx.ro(public_map);
+    auto private_handle = tx.ro(private_map);
+    REQUIRE_EQ(public_handle->size(), entry_count);
+    REQUIRE_EQ(private_handle->size(), entry_count);
+    for (size_t i = 0; i < entry_count; ++i)
+    {
+      REQUIRE_EQ(public_handle->get(std::to_string(i)).value(), value);
+      REQUIRE_EQ(private_handle->get(std::to_string(i)).value(), value);
+    }
+  }
+
+  INFO("Public-only deserialisation skips private chunks");
+  {
+    kv::Store new_store;
+    new_store.set_encryptor(encryptor);
+
+    kv::ConsensusHookPtrs hooks;
+    REQUIRE_EQ(
+      new_store.deserialise_snapshot(serialised_snapshot, hooks, nullptr, true),
+      kv::ApplyResult::PASS);
+
+    auto tx = new_store.create_tx();
+    REQUIRE_EQ(tx.ro(public_map)->size(), entry_count);
+    REQUIRE_EQ(tx.ro(private_map)->size(), 0);
+  }
+
+  INFO("Truncated snapshot is rejected");
+  {
+    kv::Store new_store;
+    new_store.set_encryptor(encryptor);
+
+    serialised_snapshot.resize(serialised_snapshot.size() - 1);
+    kv::ConsensusHookPtrs hooks;
+    REQUIRE_EQ(
+      new_store.deserialise_snapshot(serialised_snapshot, hooks),
+      kv::ApplyResult::FAIL);
+  }
+}
+
+TEST_CASE("Parallel snapshot" * doctest::test_suite("snapshot"))
+{
+  auto encryptor = std::make_shared<kv::NullTxEncryptor>();
+  kv::Store store;
+  store.set_encryptor(encryptor);
+
+  // Spread calls across as many threads as there are calls
+  std::atomic<size_t> calls = 0;
+  auto parallel_for = [&](size_t n, const std::function<void(size_t)>& f) {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < n; ++i)
+    {
+      threads.emplace_back([&f, i]() { f(i); });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+    calls += n;
+  };
+
+  constexpr size_t map_count = 20;
+  constexpr size_t entry_count = 50;
+  const std::string value(100, 'x');
+
+  INFO("Apply transactions to original store");
+  {
+    auto tx = store.create_tx();
+    for (size_t i = 0; i < map_count; ++i)
+    {
+      auto handle = tx.rw<MapTypes::StringString>(
+        fmt::format("{}map_{}", i % 2 == 0 ? "public:" : "", i));
+      for (size_t j = 0; j < entry_count; ++j)
+      {
+        handle->put(std::to_string(j), value);
+      }
+    }
+    REQUIRE(tx.commit() == kv::CommitResult::SUCCESS);
+  }
+
+  const auto snapshot_version = store.current_version();
+  const size_t max_chunk_size = 1024;
+
+  auto serialise = [&]() {
+    std::vector<uint8_t> serialised_snapshot;
+    store.serialise_snapshot(
+      *store.snapshot(snapshot_version),
+      max_chunk_size,
+      [&](std::vector<uint8_t>&& chunk) {
+        serialised_snapshot.insert(
+          serialised_snapshot.end(), chunk.begin(), chunk.end());
+      });
+    return serialised_snapshot;
+  };
+
+  const auto sequential_snapshot = serialise();
+  store.set_parallel_for(parallel_for);
+  const auto parallel_snapshot = serialise();
+  REQUIRE_EQ(calls.load(), map_count);
+
+  INFO("Snapshot does not depend on the number of threads");
+  REQUIRE_EQ(parallel_snapshot, sequential_snapshot);
+
+  INFO("Deserialise snapshot in parallel");
+  {
+    kv::Store new_store;
+    new_store.set_encryptor(encryptor);
+    new_store.set_parallel_for(parallel_for);
+
+    kv::ConsensusHookPtrs hooks;
+    REQUIRE_EQ(
+      new_store.deserialise_snapshot(parallel_snapshot, hooks),
+      kv::ApplyResult::PASS);
+    REQUIRE_EQ(new_store.current_version(), snapshot_version);
+
+    auto tx = new_store.create_tx();
+    for (size_t i = 0; i < map_count; ++i)
+    {
+      auto handle = tx.ro<MapTypes::StringString>(
+        fmt::format("{}map_{}", i % 2 == 0 ? "public:" : "", i));
+      REQUIRE_EQ(handle->size(), entry_count);
+      for (size_t j = 0; j < entry_count; ++j)
+      {
+        REQUIRE_EQ(handle->get(std::to_string(j)).value(), value);
+      }
+    }
+  }
+}
+
+TEST_CASE("Delta snapshot" * doctest::test_suite("snapshot"))
+{
+  auto encryptor = std::make_shared<kv::NullTxEncryptor>();
+  kv::Store store;
+  store.set_encryptor(encryptor);
+  MapTypes::StringString unchanged_map("public:unchanged_map");
+  MapTypes::StringString public_map("public:string_map");
+  MapTypes::StringString private_map("string_map");
+  MapTypes::NumNum new_map("public:new_map");
+
+  constexpr size_t entry_count = 100;
+  const std::string value(100, 'x');
+  const std::string new_value(100, 'y');
+  const size_t max_chunk_size = 1024;
+
+  auto serialise = [&](kv::AbstractStore::AbstractSnapshot& snapshot) {
+    std::vector<uint8_t> serialised_snapshot;
+    store.serialise_snapshot(
+      snapshot, max_chunk_size, [&](std::vector<uint8_t>&& chunk) {
+        serialised_snapshot.insert(
+          serialised_snapshot.end(), chunk.begin(), chunk.end());
+      });
+    return serialised_snapshot;
+  };
+
+  auto concat = [](std::vector<std::vector<uint8_t>> snapshots) {
+    std::vector<uint8_t> chain;
+    for (const auto& snapshot : snapshots)
+    {
+      chain.insert(chain.end(), snapshot.begin(), snapshot.end());
+    }
+    return chain;
+  };
+
+  INFO("Apply transactions to original store");
+  {
+    auto tx = store.create_tx();
+    auto unchanged_handle = tx.rw(unchanged_map);
+    auto public_handle = tx.rw(public_map);
+    auto private_handle = tx.rw(private_map);
+    for (size_t i = 0; i < entry_count; ++i)
+    {
+      unchanged_handle->put(std::to_string(i), value);
+      public_handle->put(std::to_string(i), value);
+      private_handle->put(std::to_string(i), value);
+    }
+    REQUIRE(tx.commit() == kv::CommitResult::SUCCESS);
+  }
+
+  const auto full_version = store.current_version();
+  std::shared_ptr<kv::AbstractStore::AbstractSnapshot> full_snapshot =
+    store.snapshot(full_version);
+  const auto full_serialised = serialise(*full_snapshot);
+  const auto full_hash = crypto::Sha256Hash(full_serialised);
+  const std::vector<uint8_t> full_hash_bytes(
+    full_hash.h.begin(), full_hash.h.end());
+
+  INFO("Update, remove and add entries");
+  {
+    auto tx = store.create_tx();
+    tx.rw(public_map)->put("0", new_value);
+    tx.rw(public_map)->remove("1");
+    tx.rw(private_map)->put(std::to_string(entry_count), new_value);
+    tx.rw(new_map)->put(42, 43);
+    REQUIRE(tx.commit() == kv::CommitResult::SUCCESS);
+  }
+
+  const auto delta_version = store.current_version();
+  auto delta =
+    store.snapshot(delta_version)->diff(*full_snapshot, full_hash_bytes);
+  REQUIRE_EQ(delta->get_version(), delta_version);
+  const auto delta_serialised = serialise(*delta);
+
+  INFO("Delta only holds changed maps and entries");
+  REQUIRE_LT(delta_serialised.size(), full_serialised.size() / 4);
+
+  INFO("Apply full snapshot followed by delta to new store");
+  {
+    kv::Store new_store;
+    new_store.set_encryptor(encryptor);
+
+    kv::ConsensusHookPtrs hooks;
+    REQUIRE_EQ(
+      new_store.deserialise_snapshot(
+        concat({full_serialised, delta_serialised}), hooks),
+      kv::ApplyResult::PASS);
+    REQUIRE_EQ(new_store.current_version(), delta_version);
+
+    auto tx = new_store.create_tx();
+    auto unchanged_handle = tx.ro(unchanged_map);
+    auto public_handle = tx.ro(public_map);
+    auto private_handle = tx.ro(private_map);
+    REQUIRE_EQ(unchanged_handle->size(), entry_count);
+    REQUIRE_EQ(public_handle->size(), entry_count - 1);
+    REQUIRE_EQ(private_handle->size(), entry_count + 1);
+    REQUIRE_EQ(public_handle->get("0").value(), new_value);
+    REQUIRE(!public_handle->has("1"));
+    REQUIRE_EQ(public_handle->get("2").value(), value);
+    REQUIRE_EQ(
+      private_handle->get(std::to_string(entry_count)).value(), new_value);
+    REQUIRE_EQ(tx.ro(new_map)->get(42).value(), 43);
+  }
+
+  INFO("Delta cannot be applied without its base");
+  {
+    kv::Store new_store;
+    new_store.set_encryptor(encryptor);
+
+    kv::ConsensusHookPtrs hooks;
+    REQUIRE_EQ(
+      new_store.deserialise_snapshot(delta_serialised, hooks),
+      kv::ApplyResult::FAIL);
+  }
+
+  INFO("Delta cannot be applied to a different base");
+  {
+    auto other_base = full_serialised;
+    other_base.back() ^= 1;
+
+    kv::Store new_store;
+    new_store.set_encryptor(encryptor);
+
+    kv::ConsensusHookPtrs hooks;
+    REQUIRE_EQ(
+      new_store.deserialise_snapshot(
+        concat({other_base, delta_serialised}), hooks),
+      kv::ApplyResult::FAIL);
+  }
+
+  INFO("Chain of deltas");
+  {
+    auto tx = store.create_tx();
+    tx.rw(public_map)->remove("0");
+    REQUIRE(tx.commit() == kv::CommitResult::SUCCESS);
+
+    const auto delta_hash = crypto::Sha256Hash(delta_serialised);
+    auto second_delta = store.snapshot(store.current_version())
+                          ->diff(
+                            *store.snapshot(delta_version),
+                            {delta_hash.h.begin(), delta_hash.h.end()});
+
+    kv::Store new_store;
+    new_store.set_encryptor(encryptor);
+
+    kv::ConsensusHookPtrs hooks;
+    REQUIRE_EQ(
+      new_store.deserialise_snapshot(
+        concat({full_serialised, delta_serialised, serialise(*second_delta)}),
+        hooks),
+      kv::ApplyResult::PASS);
+
+    auto new_tx = new_store.create_tx();
+    REQUIRE(!new_tx.ro(public_map)->has("0"));
+    REQUIRE_EQ(new_tx.ro(public_map)->size(), entry_count - 2);
+  }
+}
+
 TEST_CASE("Commit hooks with snapshot" * doctest::test_suite("snapshot"))
 {
   kv::Store store;
@@ -17,6 +17,7 @@
 #undef FAIL
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 struct MapTypes
@@ -749,6 +750,67 @@ TEST_CASE("get_version_of_previous_write")
   }
 }
 
+TEST_CASE("get_state_version")
+{
+  kv::Store kv_store;
+  MapTypes::StringString map("public:map");
+  MapTypes::StringString other_map("public:other_map");
+
+  auto get_state_version = [&]() {
+    auto tx = kv_store.create_tx();
+    return tx.ro(map)->get_state_version();
+  };
+
+  auto write = [&](MapTypes::StringString& m, const std::string& k) {
+    auto tx = kv_store.create_tx();
+    tx.rw(m)->put(k, "v");
+    REQUIRE(tx.commit() == kv::CommitResult::SUCCESS);
+  };
+
+  const auto initial_version = get_state_version();
+  REQUIRE(initial_version.version == kv::NoVersion);
+
+  write(map, "k1");
+  const auto first_version = get_state_version();
+  REQUIRE(first_version != initial_version);
+  REQUIRE(first_version.version == kv_store.current_version());
+
+  {
+    INFO("Writes to other maps do not change the version of this map");
+    write(other_map, "k1");
+    REQUIRE(get_state_version() == first_version);
+  }
+
+  {
+    INFO("Getting the version introduces a read dependency on the whole map");
+    auto tx = kv_store.create_tx();
+    REQUIRE(tx.ro(map)->get_state_version() == first_version);
+    tx.rw(other_map)->put("k2", "v");
+
+    write(map, "k2");
+
+    REQUIRE(tx.commit() == kv::CommitResult::FAIL_CONFLICT);
+  }
+
+  {
+    INFO("States which have been rolled back are distinguished");
+    const auto before_version = get_state_version();
+
+    write(map, "k3");
+    const auto rolled_back_version = get_state_version();
+
+    kv_store.rollback(
+      {kv_store.commit_view(), before_version.version},
+      kv_store.commit_view());
+    REQUIRE(get_state_version().version == before_version.version);
+    REQUIRE(get_state_version() != before_version);
+
+    write(map, "k4");
+    REQUIRE(get_state_version().version == rolled_back_version.version);
+    REQUIRE(get_state_version() != rolled_back_version);
+  }
+}
+
 TEST_CASE("size")
 {
   kv::Store kv_store;
@@ -2032,6 +2094,114 @@ TEST_CASE("Conflict resolution")
   REQUIRE_THROWS(tx2.commit());
 }
 
+TEST_CASE("Disjoint-key transactions on the same map")
+{
+  kv::Store kv_store;
+  MapTypes::StringString map("public:map");
+
+  {
+    auto tx = kv_store.create_tx();
+    auto handle = tx.rw(map);
+    handle->put("a", "initial");
+    handle->put("b", "initial");
+    handle->put("c", "initial");
+    REQUIRE(tx.commit() == kv::CommitResult::SUCCESS);
+  }
+
+  auto read_write = [&](kv::Tx& tx, const std::string& k) {
+    auto handle = tx.rw(map);
+    handle->get(k);
+    handle->put(k, "updated");
+  };
+
+  // All transactions start from the same state
+  auto tx_a = kv_store.create_tx();
+  auto tx_b = kv_store.create_tx();
+  auto tx_c = kv_store.create_tx();
+  auto tx_a2 = kv_store.create_tx();
+  auto tx_iter = kv_store.create_tx();
+
+  read_write(tx_a, "a");
+  read_write(tx_b, "b");
+  read_write(tx_c, "c");
+  read_write(tx_a2, "a");
+
+  {
+    auto handle = tx_iter.rw(map);
+    handle->foreach([](const auto&, const auto&) { return true; });
+    handle->put("d", "new");
+  }
+
+  INFO("Transactions on disjoint keys do not conflict");
+  {
+    REQUIRE(tx_a.commit() == kv::CommitResult::SUCCESS);
+    REQUIRE(tx_b.commit() == kv::CommitResult::SUCCESS);
+    REQUIRE(tx_c.commit() == kv::CommitResult::SUCCESS);
+  }
+
+  INFO("Transactions on overlapping keys conflict");
+  {
+    REQUIRE(tx_a2.commit() == kv::CommitResult::FAIL_CONFLICT);
+  }
+
+  INFO("Transactions which iterated over the map conflict with any write");
+  {
+    REQUIRE(tx_iter.commit() == kv::CommitResult::FAIL_CONFLICT);
+  }
+
+  INFO("Disjoint transactions do not conflict across compaction");
+  {
+    auto tx1 = kv_store.create_tx();
+    auto tx2 = kv_store.create_tx();
+    read_write(tx1, "a");
+    read_write(tx2, "b");
+    REQUIRE(tx1.commit() == kv::CommitResult::SUCCESS);
+    kv_store.compact(kv_store.current_version());
+    REQUIRE(tx2.commit() == kv::CommitResult::SUCCESS);
+  }
+}
+
+TEST_CASE("Concurrent transactions on disjoint keys of the same map")
+{
+  kv::Store kv_store;
+  MapTypes::NumNum map("public:map");
+
+  constexpr size_t thread_count = 4;
+  constexpr size_t tx_count = 1000;
+  std::atomic<size_t> failures = 0;
+
+  // Each thread increments its own key. Read sets are validated against
+  // commits from other threads, which never conflict.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < thread_count; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      for (size_t i = 0; i < tx_count; ++i)
+      {
+        auto tx = kv_store.create_tx();
+        auto handle = tx.rw(map);
+        handle->put(t, handle->get(t).value_or(0) + 1);
+        if (tx.commit() != kv::CommitResult::SUCCESS)
+        {
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  REQUIRE(failures == 0);
+  auto tx = kv_store.create_tx();
+  auto handle = tx.ro(map);
+  for (size_t t = 0; t < thread_count; ++t)
+  {
+    REQUIRE(handle->get(t) == tx_count);
+  }
+}
+
 std::string rand_string(size_t i)
 {
   return fmt::format("{}: {}", i, rand());
@@ -10,6 +10,7 @@
 
 #include <functional>
 #include <list>
+#include <memory>
 #include <optional>
 #include <unordered_set>
 
@@ -81,6 +82,33 @@ namespace kv::untyped
     MapHook hook = nullptr;
     std::list<std::pair<Version, Write>> commit_deltas;
     std::mutex sl;
+
+    // The state at the tail of the roll, republished under sl whenever the
+    // roll changes, so that committing transactions can validate their read
+    // set against a recent state before taking sl. Only accessed through
+    // std::atomic_load and std::atomic_store.
+    struct Tail
+    {
+      Version version;
+      size_t rollback_counter;
+      State state;
+    };
+    std::shared_ptr<const Tail> tail = nullptr;
+
+    void publish_tail()
+    {
+      // The Map expects to be locked when publishing its tail
+      auto c = roll.commits->get_tail();
+      std::atomic_store(
+        &tail,
+        std::shared_ptr<const Tail>(std::make_shared<Tail>(
+          Tail{c->version, roll.rollback_counter, c->state})));
+    }
+
+    std::shared_ptr<const Tail> load_tail() const
+    {
+      return std::atomic_load(&tail);
+    }
     const SecurityDomain security_domain;
     const bool replicated;
     const bool include_conflict_read_version;
@@ -98,6 +126,10 @@ namespace kv::untyped
       bool changes = false;
       bool committed_writes = false;
 
+      // Version of a state of the map against which the read set was found
+      // to be valid by prevalidate(), without holding the map's lock
+      Version validated_version = NoVersion;
+
     public:
       HandleCommitter(Map& m, ChangeSet& change_set_) :
         map(m),
@@ -110,6 +142,42 @@ namespace kv::untyped
         return committed_writes || change_set.has_writes();
       }
 
+      void prevalidate(bool track_read_versions) override
+      {
+        // Only worth doing if prepare() may otherwise look up each read while
+        // holding the map's lock
+        if (
+          track_read_versions || change_set.writes.empty() ||
+          change_set.reads.empty() || change_set.read_version != NoVersion)
+        {
+          return;
+        }
+
+        auto t = map.load_tail();
+        if (
+          t == nullptr || t->rollback_counter != change_set.rollback_counter ||
+          t->version == change_set.start_version)
+        {
+          return;
+        }
+
+        for (const auto& [k, read] : change_set.reads)
+        {
+          auto search = t->state.get(k);
+          const auto read_version = std::get<0>(read);
+          if (
+            read_version == NoVersion ?
+              search.has_value() :
+              (!search.has_value() || search->version != read_version))
+          {
+            // prepare() will find the same conflict
+            return;
+          }
+        }
+
+        validated_version = t->version;
+      }
+
       bool prepare(
         bool track_read_versions, kv::Version& max_conflict_version) override
       {
@@ -159,6 +227,21 @@ namespace kv::untyped
           return false;
         }
 
+        // Unless read versions are being tracked, it may be possible to
+        // validate the read set from the versions of the commits which
+        // happened since the transaction started, or since the state it was
+        // prevalidated against, without looking up each read key in the
+        // current state
+        if (
+          !track_read_versions &&
+          validate_from_commits(
+            current,
+            validated_version != NoVersion ? validated_version :
+                                             change_set.start_version))
+        {
+          return true;
+        }
+
         // Check each key in our read set.
         for (auto it = change_set.reads.begin(); it != change_set.reads.end();
              ++it)
@@ -235,6 +318,55 @@ namespace kv::untyped
         return true;
       }
 
+      // Returns true if none of the commits applied to the map since version
+      // since, at which the read set of change_set is known to be valid,
+      // wrote to a key in its read set. Returns false if this cannot be
+      // cheaply established, in which case every read must be checked
+      // against the current state.
+      bool validate_from_commits(LocalCommit* current, Version since)
+      {
+        // Fast path: the map has not been written to since, so every read is
+        // still valid
+        if (current->version == since)
+        {
+          return true;
+        }
+
+        // Otherwise, walk back the commits made since, for as long as this
+        // requires fewer lookups than validating each read. This is only
+        // possible if the transaction did not iterate over the map.
+        if (change_set.read_version != NoVersion)
+        {
+          return false;
+        }
+
+        size_t budget = change_set.reads.size();
+        while (current != nullptr && current->version > since)
+        {
+          // The write set of a commit may have been handed over to the global
+          // hook on compaction, so it cannot be relied upon
+          if (current->writes.empty() || current->writes.size() > budget)
+          {
+            return false;
+          }
+          budget -= current->writes.size();
+
+          for (const auto& [k, _] : current->writes)
+          {
+            if (change_set.reads.find(k) != change_set.reads.end())
+            {
+              return false;
+            }
+          }
+
+          current = current->prev;
+        }
+
+        // The walk must end on the state the read set is valid in, and not on
+        // an earlier one if it has since been compacted
+        return current != nullptr && current->version == since;
+      }
+
       void commit(Version v_, bool track_read_versions) override
       {
         if (change_set.writes.empty() && !track_read_versions)
@@ -302,6 +434,7 @@ namespace kv::untyped
         {
           map.roll.commits->insert_back(map.roll.create_new_local_commit(
             v, std::move(state), change_set.writes));
+          map.publish_tail();
         }
       }
 
@@ -343,14 +476,58 @@ namespace kv::untyped
         map_snapshot(std::move(map_snapshot_))
       {}
 
-      void serialise(KvStoreSerialiser& s) override
+      size_t get_serialised_size() override
+      {
+        return map_snapshot.get_serialized_size();
+      }
+
+      std::vector<std::vector<uint8_t>> serialise_segments(
+        size_t max_segment_size) override
+      {
+        std::vector<std::vector<uint8_t>> segments;
+        map_snapshot.serialize_segments(
+          max_segment_size, [&segments](std::vector<uint8_t>&& segment) {
+            segments.push_back(std::move(segment));
+          });
+        return segments;
+      }
+
+      void write_segment(
+        KvStoreSerialiser& s, const std::vector<uint8_t>& segment) override
       {
         s.start_map(name, security_domain);
         s.serialise_entry_version(version);
+        s.serialise_raw(segment);
+      }
+
+      std::unique_ptr<AbstractMap::Snapshot> diff(
+        const AbstractMap::Snapshot* base) override
+      {
+        auto base_snapshot = dynamic_cast<const Snapshot*>(base);
+        if (base_snapshot == nullptr)
+        {
+          return std::make_unique<Snapshot>(
+            name, security_domain, version, StateSnapshot(map_snapshot));
+        }
+
+        if (base_snapshot->version == version)
+        {
+          return nullptr;
+        }
+
+        // Keys are never removed from the state of a map, since removals are
+        // recorded as deleted versions, so the entries changed since base are
+        // enough to rebuild the state of the map from that of base
+        return std::make_unique<Snapshot>(
+          name,
+          security_domain,
+          version,
+          map_snapshot.diff(base_snapshot->map_snapshot));
+      }
 
-        std::vector<uint8_t> ret(map_snapshot.get_serialized_size());
-        map_snapshot.serialize(ret.data());
-        s.serialise_raw(ret);
+      const std::string& get_name() const override
+      {
+        return name;
       }
 
       SecurityDomain get_security_domain() override
@@ -509,6 +686,8 @@ namespace kv::untyped
             return true;
           });
         }
+
+        map.publish_tail();
       }
 
       ConsensusHookPtr post_commit() override
@@ -518,14 +697,58 @@ namespace kv::untyped
       }
     };
 
-    ChangeSetPtr deserialise_snapshot_changes(KvStoreDeserialiser& d)
+    struct SnapshotSegment
+    {
+      Version version;
+      std::vector<uint8_t> data;
+    };
+
+    SnapshotSegment deserialise_snapshot_segment(KvStoreDeserialiser& d)
     {
-      // Create a new empty change set, deserialising d's contents into it.
       auto v = d.deserialise_entry_version();
-      auto map_snapshot = d.deserialise_raw();
+      return {v, d.deserialise_raw()};
+    }
 
-      return std::make_unique<SnapshotChangeSet>(
-        State::deserialize_map(map_snapshot), v);
+    ChangeSetPtr deserialise_snapshot_changes(
+      const std::vector<SnapshotSegment>& segments,
+      const ChangeSetPtr& previous = nullptr)
+    {
+      // Create a new change set from the given segments of the map's
+      // snapshot, which are all at the same version. If the map was
+      // snapshotted in more segments, previous holds the change set
+      // deserialised from the earlier segments, which is extended. The
+      // segments of a delta snapshot are at a later version than previous,
+      // and their entries replace those of previous. Does not access the
+      // state of the map, so that snapshots of different maps can be
+      // deserialised in parallel.
+      if (segments.empty())
+      {
+        return nullptr;
+      }
+      const auto v = segments.front().version;
+
+      State state;
+      if (previous != nullptr)
+      {
+        auto previous_snapshot =
+          dynamic_cast<SnapshotChangeSet*>(previous.get());
+        if (previous_snapshot == nullptr || previous_snapshot->version > v)
+        {
+          return nullptr;
+        }
+        state = previous_snapshot->state;
+      }
+
+      for (const auto& segment : segments)
+      {
+        if (segment.version != v)
+        {
+          return nullptr;
+        }
+        state = State::deserialize_map(segment.data, std::move(state));
+      }
+
+      return std::make_unique<SnapshotChangeSet>(std::move(state), v);
     }
 
     ChangeSetPtr deserialise_changes(KvStoreDeserialiser& d, Version version)
@@ -810,7 +1033,10 @@ namespace kv::untyped
       }
 
       if (advance)
+      {
         roll.rollback_counter++;
+        publish_tail();
+      }
     }
 
     void clear() override
@@ -819,6 +1045,7 @@ namespace kv::untyped
       // The Map expects to be locked before clearing it.
       roll.reset_commits();
       roll.rollback_counter = 0;
+      publish_tail();
     }
 
     void lock() override
@@ -839,6 +1066,8 @@ namespace kv::untyped
           "Attempted to swap maps with incompatible types");
 
       std::swap(roll, map->roll);
+      publish_tail();
+      map->publish_tail();
     }
 
     ChangeSetPtr create_change_set(Version version)
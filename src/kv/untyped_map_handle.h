@@ -129,6 +129,15 @@ namespace kv::untyped
       return search->version;
     }
 
+    MapStateVersion get_state_version()
+    {
+      // Record a global read dependency, as the returned version depends on
+      // every entry in the map
+      tx_changes.read_version = tx_changes.start_version;
+
+      return {tx_changes.rollback_counter, tx_changes.start_version};
+    }
+
     std::optional<ValueType> get_globally_committed(const KeyType& key)
     {
       // If there is no committed value, return empty.
@@ -5,6 +5,8 @@
 #include "ccf/historical_queries_interface.h"
 #include "consensus/ledger_enclave_types.h"
 #include "ds/ccf_assert.h"
+#include "ds/serialized.h"
+#include "kv/serialised_entry_format.h"
 #include "kv/store.h"
 #include "node/encryptor.h"
 #include "node/history.h"
@@ -373,6 +375,71 @@ namespace ccf::historical
       }
     }
 
+    void fetch_entries_range(ccf::SeqNo from, ccf::SeqNo to)
+    {
+      // Request each contiguous run of seqnos which are not already being
+      // fetched with a single ledger_get_range, rather than one ledger_get per
+      // entry
+      std::optional<ccf::SeqNo> run_start = std::nullopt;
+      for (auto seqno = from; seqno <= to; ++seqno)
+      {
+        const auto ib = pending_fetches.insert(seqno);
+        if (ib.second)
+        {
+          if (!run_start.has_value())
+          {
+            run_start = seqno;
+          }
+        }
+        else if (run_start.has_value())
+        {
+          request_range(run_start.value(), seqno - 1);
+          run_start = std::nullopt;
+        }
+      }
+
+      if (run_start.has_value())
+      {
+        request_range(run_start.value(), to);
+      }
+    }
+
+    void fetch_entries(const std::set<ccf::SeqNo>& seqnos)
+    {
+      auto it = seqnos.begin();
+      while (it != seqnos.end())
+      {
+        const auto from = *it;
+        auto to = from;
+        while (++it != seqnos.end() && *it == to + 1)
+        {
+          ++to;
+        }
+        fetch_entries_range(from, to);
+      }
+    }
+
+    void request_range(ccf::SeqNo from, ccf::SeqNo to)
+    {
+      if (from == to)
+      {
+        RINGBUFFER_WRITE_MESSAGE(
+          consensus::ledger_get,
+          to_host,
+          static_cast<consensus::Index>(from),
+          consensus::LedgerRequestPurpose::HistoricalQuery);
+      }
+      else
+      {
+        RINGBUFFER_WRITE_MESSAGE(
+          consensus::ledger_get_range,
+          to_host,
+          static_cast<consensus::Index>(from),
+          static_cast<consensus::Index>(to),
+          consensus::LedgerRequestPurpose::HistoricalQuery);
+      }
+    }
+
     std::optional<ccf::NodeInfo> get_node_info(const ccf::NodeId& node_id)
     {
       // Current solution: Use current state of Nodes table from real store.
@@ -503,12 +570,8 @@ namespace ccf::historical
           {
             // Newly have all required secrets - begin fetching the actual
             // entries
-            for (auto seqno = request.first_requested_seqno;
-                 seqno <= request.last_requested_seqno;
-                 ++seqno)
-            {
-              fetch_entry_at(seqno);
-            }
+            fetch_entries_range(
+              request.first_requested_seqno, request.last_requested_seqno);
           }
 
           // In either case, done with this request, try the next
@@ -651,10 +714,7 @@ namespace ccf::historical
         // If we have sufficiently early secrets, begin fetching any newly
         // requested entries. If we don't fall into this branch, they'll only
         // begin to be fetched once the secret arrives.
-        for (const auto new_seqno : new_indices)
-        {
-          fetch_entry_at(new_seqno);
-        }
+        fetch_entries(new_indices);
       }
 
       // Reset the expiry timer as this has just been requested
@@ -885,6 +945,50 @@ namespace ccf::historical
       return true;
     }
 
+    bool handle_ledger_entries(
+      ccf::SeqNo from, ccf::SeqNo to, const LedgerEntry& framed_entries)
+    {
+      // Split consecutive framed entries and handle each individually
+      const uint8_t* data = framed_entries.data();
+      size_t size = framed_entries.size();
+      bool all_accepted = true;
+      for (auto seqno = from; seqno <= to; ++seqno)
+      {
+        if (size < kv::serialised_entry_header_size)
+        {
+          LOG_FAIL_FMT(
+            "Range of entries {} to {} is truncated at {}", from, to, seqno);
+          handle_no_entry_range(seqno, to);
+          return false;
+        }
+
+        const auto header =
+          serialized::peek<kv::SerialisedEntryHeader>(data, size);
+        const auto entry_size = kv::serialised_entry_header_size + header.size;
+        if (size < entry_size)
+        {
+          LOG_FAIL_FMT(
+            "Range of entries {} to {} is truncated at {}", from, to, seqno);
+          handle_no_entry_range(seqno, to);
+          return false;
+        }
+
+        LedgerEntry entry(data, data + entry_size);
+        serialized::skip(data, size, entry_size);
+        all_accepted &= handle_ledger_entry(seqno, entry);
+      }
+
+      return all_accepted;
+    }
+
+    void handle_no_entry_range(ccf::SeqNo from, ccf::SeqNo to)
+    {
+      for (auto seqno = from; seqno <= to; ++seqno)
+      {
+        handle_no_entry(seqno);
+      }
+    }
+
     void handle_no_entry(ccf::SeqNo seqno)
     {
       std::lock_guard<std::mutex> guard(requests_lock);
@@ -135,6 +135,11 @@ namespace ccf
       version++;
     }
 
+    void append_entry(const crypto::Sha256Hash&) override
+    {
+      version++;
+    }
+
     kv::TxHistory::Result verify_and_sign(
       PrimarySignature&, kv::Term*, kv::Configuration::Nodes&) override
     {
@@ -400,7 +405,7 @@ namespace ccf
       tree = new HistoryTree(serialised);
     }
 
-    void append(crypto::Sha256Hash& hash)
+    void append(const crypto::Sha256Hash& hash)
     {
       tree->insert(merkle::Hash(hash.h));
     }
@@ -869,11 +874,15 @@ namespace ccf
     }
 
     void append(const std::vector<uint8_t>& data) override
+    {
+      append_entry(crypto::Sha256Hash({data.data(), data.size()}));
+    }
+
+    void append_entry(const crypto::Sha256Hash& digest) override
     {
       std::lock_guard<std::mutex> guard(state_lock);
-      crypto::Sha256Hash rh({data.data(), data.size()});
-      log_hash(rh, APPEND);
-      replicated_state_tree.append(rh);
+      log_hash(digest, APPEND);
+      replicated_state_tree.append(digest);
     }
   };
 
@@ -17,6 +17,7 @@
 #include "genesis_gen.h"
 #include "history.h"
 #include "hooks.h"
+#include "http/authentication/jwt_auth.h"
 #include "js/wrap.h"
 #include "network_state.h"
 #include "node/jwt_key_auto_refresh.h"
@@ -137,6 +138,12 @@ namespace ccf
     RecoveredEncryptedLedgerSecrets recovery_ledger_secrets;
     consensus::Index ledger_idx = 0;
 
+    // The ledger is read from the host in ranges of this many entries, the
+    // next range being requested once all entries of the previous one have
+    // been read
+    static constexpr consensus::Index ledger_read_range_size = 1000;
+    consensus::Index ledger_read_range_end = 0;
+
     //
     // JWT key auto-refresh
     //
@@ -185,6 +192,10 @@ namespace ccf
     // the lifetime of the node
     std::optional<kv::Version> startup_seqno = std::nullopt;
 
+    // Ledger entries up to this index have been synced to stable storage by
+    // the host
+    std::atomic<consensus::Index> ledger_durable_idx = 0;
+
     std::shared_ptr<kv::AbstractTxEncryptor> make_encryptor()
     {
 #ifdef USE_NULL_ENCRYPTOR
@@ -194,6 +205,15 @@ namespace ccf
 #endif
     }
 
+    // Maps of snapshots are serialised and deserialised across the worker
+    // threads
+    static kv::ParallelFor make_parallel_for()
+    {
+      return [](size_t n, const std::function<void(size_t)>& f) {
+        threading::ThreadMessaging::thread_messaging.parallel_for(n, f);
+      };
+    }
+
     void initialise_startup_snapshot(bool recovery = false)
     {
       std::shared_ptr<kv::Store> snapshot_store;
@@ -213,6 +233,7 @@ namespace ccf
 
         snapshot_store->set_history(snapshot_history);
         snapshot_store->set_encryptor(snapshot_encryptor);
+        snapshot_store->set_parallel_for(make_parallel_for());
       }
       else
       {
@@ -311,6 +332,8 @@ namespace ccf
       cmd_forwarder = std::make_shared<ccf::Forwarder<ccf::NodeToNode>>(
         rpc_sessions_, n2n_channels, rpc_map, consensus_config.consensus_type);
 
+      network.tables->set_parallel_for(make_parallel_for());
+
       sm.advance(State::initialized);
 
       for (auto& [actor, fe] : rpc_map->frontends())
@@ -875,7 +898,14 @@ namespace ccf
             throw std::logic_error("Invalid snapshot evidence");
           }
 
-          if (evidence->hash == crypto::Sha256Hash(startup_snapshot_info->raw))
+          // The evidence is that of the last snapshot of the chain. Each
+          // delta of the chain records the hash of the snapshot it is
+          // against, which was checked when the chain was deserialised.
+          auto chain = kv::split_snapshot_chain(
+            startup_snapshot_info->raw, store->get_encryptor());
+          if (
+            chain.has_value() && !chain->empty() &&
+            evidence->hash == crypto::Sha256Hash(chain->back()))
           {
             LOG_DEBUG_FMT(
               "Snapshot evidence for snapshot found at {}",
@@ -1210,6 +1240,14 @@ namespace ccf
           }));
     }
 
+    // Entries of a range may still be received after the node has stopped
+    // reading the ledger at an earlier entry, and are then ignored
+    bool is_reading_ledger_idx(consensus::Index idx)
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      return idx == ledger_idx;
+    }
+
     //
     // funcs in state "readingPublicLedger" or "readingPrivateLedger"
     //
@@ -1253,6 +1291,7 @@ namespace ccf
 
       recovery_store->set_history(recovery_history);
       recovery_store->set_encryptor(recovery_encryptor);
+      recovery_store->set_parallel_for(make_parallel_for());
 
       // Record real store version and root
       recovery_v = network.tables->current_version();
@@ -1385,6 +1424,7 @@ namespace ccf
 
       // Start reading private security domain of ledger
       ledger_idx = recovery_store->current_version();
+      ledger_read_range_end = 0;
       read_ledger_idx(++ledger_idx);
 
       sm.advance(State::readingPrivateLedger);
@@ -1571,6 +1611,16 @@ namespace ccf
       return sm;
     }
 
+    void set_ledger_durable_idx(consensus::Index idx)
+    {
+      ledger_durable_idx = idx;
+    }
+
+    kv::Version get_ledger_durable_idx() const override
+    {
+      return static_cast<kv::Version>(ledger_durable_idx.load());
+    }
+
   private:
     crypto::SubjectAltName get_subject_alt_name()
     {
@@ -1781,6 +1831,7 @@ namespace ccf
 
       // Start reading private security domain of ledger
       ledger_idx = recovery_store->current_version();
+      ledger_read_range_end = 0;
       read_ledger_idx(++ledger_idx);
 
       sm.advance(State::readingPrivateLedger);
@@ -1864,6 +1915,22 @@ namespace ccf
 
             return kv::ConsensusHookPtr(nullptr);
           }));
+
+      // Drop cached verifiers and validated tokens of updated JWT keys. Cached
+      // entries are checked against the key read by each request, so this only
+      // releases entries which are no longer usable.
+      network.tables->set_map_hook(
+        network.jwt_public_signing_keys.get_name(),
+        network.jwt_public_signing_keys.wrap_map_hook(
+          [](kv::Version, const JwtPublicSigningKeys::Write& w)
+            -> kv::ConsensusHookPtr {
+            auto& cache = get_jwt_verifier_cache();
+            for (const auto& [key_id, key] : w)
+            {
+              cache.evict(key_id);
+            }
+            return kv::ConsensusHookPtr(nullptr);
+          }));
     }
 
     kv::Version get_last_recovered_signed_idx() override
@@ -2045,7 +2112,10 @@ namespace ccf
     void setup_snapshotter()
     {
       snapshotter = std::make_shared<Snapshotter>(
-        writer_factory, network.tables, config.snapshot_tx_interval);
+        writer_factory,
+        network.tables,
+        config.snapshot_tx_interval,
+        config.snapshot_max_deltas);
     }
 
     void setup_tracker_store()
@@ -2059,10 +2129,18 @@ namespace ccf
 
     void read_ledger_idx(consensus::Index idx)
     {
+      if (idx <= ledger_read_range_end)
+      {
+        // Already requested, as part of the current range
+        return;
+      }
+
+      ledger_read_range_end = idx + ledger_read_range_size - 1;
       RINGBUFFER_WRITE_MESSAGE(
-        consensus::ledger_get,
+        consensus::ledger_get_range,
         to_host,
         idx,
+        ledger_read_range_end,
         consensus::LedgerRequestPurpose::Recovery);
     }
 
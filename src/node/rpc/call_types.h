@@ -93,6 +93,40 @@ namespace ccf
 
   struct EndpointMetrics
   {
+    struct Bucket
+    {
+      size_t low = 0;
+      size_t high = 0;
+      size_t count = 0;
+    };
+
+    struct Histogram
+    {
+      // Number of values below the lowest and above the highest bucket
+      size_t underflow = 0;
+      size_t overflow = 0;
+      // Non-empty buckets, with their inclusive range of values
+      std::vector<Bucket> buckets;
+
+      template <typename H>
+      static Histogram from(H& h)
+      {
+        Histogram out;
+        out.underflow = h.get_underflow();
+        out.overflow = h.get_overflow();
+        for (size_t i = 0; i < h.get_buckets(); ++i)
+        {
+          const auto count = h.get_count(i);
+          if (count != 0)
+          {
+            const auto [low, high] = h.get_range(i);
+            out.buckets.push_back({low, high, count});
+          }
+        }
+        return out;
+      }
+    };
+
     struct Entry
     {
       std::string path;
@@ -101,6 +135,10 @@ namespace ccf
       size_t errors = 0;
       size_t failures = 0;
       size_t retries = 0;
+      size_t setup_time_us = 0;
+      Histogram execution_time_us = {};
+      Histogram commit_time_us = {};
+      Histogram retries_per_call = {};
     };
 
     struct Out
@@ -17,6 +17,7 @@
 #include "rpc_exception.h"
 
 #define FMT_HEADER_ONLY
+#include <chrono>
 #include <fmt/format.h>
 #include <mutex>
 #include <utility>
@@ -64,6 +65,15 @@ namespace ccf
       endpoints.set_history(history);
     }
 
+    void update_metrics(
+      const std::shared_ptr<enclave::RpcContext>& ctx,
+      const endpoints::EndpointDefinitionPtr& endpoint,
+      size_t attempts)
+    {
+      endpoints.record_metrics_retries_per_call(endpoint, attempts - 1);
+      update_metrics(ctx, endpoint);
+    }
+
     void update_metrics(
       const std::shared_ptr<enclave::RpcContext>& ctx,
       const endpoints::EndpointDefinitionPtr& endpoint)
@@ -290,15 +300,21 @@ namespace ccf
             pre_exec(tx, *ctx.get());
           }
 
+          const auto execution_start = std::chrono::steady_clock::now();
           endpoints.execute_endpoint(endpoint, args);
+          endpoints.record_metrics_execution_time(
+            endpoint,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - execution_start));
 
           if (!ctx->should_apply_writes())
           {
-            update_metrics(ctx, endpoint);
+            update_metrics(ctx, endpoint, attempts);
             return ctx->serialise_response();
           }
 
           kv::CommitResult result;
+          const auto commit_start = std::chrono::steady_clock::now();
           bool track_read_versions =
             (consensus != nullptr && consensus->type() == ConsensusType::BFT);
           if (prescribed_commit_version != kv::NoVersion)
@@ -317,6 +333,10 @@ namespace ccf
           {
             result = tx.commit(track_read_versions);
           }
+          endpoints.record_metrics_commit_time(
+            endpoint,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - commit_start));
 
           switch (result)
           {
@@ -339,7 +359,7 @@ namespace ccf
                 history->try_emit_signature();
               }
 
-              update_metrics(ctx, endpoint);
+              update_metrics(ctx, endpoint, attempts);
               return ctx->serialise_response();
             }
 
@@ -354,7 +374,7 @@ namespace ccf
                 HTTP_STATUS_SERVICE_UNAVAILABLE,
                 ccf::errors::TransactionReplicationFailed,
                 "Transaction failed to replicate.");
-              update_metrics(ctx, endpoint);
+              update_metrics(ctx, endpoint, attempts);
               return ctx->serialise_response();
             }
           }
@@ -370,7 +390,7 @@ namespace ccf
         catch (RpcException& e)
         {
           ctx->set_error(std::move(e.error));
-          update_metrics(ctx, endpoint);
+          update_metrics(ctx, endpoint, attempts);
           return ctx->serialise_response();
         }
         catch (JsonParseError& e)
@@ -379,14 +399,14 @@ namespace ccf
             HTTP_STATUS_BAD_REQUEST,
             ccf::errors::InvalidInput,
             fmt::format("At {}: {}", e.pointer(), e.what()));
-          update_metrics(ctx, endpoint);
+          update_metrics(ctx, endpoint, attempts);
           return ctx->serialise_response();
         }
         catch (const nlohmann::json::exception& e)
         {
           ctx->set_error(
             HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, e.what());
-          update_metrics(ctx, endpoint);
+          update_metrics(ctx, endpoint, attempts);
           return ctx->serialise_response();
         }
         catch (const kv::KvSerialiserException& e)
@@ -404,11 +424,12 @@ namespace ccf
             HTTP_STATUS_INTERNAL_SERVER_ERROR,
             ccf::errors::InternalError,
             e.what());
-          update_metrics(ctx, endpoint);
+          update_metrics(ctx, endpoint, attempts);
           return ctx->serialise_response();
         }
       }
 
+      endpoints.record_metrics_retries_per_call(endpoint, attempts - 1);
       ctx->set_error(
         HTTP_STATUS_SERVICE_UNAVAILABLE,
         ccf::errors::TransactionCommitAttemptsExceedLimit,
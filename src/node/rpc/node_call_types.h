@@ -37,6 +37,9 @@ namespace ccf
       ccf::State state;
       kv::Version last_signed_seqno;
       kv::Version startup_seqno;
+      // Entries up to this seqno have been synced to the node's ledger on
+      // stable storage
+      kv::Version durable_seqno;
 
       // Only on recovery
       std::optional<kv::Version> recovery_target_seqno;
@@ -9,6 +9,7 @@
 #include "ccf/version.h"
 #include "crypto/hash.h"
 #include "frontend.h"
+#include "js/module_cache.h"
 #include "node/entities.h"
 #include "node/network_state.h"
 #include "node/quote.h"
@@ -47,23 +48,35 @@ namespace ccf
   struct NodeMetrics
   {
     ccf::SessionMetrics sessions;
+    ccf::VerifierCacheMetrics verifier_cache;
   };
 
   DECLARE_JSON_TYPE(ccf::SessionMetrics)
   DECLARE_JSON_REQUIRED_FIELDS(
     ccf::SessionMetrics, active, peak, soft_cap, hard_cap)
 
+  DECLARE_JSON_TYPE(ccf::VerifierCacheMetrics)
+  DECLARE_JSON_REQUIRED_FIELDS(
+    ccf::VerifierCacheMetrics, hits, misses, evictions, max_verifiers)
+
   DECLARE_JSON_TYPE(NodeMetrics)
-  DECLARE_JSON_REQUIRED_FIELDS(NodeMetrics, sessions)
+  DECLARE_JSON_REQUIRED_FIELDS(NodeMetrics, sessions, verifier_cache)
 
   struct JavaScriptMetrics
   {
     uint64_t bytecode_size;
     bool bytecode_used;
+    uint64_t module_cache_hits;
+    uint64_t module_cache_misses;
   };
 
   DECLARE_JSON_TYPE(JavaScriptMetrics)
-  DECLARE_JSON_REQUIRED_FIELDS(JavaScriptMetrics, bytecode_size, bytecode_used)
+  DECLARE_JSON_REQUIRED_FIELDS(
+    JavaScriptMetrics,
+    bytecode_size,
+    bytecode_used,
+    module_cache_hits,
+    module_cache_misses)
 
   class NodeEndpoints : public CommonEndpointRegistry
   {
@@ -228,7 +241,7 @@ namespace ccf
       openapi_info.description =
         "This API provides public, uncredentialed access to service and node "
         "state.";
-      openapi_info.document_version = "1.4.0";
+      openapi_info.document_version = "1.9.0";
     }
 
     void init_handlers() override
@@ -450,6 +463,8 @@ namespace ccf
         result.startup_seqno =
           this->context.get_node_state().get_startup_snapshot_seqno().value_or(
             0);
+        result.durable_seqno =
+          this->context.get_node_state().get_ledger_durable_idx();
 
         auto signatures = args.tx.template ro<Signatures>(Tables::SIGNATURES);
         auto sig = signatures->get();
@@ -946,6 +961,7 @@ namespace ccf
       auto node_metrics = [this](auto& args) {
         NodeMetrics nm;
         nm.sessions = context.get_node_state().get_session_metrics();
+        nm.verifier_cache = get_verifier_cache().get_metrics();
 
         args.rpc_ctx->set_response_status(HTTP_STATUS_OK);
         args.rpc_ctx->set_response_header(
@@ -974,6 +990,9 @@ namespace ccf
         m.bytecode_size = bytecode_size;
         m.bytecode_used =
           version_val->get() == std::string(ccf::quickjs_version);
+        const auto module_cache_metrics = js::get_module_cache().get_metrics();
+        m.module_cache_hits = module_cache_metrics.hits;
+        m.module_cache_misses = module_cache_metrics.misses;
         return m;
       };
 
@@ -55,6 +55,7 @@ namespace ccf
       const std::vector<uint8_t>& expected_node_public_key_der,
       CodeDigest& code_digest) = 0;
     virtual std::optional<kv::Version> get_startup_snapshot_seqno() = 0;
+    virtual kv::Version get_ledger_durable_idx() const = 0;
     virtual SessionMetrics get_session_metrics() = 0;
   };
 }
\ No newline at end of file
@@ -21,7 +21,12 @@ namespace ccf
      {ccf::State::verifyingSnapshot, "VerifyingSnapshot"}})
   DECLARE_JSON_TYPE_WITH_OPTIONAL_FIELDS(GetState::Out)
   DECLARE_JSON_REQUIRED_FIELDS(
-    GetState::Out, node_id, state, last_signed_seqno, startup_seqno)
+    GetState::Out,
+    node_id,
+    state,
+    last_signed_seqno,
+    startup_seqno,
+    durable_seqno)
   DECLARE_JSON_OPTIONAL_FIELDS(
     GetState::Out, recovery_target_seqno, last_recovered_seqno)
 
@@ -94,9 +99,24 @@ namespace ccf
   DECLARE_JSON_TYPE(GetNodes::Out)
   DECLARE_JSON_REQUIRED_FIELDS(GetNodes::Out, nodes)
 
+  DECLARE_JSON_TYPE(EndpointMetrics::Bucket)
+  DECLARE_JSON_REQUIRED_FIELDS(EndpointMetrics::Bucket, low, high, count)
+  DECLARE_JSON_TYPE(EndpointMetrics::Histogram)
+  DECLARE_JSON_REQUIRED_FIELDS(
+    EndpointMetrics::Histogram, underflow, overflow, buckets)
   DECLARE_JSON_TYPE(EndpointMetrics::Entry)
   DECLARE_JSON_REQUIRED_FIELDS(
-    EndpointMetrics::Entry, path, method, calls, errors, failures, retries)
+    EndpointMetrics::Entry,
+    path,
+    method,
+    calls,
+    errors,
+    failures,
+    retries,
+    setup_time_us,
+    execution_time_us,
+    commit_time_us,
+    retries_per_call)
   DECLARE_JSON_TYPE(EndpointMetrics::Out)
   DECLARE_JSON_REQUIRED_FIELDS(EndpointMetrics::Out, metrics)
 
@@ -735,6 +735,53 @@ TEST_CASE("process with caller")
   }
 }
 
+TEST_CASE("Cached caller identity")
+{
+  NetworkState network;
+  prepare_callers(network);
+  TestUserFrontend frontend(*network.tables);
+  auto session = make_shared<enclave::SessionContext>(
+    enclave::InvalidSessionId, user_caller_der);
+
+  const auto simple_call = create_simple_request("/empty_function");
+  const auto serialized_simple_call = simple_call.build_request();
+
+  auto process = [&]() {
+    auto rpc_ctx = enclave::make_rpc_context(session, serialized_simple_call);
+    return parse_response(frontend.process(rpc_ctx).value()).status;
+  };
+
+  INFO("Caller identity is cached on the session");
+  {
+    REQUIRE(process() == HTTP_STATUS_OK);
+    REQUIRE(session->caller_cert_digest == user_id.value());
+    REQUIRE(session->user_cert_lookup.has_value());
+    REQUIRE(session->user_cert_lookup->found);
+    REQUIRE(process() == HTTP_STATUS_OK);
+  }
+
+  INFO("Removing the user takes effect on the existing session");
+  {
+    auto tx = network.tables->create_tx();
+    GenesisGenerator g(network, tx);
+    g.remove_user(user_id);
+    REQUIRE(tx.commit() == kv::CommitResult::SUCCESS);
+
+    REQUIRE(process() == HTTP_STATUS_UNAUTHORIZED);
+    REQUIRE(!session->user_cert_lookup->found);
+  }
+
+  INFO("Adding the user back takes effect on the existing session");
+  {
+    auto tx = network.tables->create_tx();
+    GenesisGenerator g(network, tx);
+    g.add_user({user_caller});
+    REQUIRE(tx.commit() == kv::CommitResult::SUCCESS);
+
+    REQUIRE(process() == HTTP_STATUS_OK);
+  }
+}
+
 TEST_CASE("No certs table")
 {
   NetworkState network;
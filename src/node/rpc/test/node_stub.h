@@ -112,6 +112,11 @@ namespace ccf
       return std::nullopt;
     }
 
+    kv::Version get_ledger_durable_idx() const override
+    {
+      return 0;
+    }
+
     SessionMetrics get_session_metrics() override
     {
       return {};
@@ -22,6 +22,11 @@ namespace ccf
   public:
     static constexpr auto max_tx_interval = std::numeric_limits<size_t>::max();
 
+    // Snapshots are serialised and sent to the host in chunks of (roughly) at
+    // most this size. This must be the same on all nodes so that identical
+    // snapshots are split, and so encrypted, identically.
+    static constexpr size_t max_chunk_size = 1 << 20;
+
   private:
     ringbuffer::WriterPtr to_host;
     std::mutex lock;
@@ -31,6 +36,26 @@ namespace ccf
     // Snapshots are never generated by default (e.g. during public recovery)
     size_t snapshot_tx_interval = max_tx_interval;
 
+    // Number of consecutive delta snapshots generated between two full
+    // snapshots. Deltas are never generated by default.
+    size_t max_deltas = 0;
+
+    // Snapshot which later snapshots may be deltas against
+    struct BaseSnapshot
+    {
+      consensus::Index idx;
+      crypto::Sha256Hash hash;
+      std::shared_ptr<kv::AbstractStore::AbstractSnapshot> snapshot;
+
+      // Number of deltas since the last full snapshot, 0 if this snapshot is
+      // a full snapshot
+      size_t deltas;
+    };
+
+    // Latest snapshot whose evidence is committed, which the next snapshot is
+    // a delta against
+    std::shared_ptr<BaseSnapshot> committed_base = nullptr;
+
     struct SnapshotInfo
     {
       consensus::Index idx;
@@ -39,9 +64,17 @@ namespace ccf
       // The evidence isn't committed when the snapshot is generated
       std::optional<consensus::Index> evidence_commit_idx;
 
-      SnapshotInfo(consensus::Index idx, consensus::Index evidence_idx) :
+      // Only set if deltas are generated, and becomes the base of later
+      // snapshots once the evidence is committed
+      std::shared_ptr<BaseSnapshot> base;
+
+      SnapshotInfo(
+        consensus::Index idx,
+        consensus::Index evidence_idx,
+        std::shared_ptr<BaseSnapshot> base = nullptr) :
         idx(idx),
-        evidence_idx(evidence_idx)
+        evidence_idx(evidence_idx),
+        base(std::move(base))
       {}
     };
     std::deque<SnapshotInfo> snapshot_evidence_indices;
@@ -55,13 +88,26 @@ namespace ccf
     // Indices at which a snapshot will be next generated
     std::deque<consensus::Index> next_snapshot_indices;
 
+    void record_snapshot_chunk(
+      consensus::Index idx, bool first, const std::vector<uint8_t>& chunk)
+    {
+      RINGBUFFER_WRITE_MESSAGE(
+        consensus::snapshot_chunk, to_host, idx, first, chunk);
+    }
+
+    void discard_snapshot(consensus::Index idx)
+    {
+      // The host drops the chunks already streamed for this snapshot
+      RINGBUFFER_WRITE_MESSAGE(consensus::snapshot_discard, to_host, idx);
+    }
+
     void record_snapshot(
       consensus::Index idx,
       consensus::Index evidence_idx,
-      const std::vector<uint8_t>& serialised_snapshot)
+      consensus::Index base_idx)
     {
       RINGBUFFER_WRITE_MESSAGE(
-        consensus::snapshot, to_host, idx, evidence_idx, serialised_snapshot);
+        consensus::snapshot, to_host, idx, evidence_idx, base_idx);
     }
 
     void commit_snapshot(
@@ -77,23 +123,51 @@ namespace ccf
     {
       std::shared_ptr<Snapshotter> self;
       std::unique_ptr<kv::AbstractStore::AbstractSnapshot> snapshot;
+      std::shared_ptr<BaseSnapshot> base;
     };
 
     static void snapshot_cb(std::unique_ptr<threading::Tmsg<SnapshotMsg>> msg)
     {
-      msg->data.self->snapshot_(std::move(msg->data.snapshot));
+      msg->data.self->snapshot_(
+        std::move(msg->data.snapshot), std::move(msg->data.base));
     }
 
     void snapshot_(
-      std::unique_ptr<kv::AbstractStore::AbstractSnapshot> snapshot)
+      std::shared_ptr<kv::AbstractStore::AbstractSnapshot> snapshot,
+      std::shared_ptr<BaseSnapshot> base)
     {
       auto snapshot_version = snapshot->get_version();
 
-      auto serialised_snapshot = store->serialise_snapshot(std::move(snapshot));
+      // A delta only contains the maps and entries which changed since its
+      // base, whose hash it records so that joining nodes can check the chain
+      // of snapshots resolved by the host
+      std::unique_ptr<kv::AbstractStore::AbstractSnapshot> delta = nullptr;
+      if (base != nullptr)
+      {
+        delta = snapshot->diff(
+          *base->snapshot, {base->hash.h.begin(), base->hash.h.end()});
+      }
+
+      // Each chunk is hashed and sent to the host as soon as it is serialised.
+      // The host concatenates chunks so the evidence is the hash of the whole
+      // snapshot, as it is read back by joining nodes.
+      // The first chunk tells the host to drop any chunks left over from an
+      // earlier attempt at the same seqno.
+      auto hasher = crypto::make_incremental_sha256();
+      bool first_chunk = true;
+      store->serialise_snapshot(
+        delta != nullptr ? *delta : *snapshot,
+        max_chunk_size,
+        [this, snapshot_version, &hasher, &first_chunk](
+          std::vector<uint8_t>&& chunk) {
+          hasher->update_hash({chunk.data(), chunk.size()});
+          record_snapshot_chunk(snapshot_version, first_chunk, chunk);
+          first_chunk = false;
+        });
+      auto snapshot_hash = hasher->finalise();
 
       auto tx = store->create_tx();
       auto evidence = tx.rw<SnapshotEvidence>(Tables::SNAPSHOT_EVIDENCE);
-      auto snapshot_hash = crypto::Sha256Hash(serialised_snapshot);
       evidence->put(0, {snapshot_hash, snapshot_version});
 
       auto rc = tx.commit();
@@ -103,24 +177,40 @@ namespace ccf
           "Could not commit snapshot evidence for seqno {}: {}",
           snapshot_version,
           rc);
+        discard_snapshot(snapshot_version);
         return;
       }
 
       auto evidence_version = tx.commit_version();
 
-      record_snapshot(snapshot_version, evidence_version, serialised_snapshot);
       consensus::Index snapshot_idx =
         static_cast<consensus::Index>(snapshot_version);
       consensus::Index snapshot_evidence_idx =
         static_cast<consensus::Index>(evidence_version);
-      snapshot_evidence_indices.emplace_back(
-        snapshot_idx, snapshot_evidence_idx);
+      consensus::Index base_idx = base != nullptr ? base->idx : 0;
+      record_snapshot(snapshot_idx, snapshot_evidence_idx, base_idx);
+
+      std::shared_ptr<BaseSnapshot> next_base = nullptr;
+      if (max_deltas > 0)
+      {
+        next_base = std::make_shared<BaseSnapshot>(BaseSnapshot{
+          snapshot_idx,
+          snapshot_hash,
+          std::move(snapshot),
+          base != nullptr ? base->deltas + 1 : 0});
+      }
+
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        snapshot_evidence_indices.emplace_back(
+          snapshot_idx, snapshot_evidence_idx, std::move(next_base));
+      }
 
       LOG_DEBUG_FMT(
-        "Snapshot successfully generated for seqno {}, with evidence seqno "
-        "{}: "
-        "{}",
+        "Snapshot successfully generated for seqno {} (delta against {}), "
+        "with evidence seqno {}: {}",
         snapshot_idx,
+        base_idx,
         snapshot_evidence_idx,
         snapshot_hash);
     }
@@ -141,6 +231,10 @@ namespace ccf
           if (idx > it->evidence_commit_idx.value())
           {
             commit_snapshot(it->idx, idx);
+            if (it->base != nullptr)
+            {
+              committed_base = it->base;
+            }
             auto it_ = it;
             it++;
             snapshot_evidence_indices.erase(it_);
@@ -159,10 +253,12 @@ namespace ccf
     Snapshotter(
       ringbuffer::AbstractWriterFactory& writer_factory,
       std::shared_ptr<kv::Store>& store_,
-      size_t snapshot_tx_interval_) :
+      size_t snapshot_tx_interval_,
+      size_t max_deltas_ = 0) :
       to_host(writer_factory.create_writer_to_outside()),
       store(store_),
-      snapshot_tx_interval(snapshot_tx_interval_)
+      snapshot_tx_interval(snapshot_tx_interval_),
+      max_deltas(max_deltas_)
     {
       next_snapshot_indices.push_back(last_snapshot_idx);
     }
@@ -252,6 +348,11 @@ namespace ccf
             std::make_unique<threading::Tmsg<SnapshotMsg>>(&snapshot_cb);
           msg->data.self = shared_from_this();
           msg->data.snapshot = store->snapshot(snapshot_idx);
+          if (
+            committed_base != nullptr && committed_base->deltas < max_deltas)
+          {
+            msg->data.base = committed_base;
+          }
           static uint32_t generation_count = 0;
           threading::ThreadMessaging::thread_messaging.add_task(
             threading::ThreadMessaging::get_execution_thread(
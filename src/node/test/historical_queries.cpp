@@ -595,6 +595,84 @@ TEST_CASE("StateCache range queries")
   }
 }
 
+TEST_CASE("StateCache contiguous range fetches")
+{
+  auto state = create_and_init_state();
+  auto& kv_store = *state.kv_store;
+
+  const auto begin_seqno = kv_store.current_version() + 1;
+  const auto end_seqno = write_transactions_and_signature(kv_store, 10);
+
+  auto writer = std::make_shared<StubWriter>();
+  ccf::historical::StateCache cache(kv_store, state.ledger_secrets, writer);
+  auto ledger = construct_host_ledger(state.kv_store->get_consensus());
+
+  static const ccf::historical::RequestHandle handle = 0;
+  REQUIRE(cache.get_store_range(handle, begin_seqno, end_seqno).empty());
+
+  {
+    INFO("The host sees a single request for the whole range");
+    REQUIRE(writer->writes.size() == 1);
+    const auto& write = writer->writes.front();
+    REQUIRE(write.m == consensus::ledger_get_range);
+    const uint8_t* data = write.contents.data();
+    size_t size = write.contents.size();
+    auto [from_seqno, to_seqno, purpose] =
+      ringbuffer::read_message<consensus::ledger_get_range>(data, size);
+    REQUIRE(purpose == consensus::LedgerRequestPurpose::HistoricalQuery);
+    REQUIRE(from_seqno == begin_seqno);
+    REQUIRE(to_seqno == end_seqno);
+  }
+
+  {
+    INFO("Requesting the same range again does not re-fetch it");
+    REQUIRE(cache.get_store_range(handle, begin_seqno, end_seqno).empty());
+    REQUIRE(writer->writes.size() == 1);
+  }
+
+  std::vector<uint8_t> framed_entries;
+  for (auto seqno = begin_seqno; seqno <= end_seqno; ++seqno)
+  {
+    const auto& entry = ledger.at(seqno);
+    framed_entries.insert(framed_entries.end(), entry.begin(), entry.end());
+  }
+
+  {
+    INFO("A truncated response drops the requests waiting on it");
+    const std::vector<uint8_t> truncated(
+      framed_entries.begin(), framed_entries.end() - 1);
+    REQUIRE_FALSE(
+      cache.handle_ledger_entries(begin_seqno, end_seqno, truncated));
+    REQUIRE(cache.get_store_range(handle, begin_seqno, end_seqno).empty());
+  }
+
+  {
+    INFO("All entries in a range are handled from a single response");
+    const auto& write = writer->writes.back();
+    REQUIRE(write.m == consensus::ledger_get_range);
+    REQUIRE(
+      cache.handle_ledger_entries(begin_seqno, end_seqno, framed_entries));
+    const auto stores = cache.get_store_range(handle, begin_seqno, end_seqno);
+    REQUIRE(stores.size() == end_seqno - begin_seqno + 1);
+    for (const auto& store : stores)
+    {
+      REQUIRE(store != nullptr);
+    }
+  }
+
+  {
+    INFO("Missing ranges drop the requests waiting on them");
+    const auto other_handle = handle + 1;
+    const auto missing_start = end_seqno + 1;
+    const auto missing_end = end_seqno + 5;
+    REQUIRE(
+      cache.get_store_range(other_handle, missing_start, missing_end).empty());
+    cache.handle_no_entry_range(missing_start, missing_end);
+    REQUIRE_FALSE(
+      cache.handle_ledger_entry(missing_start, ledger.at(end_seqno)));
+  }
+}
+
 TEST_CASE("StateCache concurrent access")
 {
   auto state = create_and_init_state();
@@ -648,6 +726,25 @@ TEST_CASE("StateCache concurrent access")
       {
         auto data = write.contents.data();
         auto size = write.contents.size();
+        if (write.m == consensus::ledger_get_range)
+        {
+          const auto [from_seqno, to_seqno, purpose] =
+            ringbuffer::read_message<consensus::ledger_get_range>(data, size);
+          REQUIRE(purpose == consensus::LedgerRequestPurpose::HistoricalQuery);
+          REQUIRE(from_seqno < to_seqno);
+
+          std::vector<uint8_t> framed_entries;
+          for (auto seqno = from_seqno; seqno <= to_seqno; ++seqno)
+          {
+            const auto it = ledger.find(seqno);
+            REQUIRE(it != ledger.end());
+            framed_entries.insert(
+              framed_entries.end(), it->second.begin(), it->second.end());
+          }
+          cache.handle_ledger_entries(from_seqno, to_seqno, framed_entries);
+          continue;
+        }
+
         const auto [seqno, purpose] =
           ringbuffer::read_message<consensus::ledger_get>(data, size);
         REQUIRE(purpose == consensus::LedgerRequestPurpose::HistoricalQuery);
@@ -26,7 +26,9 @@ auto read_ringbuffer_out(ringbuffer::Circuit& circuit)
     -1, [&idx](ringbuffer::Message m, const uint8_t* data, size_t size) {
       switch (m)
       {
+        case consensus::snapshot_chunk:
         case consensus::snapshot:
+        case consensus::snapshot_discard:
         case consensus::snapshot_commit:
         {
           auto idx_ = serialized::read<consensus::Index>(data, size);
@@ -43,6 +45,26 @@ auto read_ringbuffer_out(ringbuffer::Circuit& circuit)
   return idx;
 }
 
+// Returns the idx of the last snapshot generated and the idx of the snapshot
+// it is a delta against (0 for a full snapshot)
+auto read_snapshot_base_idx(ringbuffer::Circuit& circuit)
+{
+  std::optional<std::pair<consensus::Index, consensus::Index>> idx =
+    std::nullopt;
+  circuit.read_from_inside().read(
+    -1, [&idx](ringbuffer::Message m, const uint8_t* data, size_t size) {
+      if (m == consensus::snapshot)
+      {
+        auto idx_ = serialized::read<consensus::Index>(data, size);
+        serialized::read<consensus::Index>(data, size);
+        auto base_idx = serialized::read<consensus::Index>(data, size);
+        idx = {idx_, base_idx};
+      }
+    });
+
+  return idx;
+}
+
 void issue_transactions(ccf::NetworkState& network, size_t tx_count)
 {
   for (size_t i = 0; i < tx_count; i++)
@@ -256,4 +278,58 @@ TEST_CASE("Rollback before evidence is committed")
       read_ringbuffer_out(eio) ==
       rb_msg({consensus::snapshot_commit, snapshot_idx}));
   }
-}
\ No newline at end of file
+}
+TEST_CASE("Delta snapshots")
+{
+  ccf::NetworkState network;
+
+  auto in_buffer = std::make_unique<ringbuffer::TestBuffer>(buffer_size);
+  auto out_buffer = std::make_unique<ringbuffer::TestBuffer>(buffer_size);
+  ringbuffer::Circuit eio(in_buffer->bd, out_buffer->bd);
+
+  std::unique_ptr<ringbuffer::WriterFactory> writer_factory =
+    std::make_unique<ringbuffer::WriterFactory>(eio);
+
+  size_t snapshot_tx_interval = 10;
+  size_t max_deltas = 1;
+
+  auto snapshotter = std::make_shared<ccf::Snapshotter>(
+    *writer_factory, network.tables, snapshot_tx_interval, max_deltas);
+
+  // Generates a snapshot and commits its evidence, returning the idx of the
+  // snapshot it is a delta against
+  auto snapshot_and_commit = [&]() {
+    issue_transactions(network, snapshot_tx_interval);
+    size_t snapshot_idx = network.tables->current_version();
+
+    snapshotter->record_committable(snapshot_idx);
+    snapshotter->commit(snapshot_idx, true);
+    threading::ThreadMessaging::thread_messaging.run_one();
+    auto snapshot = read_snapshot_base_idx(eio);
+    REQUIRE(snapshot.has_value());
+    REQUIRE(snapshot->first == snapshot_idx);
+
+    snapshotter->commit(snapshot_idx + 1, true);
+    snapshotter->commit(snapshot_idx + 2, true);
+    REQUIRE(
+      read_ringbuffer_out(eio) ==
+      rb_msg({consensus::snapshot_commit, snapshot_idx}));
+
+    return std::make_pair(snapshot_idx, snapshot->second);
+  };
+
+  INFO("First snapshot is a full snapshot");
+  auto first = snapshot_and_commit();
+  REQUIRE(first.second == 0);
+
+  INFO("Next snapshot is a delta against the last committed snapshot");
+  auto second = snapshot_and_commit();
+  REQUIRE(second.second == first.first);
+
+  INFO("A full snapshot is generated after max_deltas deltas");
+  auto third = snapshot_and_commit();
+  REQUIRE(third.second == 0);
+
+  auto fourth = snapshot_and_commit();
+  REQUIRE(fourth.second == third.first);
+}
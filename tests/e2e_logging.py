@@ -440,6 +440,33 @@ def test_multi_auth(network, args):
                 r = c.get("/app/multi_auth", headers={"authorization": "Bearer " + jwt})
                 require_new_response(r)
 
+                LOG.info("Authenticate again with the same, cached, JWT token")
+                r = c.get("/app/multi_auth", headers={"authorization": "Bearer " + jwt})
+                assert r.status_code == http.HTTPStatus.OK.value, r.status_code
+
+            LOG.info("Replace JWT signing key with the same kid")
+            new_jwt_key_priv_pem, _ = infra.crypto.generate_rsa_keypair(2048)
+            new_jwt_cert_pem = infra.crypto.generate_cert(new_jwt_key_priv_pem)
+            with tempfile.NamedTemporaryFile(prefix="ccf", mode="w+") as metadata_fp:
+                new_jwt_cert_der = infra.crypto.cert_pem_to_der(new_jwt_cert_pem)
+                der_b64 = base64.b64encode(new_jwt_cert_der).decode("ascii")
+                data = {
+                    "issuer": jwt_issuer,
+                    "jwks": {
+                        "keys": [{"kty": "RSA", "kid": jwt_kid, "x5c": [der_b64]}]
+                    },
+                }
+                json.dump(data, metadata_fp)
+                metadata_fp.flush()
+                network.consortium.set_jwt_issuer(primary, metadata_fp.name)
+
+            with primary.client() as c:
+                LOG.info("Token signed with the replaced key is refused")
+                r = c.get("/app/multi_auth", headers={"authorization": "Bearer " + jwt})
+                assert (
+                    r.status_code == http.HTTPStatus.UNAUTHORIZED.value
+                ), r.status_code
+
         else:
             LOG.warning(
                 f"Skipping {inspect.currentframe().f_code.co_name} as application does not implement '/multi_auth'"
@@ -598,7 +625,46 @@ def test_metrics(network, args):
 
     with primary.client("user0") as c:
         r = c.get("/app/api/metrics")
-        assert get_metrics(r, "log/public", "POST")["calls"] == calls + 1
+        m = get_metrics(r, "log/public", "POST")
+        assert m["calls"] == calls + 1
+
+        def histogram_count(h):
+            return (
+                h["underflow"] + h["overflow"] + sum(b["count"] for b in h["buckets"])
+            )
+
+        assert histogram_count(m["execution_time_us"]) >= 1
+        assert histogram_count(m["commit_time_us"]) >= 1
+        assert histogram_count(m["retries_per_call"]) >= 1
+
+    return network
+
+
+@reqs.description("Read signature verifier cache metrics")
+@reqs.supports_methods("multi_auth")
+def test_verifier_cache_metrics(network, args):
+    primary, _ = network.find_primary()
+    user = network.users[0]
+
+    def get_verifier_cache_metrics():
+        with primary.client() as c:
+            r = c.get("/node/metrics")
+            assert r.status_code == http.HTTPStatus.OK, r
+            return r.body.json()["verifier_cache"]
+
+    before = get_verifier_cache_metrics()
+    assert before["max_verifiers"] == int(args.max_cached_verifiers or 256), before
+
+    with primary.client(None, user.local_id) as c:
+        for _ in range(3):
+            r = c.get("/app/multi_auth")
+            assert r.status_code == http.HTTPStatus.OK, r
+
+    after = get_verifier_cache_metrics()
+    LOG.info(f"Verifier cache metrics: {after}")
+    # The signer's verifier is cached by the first request at the latest
+    assert after["hits"] >= before["hits"] + 2, (before, after)
+    assert after["misses"] <= before["misses"] + 1, (before, after)
 
     return network
 
@@ -1252,6 +1318,7 @@ def run(args):
         network = test_primary(network, args)
         network = test_network_node_info(network, args)
         network = test_metrics(network, args)
+        network = test_verifier_cache_metrics(network, args)
         network = test_memory(network, args)
         # BFT does not handle re-keying yet
         if args.consensus == "cft":
@@ -1273,4 +1340,5 @@ if __name__ == "__main__":
     args.nodes = infra.e2e_args.max_nodes(args, f=0)
     args.initial_user_count = 4
     args.initial_member_count = 2
+    args.max_cached_verifiers = 64
     run(args)
@@ -265,6 +265,11 @@ def cli_args(add=lambda x: None, parser=None, accept_unknown=False):
         help="Hard cap on max open TLS sessions on each node",
         default=None,
     )
+    parser.add_argument(
+        "--max-cached-verifiers",
+        help="Maximum number of cached request signer verifiers on each node",
+        default=None,
+    )
     parser.add_argument(
         "--jwt-key-refresh-interval-s",
         help="JWT key refresh interval in seconds",
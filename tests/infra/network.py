@@ -97,6 +97,7 @@ class Network:
         "snapshot_tx_interval",
         "max_open_sessions",
         "max_open_sessions_hard",
+        "max_cached_verifiers",
         "jwt_key_refresh_interval_s",
         "common_read_only_ledger_dir",
         "curve_id",
@@ -580,6 +580,7 @@ class CCFRemote(object):
         snapshot_tx_interval=None,
         max_open_sessions=None,
         max_open_sessions_hard=None,
+        max_cached_verifiers=None,
         jwt_key_refresh_interval_s=None,
         curve_id=None,
         client_connection_timeout_ms=None,
@@ -686,6 +687,9 @@ class CCFRemote(object):
         if max_open_sessions_hard:
             cmd += [f"--max-open-sessions-hard={max_open_sessions_hard}"]
 
+        if max_cached_verifiers:
+            cmd += [f"--max-cached-verifiers={max_cached_verifiers}"]
+
         if jwt_key_refresh_interval_s:
             cmd += [f"--jwt-key-refresh-interval-s={jwt_key_refresh_interval_s}"]
 
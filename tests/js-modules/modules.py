@@ -430,6 +430,46 @@ def test_npm_app(network, args):
         assert {"id": 42, "msg": "Saluton!"} in body, body
         assert {"id": 43, "msg": "Bonjour!"} in body, body
 
+        LOG.info("Read log in chunks with the native forEachChunk")
+        for i in range(44, 47):
+            r = c.post(f"/app/log?id={i}", {"msg": f"Entry {i}"})
+            assert r.status_code == http.HTTPStatus.OK, r.status_code
+
+        r = c.get("/app/log/all")
+        assert r.status_code == http.HTTPStatus.OK, r.status_code
+        all_items = r.body.json()
+        assert len(all_items) == 5, all_items
+
+        for query, chunk_sizes in [
+            ("", [5]),
+            ("chunk_size=1", [1] * 5),
+            ("chunk_size=2", [2, 2, 1]),
+            ("chunk_size=5", [5]),
+            ("chunk_size=6", [5]),
+        ]:
+            r = c.get(f"/app/log/all/chunks?{query}")
+            assert r.status_code == http.HTTPStatus.OK, r.status_code
+            body = r.body.json()
+            assert body["chunk_sizes"] == chunk_sizes, (query, body)
+            assert sorted(body["items"], key=lambda e: e["id"]) == sorted(
+                all_items, key=lambda e: e["id"]
+            ), (query, body)
+
+        # A throwing callback stops the iteration, and its error reaches the
+        # caller of forEachChunk
+        r = c.get("/app/log/all/chunks?chunk_size=2&throw_after=1")
+        assert r.status_code == http.HTTPStatus.BAD_REQUEST, r.status_code
+        body = r.body.json()
+        assert body["chunk_sizes"] == [2], body
+        assert body["error"] == "Error: Stopped after 1 chunks", body
+
+        for chunk_size in ["0", "-1", "foo"]:
+            r = c.get(f"/app/log/all/chunks?chunk_size={chunk_size}")
+            assert r.status_code == http.HTTPStatus.BAD_REQUEST, r.status_code
+            body = r.body.json()
+            assert body["chunk_sizes"] == [], body
+            assert body["error"].startswith("RangeError"), body
+
         r = c.post("/app/rpc/apply_writes")
         assert r.status_code == http.HTTPStatus.BAD_REQUEST, r.status_code
         val = network.get_ledger_public_state_at(r.seqno)["public:apply_writes"][
@@ -3,11 +3,13 @@
 import tempfile
 import os
 import shutil
+import time
 
 import infra.logging_app as app
 import infra.e2e_args
 import infra.network
 import ccf.ledger
+from ccf.tx_id import TxID
 import suite.test_requirements as reqs
 
 
@@ -42,9 +44,34 @@ def test_parse_snapshot_file(network, args):
     committed_snapshots_dir = network.get_committed_snapshots(primary)
     for snapshot in os.listdir(committed_snapshots_dir):
         with ccf.ledger.Snapshot(os.path.join(committed_snapshots_dir, snapshot)) as s:
-            assert len(
-                s.get_public_domain().get_tables()
-            ), "No public table in snapshot"
+            assert s.get_chunk_count() > 0, "No chunk in snapshot"
+            tables = s.get_public_domain().get_tables()
+            assert len(tables), "No public table in snapshot"
+            # Public maps from all chunks are merged
+            assert (
+                ccf.ledger.NODES_TABLE_NAME in tables
+            ), f"No {ccf.ledger.NODES_TABLE_NAME} table in snapshot"
+    return network
+
+
+@reqs.description("Committed entries are reported as durable")
+def test_durable_seqno(network, args, timeout=3):
+    network.txs.issue(network, number_txs=3)
+    for node in network.get_joined_nodes():
+        with node.client() as c:
+            r = c.get("/node/commit")
+            seqno = TxID.from_str(r.body.json()["transaction_id"]).seqno
+            end_time = time.time() + timeout
+            while True:
+                r = c.get("/node/state")
+                durable_seqno = r.body.json()["durable_seqno"]
+                if durable_seqno >= seqno:
+                    break
+                if time.time() > end_time:
+                    raise TimeoutError(
+                        f"Node {node.local_node_id} durable seqno {durable_seqno} did not reach committed seqno {seqno}"
+                    )
+                time.sleep(0.1)
     return network
 
 
@@ -65,6 +92,7 @@ def run(args):
 
             test_save_committed_ledger_files(network, args)
             test_parse_snapshot_file(network, args)
+            test_durable_seqno(network, args)
 
 
 if __name__ == "__main__":
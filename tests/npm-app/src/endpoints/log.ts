@@ -8,6 +8,12 @@ interface LogEntry extends LogItem {
   id: number;
 }
 
+interface LogChunks {
+  chunk_sizes: number[];
+  items: Array<LogEntry>;
+  error?: string;
+}
+
 const logMap = ccfapp.typedKv("log", ccfapp.uint32, ccfapp.json<LogItem>());
 
 export function getLogItem(request: ccfapp.Request): ccfapp.Response<LogItem> {
@@ -39,3 +45,37 @@ export function getAllLogItems(
     body: items,
   };
 }
+
+// Reads the log in chunks of chunk_size entries, throwing from the callback
+// once throw_after chunks have been read, and returns the size of each chunk
+export function getAllLogItemsInChunks(
+  request: ccfapp.Request
+): ccfapp.Response<LogChunks> {
+  const query = Object.fromEntries(
+    request.query.split("&").map((p) => p.split("="))
+  );
+  const chunkSize =
+    query.chunk_size === undefined ? undefined : Number(query.chunk_size);
+  const throwAfter =
+    query.throw_after === undefined ? undefined : parseInt(query.throw_after);
+
+  const chunks: LogChunks = { chunk_sizes: [], items: [] };
+  try {
+    logMap.forEachChunk(function (items, ids) {
+      if (chunks.chunk_sizes.length === throwAfter) {
+        throw new Error(`Stopped after ${throwAfter} chunks`);
+      }
+      chunks.chunk_sizes.push(ids.length);
+      ids.forEach((id, i) => chunks.items.push({ id: id, msg: items[i].msg }));
+    }, chunkSize);
+  } catch (e) {
+    chunks.error = `${e.name}: ${e.message}`;
+    return {
+      statusCode: 400,
+      body: chunks,
+    };
+  }
+  return {
+    body: chunks,
+  };
+}